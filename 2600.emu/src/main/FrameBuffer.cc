@@ -87,6 +87,6 @@ void FrameBuffer::render(IG::Pixmap pix, TIA &tia)
 	}
 	else
 	{
-		pix.writeTransformed([this](uint8 p){ return tiaColorMap[p]; }, framePix);
+		pix.writePaletted(framePix, tiaColorMap);
 	}
 }
@@ -44,6 +44,7 @@ bool p1DiffB = true, p2DiffB = true, vcsColor = true;
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2014\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nStella Team\nstella.sourceforge.net";
 bool EmuSystem::hasPALVideoSystem = true;
 bool EmuSystem::hasResetModes = true;
+bool EmuSystem::hasMemoryStates = true;
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter =
 	[](const char *name)
 	{
@@ -206,6 +207,38 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 	return {};
 }
 
+// in-memory stream reused by every memory state call, only
+// the bytes up to the last write position are valid
+static Serializer memState{};
+
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	memState.reset();
+	if(!stateManager.saveState(memState))
+	{
+		return makeError("Error saving state");
+	}
+	auto size = memState.writePosition();
+	if(!buff.resize(size))
+		return makeError("Out of memory");
+	memState.reset();
+	memState.getByteArray(buff.data(), size);
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	memState.reset();
+	memState.putByteArray(buff.data(), buff.size());
+	memState.reset();
+	if(!stateManager.loadState(memState))
+	{
+		return makeError("Error loading state");
+	}
+	updateSwitchValues();
+	return {};
+}
+
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 {
 	const Gfx::LGradientStopDesc navViewGrad[] =
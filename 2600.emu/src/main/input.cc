@@ -140,48 +140,73 @@ uint EmuSystem::translateInputAction(uint input, bool &turbo)
 	return 0;
 }
 
-void EmuSystem::handleInputAction(uint state, uint emuKey)
+// toggles a console switch & queues its new position, pushed for the
+// switch's first event
+static void toggleSwitch(bool &on, const char *onMsg, const char *offMsg, uint &state)
 {
-	auto &ev = osystem.eventHandler().event();
-	uint event1 = emuKey & 0xFF;
-
-	//logMsg("got key %d", emuKey);
+	on ^= true;
+	EmuApp::postMessage(1, false, on ? onMsg : offMsg);
+	state = on ? Input::PUSHED : Input::RELEASED;
+}
 
-	switch(event1)
+bool EmuSystem::handleUIInputAction(uint &state, uint &emuKey)
+{
+	switch(emuKey & 0xFF)
 	{
-		bcase Event::Combo1:
+		case Event::Combo1:
 			if(state != Input::PUSHED)
-				break;
-			p1DiffB ^= true;
-			EmuApp::postMessage(1, false, p1DiffB ? "P1 Difficulty -> B" : "P1 Difficulty -> A");
-			ev.set(Event::ConsoleLeftDiffB, p1DiffB);
-			ev.set(Event::ConsoleLeftDiffA, !p1DiffB);
-		bcase Event::Combo2:
+				return true;
+			toggleSwitch(p1DiffB, "P1 Difficulty -> B", "P1 Difficulty -> A", state);
+			return false;
+		case Event::Combo2:
 			if(state != Input::PUSHED)
-				break;
-			p2DiffB ^= true;
-			EmuApp::postMessage(1, false, p2DiffB ? "P2 Difficulty -> B" : "P2 Difficulty -> A");
-			ev.set(Event::ConsoleRightDiffB, p2DiffB);
-			ev.set(Event::ConsoleRightDiffA, !p2DiffB);
-		bcase Event::Combo3:
+				return true;
+			toggleSwitch(p2DiffB, "P2 Difficulty -> B", "P2 Difficulty -> A", state);
+			return false;
+		case Event::Combo3:
 			if(state != Input::PUSHED)
-				break;
-			vcsColor ^= true;
-			EmuApp::postMessage(1, false, vcsColor ? "Color Switch -> Color" : "Color Switch -> B&W");
-			ev.set(Event::ConsoleColor, vcsColor);
-			ev.set(Event::ConsoleBlackWhite, !vcsColor);
-		bcase Event::JoystickZeroFire5: // TODO: add turbo support for on-screen controls to framework
-			ev.set(Event::Type(Event::JoystickZeroFire), state == Input::PUSHED);
+				return true;
+			toggleSwitch(vcsColor, "Color Switch -> Color", "Color Switch -> B&W", state);
+			return false;
+		case Event::JoystickZeroFire5: // TODO: add turbo support for on-screen controls to framework
 			if(state == Input::PUSHED)
 				turboActions.addEvent(Event::JoystickZeroFire);
 			else
 				turboActions.removeEvent(Event::JoystickZeroFire);
-		bcase Event::JoystickOneFire5: // TODO: add turbo support for on-screen controls to framework
-			ev.set(Event::Type(Event::JoystickOneFire), state == Input::PUSHED);
+			return false;
+		case Event::JoystickOneFire5:
 			if(state == Input::PUSHED)
 				turboActions.addEvent(Event::JoystickOneFire);
 			else
 				turboActions.removeEvent(Event::JoystickOneFire);
+			return false;
+	}
+	return false;
+}
+
+void EmuSystem::handleInputAction(uint state, uint emuKey)
+{
+	auto &ev = osystem.eventHandler().event();
+	uint event1 = emuKey & 0xFF;
+
+	//logMsg("got key %d", emuKey);
+
+	switch(event1)
+	{
+		// switch toggles are queued with the new position as the state
+		bcase Event::Combo1:
+			ev.set(Event::ConsoleLeftDiffB, state == Input::PUSHED);
+			ev.set(Event::ConsoleLeftDiffA, state != Input::PUSHED);
+		bcase Event::Combo2:
+			ev.set(Event::ConsoleRightDiffB, state == Input::PUSHED);
+			ev.set(Event::ConsoleRightDiffA, state != Input::PUSHED);
+		bcase Event::Combo3:
+			ev.set(Event::ConsoleColor, state == Input::PUSHED);
+			ev.set(Event::ConsoleBlackWhite, state != Input::PUSHED);
+		bcase Event::JoystickZeroFire5:
+			ev.set(Event::Type(Event::JoystickZeroFire), state == Input::PUSHED);
+		bcase Event::JoystickOneFire5:
+			ev.set(Event::Type(Event::JoystickOneFire), state == Input::PUSHED);
 		bcase Event::KeyboardZero1 ... Event::KeyboardOnePound:
 			ev.set(Event::Type(event1), state == Input::PUSHED);
 		bdefault:
@@ -90,6 +90,12 @@ void Serializer::reset()
   myStream->seekp(ios_base::beg);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Serializer::writePosition() const
+{
+  return uInt32(myStream->tellp());
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Serializer::getByte() const
 {
@@ -68,6 +68,12 @@ class Serializer
     */
     void reset();
 
+    /**
+      Answers the current write location, which after writing to a freshly
+      reset stream is the number of bytes written.
+    */
+    uInt32 writePosition() const;
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
@@ -437,6 +437,58 @@ static void setC64KBKey(int key, bool pushed)
 	}
 }
 
+bool EmuSystem::handleUIInputAction(uint &state, uint &emuKey)
+{
+	if(emuKey & 0xFF0000) // Joystick
+	{
+		// apply the port swap here so the option is only read on this thread
+		if(optionSwapJoystickPorts)
+			emuKey ^= IG::bit(5) << 16;
+		return false;
+	}
+	switch(emuKey)
+	{
+		case KBEX_SWAP_JS_PORTS:
+		{
+			if(state == Input::PUSHED)
+			{
+				if(optionSwapJoystickPorts)
+					optionSwapJoystickPorts = 0;
+				else
+					optionSwapJoystickPorts = 1;
+				EmuApp::postMessage(1, false, "Swapped Joystick Ports");
+			}
+			return true;
+		}
+		case KBEX_TOGGLE_VKEYBOARD:
+		{
+			if(state == Input::PUSHED)
+				EmuControls::toggleKeyboard();
+			return true;
+		}
+		case KBEX_SHIFT_LOCK:
+		{
+			if(state == Input::PUSHED)
+			{
+				shiftLock ^= true;
+				EmuControls::updateKeyboardMapping();
+			}
+			return true;
+		}
+		case KBEX_CTRL_LOCK:
+		{
+			if(state != Input::PUSHED)
+				return true;
+			// queue the lock as a press or release of the control key
+			ctrlLock ^= true;
+			state = ctrlLock ? Input::PUSHED : Input::RELEASED;
+			emuKey = KB_CTRL;
+			return false;
+		}
+	}
+	return false;
+}
+
 void EmuSystem::handleInputAction(uint state, uint emuKey)
 {
 	auto &joystick_value = *plugin.joystick_value;
@@ -445,55 +497,12 @@ void EmuSystem::handleInputAction(uint state, uint emuKey)
 
 		uint key = emuKey >> 16;
 		uint player = (key & IG::bit(5)) ? 2 : 1;
-		if(optionSwapJoystickPorts)
-		{
-			player = (player == 1) ? 2 : 1;
-		}
 		//logMsg("js %X p %d", key & 0x1F, player);
 		joystick_value[player] = IG::setOrClearBits(joystick_value[player], (BYTE)(key & 0x1F), state == Input::PUSHED);
 	}
 	else // Keyboard
 	{
-		// Special Keys
-		switch(emuKey)
-		{
-			case KBEX_SWAP_JS_PORTS:
-			{
-				if(state == Input::PUSHED)
-				{
-					if(optionSwapJoystickPorts)
-						optionSwapJoystickPorts = 0;
-					else
-						optionSwapJoystickPorts = 1;
-					EmuApp::postMessage(1, false, "Swapped Joystick Ports");
-				}
-				return;
-			}
-			case KBEX_TOGGLE_VKEYBOARD:
-			{
-				if(state == Input::PUSHED)
-					EmuControls::toggleKeyboard();
-				return;
-			}
-			case KBEX_SHIFT_LOCK:
-			{
-				if(state == Input::PUSHED)
-				{
-					shiftLock ^= true;
-					EmuControls::updateKeyboardMapping();
-				}
-				return;
-			}
-			case KBEX_CTRL_LOCK:
-			{
-				if(state == Input::PUSHED)
-				{
-					ctrlLock ^= true;
-					setC64KBKey(KB_CTRL, ctrlLock);
-				}
-				return;
-			}
-		}
+		assert(emuKey < KBEX_SWAP_JS_PORTS); // special functions are handled in handleUIInputAction()
 		if(unlikely((emuKey & 0xFF) == KB_NONE))
 		{
 			return;
@@ -21,6 +21,16 @@ ConfigFile.cc \
 InputManagerView.cc \
 FileUtils.cc \
 EmuApp.cc \
+EmuThread.cc \
+EmuRewind.cc \
+EmuRunAhead.cc \
+EmuInputQueue.cc \
+EmuInputMovie.cc \
+EmuFramePacer.cc \
+EmuLibrary.cc \
+EmuArchiveCache.cc \
+EmuAudioRateControl.cc \
+FrameTimeGraph.cc \
 BundledGamesView.cc \
 VideoImageEffect.cc \
 EmuVideo.cc \
@@ -31,6 +41,10 @@ Recent.cc \
 EmuLoadProgressView.cc \
 RecentGameView.cc
 
+ifeq ($(ENV), linux)
+ SRC += EmuBenchRunner.cc
+endif
+
 ifeq ($(emuFramework_onScreenControls), 1)
  SRC += TouchConfigView.cc \
  VController.cc
@@ -56,6 +70,7 @@ pkgVersion := $(metadata_version)
 LDLIBS := -l$(libName) $(LDLIBS)
 
 include $(IMAGINE_PATH)/make/package/imagine.mk
+include $(IMAGINE_PATH)/make/package/zlib.mk
 include $(IMAGINE_PATH)/make/package/stdc++.mk
 
 include $(IMAGINE_PATH)/make/imagineStaticLibTarget.mk
@@ -0,0 +1,47 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/io/ArchiveIO.hh>
+#include <imagine/fs/FS.hh>
+
+// On-disk cache of files extracted from archives. Entries are named by a hash
+// of the member's name, size & CRC32 from the archive's directory, so the
+// same game in a different archive or location is still a hit. A hit is
+// opened with FileIO, which memory maps it, instead of decompressing the
+// archive again. The least recently used entries are deleted to stay under
+// the size limit.
+
+class EmuArchiveCache
+{
+public:
+	EmuArchiveCache() {}
+	// maximum total size of cached files in bytes, 0 disables the cache
+	void setMaxSize(uint64_t bytes);
+	bool isEnabled() const { return maxSize; }
+	// returns the cached copy of the archive member io is reading, extracting it
+	// first if needed, or an unopened FileIO if the member can't be cached.
+	// On a cache miss io is consumed even if extraction fails.
+	FileIO open(ArchiveIO &io, const char *archivePath, uint32 crc32, const char *memberName, std::error_code &ec);
+
+private:
+	uint64_t maxSize = 0;
+
+	FS::PathString entryPath(const char *archivePath, uint32 crc32, const char *memberName, uint64_t size) const;
+	void evict(const char *keepPath);
+};
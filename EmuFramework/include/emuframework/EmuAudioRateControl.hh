@@ -0,0 +1,52 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/util/audio/PolyphaseResampler.hh>
+#include <vector>
+
+// Dynamic rate control: resamples s16 audio by a ratio within a fraction
+// of a percent of 1 so the output buffer drifts towards being half full,
+// absorbing small mismatches between the emulated & host frame rates.
+// The ratio is applied with Audio::PolyphaseResampler's setRate() so it
+// can change every call without rebuilding the filter.
+
+class EmuAudioRateControl
+{
+public:
+	static constexpr double maxRatioDelta = 0.005;
+	static constexpr uint maxChannels = Audio::PolyphaseResampler::maxChannels;
+
+	EmuAudioRateControl() {}
+	// forget the buffer level & sample history, call when the output restarts
+	void reset();
+	// resample frames given the output buffer's current free space,
+	// returns a pointer to the converted samples valid until the next call
+	const int16 *resample(const int16 *samples, uint frames, uint channels,
+		int framesFree, uint &framesOut);
+	double ratio() const { return ratio_; }
+
+private:
+	Audio::PolyphaseResampler resampler{};
+	std::vector<int16> output{};
+	double ratio_ = 1.;
+	double avgFreeFraction = .5;
+	uint bufferFrames = 0;
+	uint channels = 0;
+
+	void updateRatio(int framesFree);
+};
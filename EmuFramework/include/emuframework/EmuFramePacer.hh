@@ -0,0 +1,64 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/base/baseDefs.hh>
+#include <atomic>
+
+// Schedules emulated frames against the host's vblanks. The vblank interval
+// is estimated from frame timestamps with a low-pass filter so timer jitter
+// doesn't turn into uneven frame counts, and when audio rate control is on
+// & the display rate is within its range of a multiple or fraction of the
+// emulated rate the schedule locks to it so every vblank gets the same
+// number of frames. The number of late frames that may be skipped comes from the
+// measured cost of running a frame.
+
+class EmuFramePacer
+{
+public:
+	static constexpr uint maxFrameSkipLimit = 6;
+
+	EmuFramePacer() {}
+	// emulated frame duration in seconds, also resets the schedule
+	void setFrameTime(double secs);
+	// forget the previous timestamp & pending time, call when frames stop being delivered
+	void reset();
+	// returns how many emulated frames are due at the vblank with this timestamp,
+	// nominalVBlankSecs is the screen's reported frame time used to seed the estimate
+	uint update(Base::FrameTimeBase timestamp, double nominalVBlankSecs);
+	// how many frames can be skipped to catch up without exceeding a vblank's time budget
+	uint maxFrameSkip() const;
+	// record the time taken to run frames, may be called from the emulation thread
+	void addFrameCost(IG::Time time, uint frames);
+	double vblankTime() const { return vblankSecs; }
+	bool isLocked() const { return lockedVBlankFrames; }
+
+private:
+	double frameSecs = 0;
+	double vblankSecs = 0;
+	double pendingFrames = 0;
+	double lockedVBlankFrames = 0;
+	double outlierSecs = 0;
+	Base::FrameTimeBase lastTimestamp{};
+	uint vblankSamples = 0;
+	uint outlierSamples = 0;
+	std::atomic<uint64_t> frameCostNSecs{};
+
+	void updateVBlankEstimate(double intervalSecs);
+	void updateLock();
+};
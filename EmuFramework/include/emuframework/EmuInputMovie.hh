@@ -0,0 +1,85 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/util/ByteBuffer.hh>
+#include <emuframework/EmuSystem.hh>
+#include <vector>
+#include <atomic>
+
+// Records the input actions applied to the emulated system on each frame
+// so they can be replayed exactly, starting from a hard reset or a state
+// captured in memory. Movies only depend on EmuSystem::handleInputAction()
+// so they work with any core. Input is logged & replayed at the start of
+// each frame, so late input polling is off while a movie is active, and
+// user input is ignored during playback.
+
+class EmuInputMovie
+{
+public:
+	enum class Start : uint8 { POWER_ON, STATE };
+
+	EmuInputMovie() {}
+	// start logging input, the movie is written to path when stopped,
+	// only queued actions are logged so pointer devices handled directly
+	// by the core, like light guns, aren't recorded
+	EmuSystem::Error startRecording(const char *path, Start start);
+	// restore a movie's start point & replay its input, stopping at its end
+	EmuSystem::Error startPlayback(const char *path);
+	// end recording or playback, writing out a recorded movie
+	EmuSystem::Error stop();
+	bool isRecording() const { return mode == Mode::RECORD; }
+	bool isPlaying() const { return mode == Mode::PLAY; }
+	bool isActive() const { return mode != Mode::OFF; }
+	// frames recorded so far, or the length of the movie being played
+	uint frames() const { return isPlaying() ? totalFrames : frame; }
+	// log an action applied before the next frame while recording
+	void logAction(uint state, uint emuKey);
+	// warn once per recording about input the movie can't log
+	void warnUnloggedInput();
+	// called before running each frame, applies its input while playing
+	void nextFrame();
+
+private:
+	enum class Mode : uint8 { OFF, RECORD, PLAY };
+
+	struct Action
+	{
+		uint emuKey;
+		uint state;
+	};
+
+	IG::ByteBuffer startState{};
+	std::vector<uint8> events{};
+	std::vector<Action> frameActions{};
+	std::vector<uint> heldKeys{};
+	FS::PathString path{};
+	size_t readPos = 0;
+	uint frame = 0;
+	uint totalFrames = 0;
+	uint lastEventFrame = 0;
+	uint nextEventFrame = 0;
+	Start start = Start::POWER_ON;
+	std::atomic<Mode> mode{Mode::OFF};
+	bool unloggedInputWarned = false;
+
+	EmuSystem::Error restoreStart();
+	EmuSystem::Error write();
+	bool readNextEventFrame();
+	void endPlayback();
+};
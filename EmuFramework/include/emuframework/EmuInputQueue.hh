@@ -0,0 +1,63 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/input/Input.hh>
+#include <imagine/util/ringbuffer/RingBuffer.hh>
+
+// Holds emulated input actions from the main thread until the emulated
+// system reads them. Everything queued is applied with
+// EmuSystem::handleInputAction() at the start of each frame, and cores can
+// also poll from their controller read handlers through
+// EmuSystem::pollInput() to pick up input that arrived mid-frame, which
+// matters when frames run on the emulation thread. Events keep their
+// device timestamps, which are in the input system's time base so they're
+// only comparable with each other. While an EmuInputMovie is recording,
+// applied events are logged to it, & they're dropped during playback.
+
+class EmuInputQueue
+{
+public:
+	static constexpr uint capacity = 128;
+
+	struct Event
+	{
+		Input::Time time;
+		uint emuKey;
+		uint state;
+	};
+
+	EmuInputQueue();
+	// called from the main thread, returns false if the queue is full
+	bool push(uint state, uint emuKey, Input::Time time);
+	// apply all queued events in order, called from the thread running frames
+	void poll();
+	// poll & advance any active input movie, called before running each frame
+	void startFrame();
+	// discard all queued events, only call when no frames are running
+	void clear();
+	// when disabled, EmuSystem::pollInput() leaves events for the next frame
+	void setLatePolling(bool on) { latePolling = on; }
+	bool latePollingEnabled() const { return latePolling; }
+	// device timestamp of the newest applied event that had one
+	Input::Time lastEventTime() const { return lastEventTime_; }
+
+private:
+	StaticRingBuffer<> events{};
+	Input::Time lastEventTime_{};
+	bool latePolling = true;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <optional>
+#include <mutex>
+
+// Index of game files keyed by path holding each file's size, detected
+// system, region & title so they don't need to be re-read. Entries are
+// checked against the file's size & modification time and built on a
+// background thread that only reads file headers. The CRC32 is recorded
+// when it's free, from an archive's own entry or from hashing the game's
+// data after loading it, since hashing every file in a directory costs far
+// more than the lookups it would save.
+
+struct EmuLibraryEntry
+{
+	enum class Region : uint8
+	{
+		UNKNOWN, USA, EUROPE, JAPAN, WORLD, OTHER
+	};
+
+	uint64_t size = 0;
+	int64_t mtime = 0;
+	uint32 crc32 = 0; // 0 if unknown
+	Region region = Region::UNKNOWN;
+	// from the game's header when the core runs more than one system,
+	// otherwise EmuSystem::systemName()
+	std::string system{};
+	// from the game's header when the system reads one, otherwise the file name
+	std::string title{};
+	// name of the game file when the path is an archive
+	std::string archiveMember{};
+};
+
+class EmuLibrary
+{
+public:
+	EmuLibrary() {}
+	void load();
+	void save();
+	// returns the entry for a path if it's indexed & the file hasn't changed
+	std::optional<EmuLibraryEntry> entry(const char *path);
+	// queue a game file or all recognized games in a directory for indexing,
+	// a non-zero crc32 of the file's game data is stored with its entry
+	void addFile(const char *path, uint32 crc32 = 0);
+	void addDirectory(const char *path);
+	static EmuLibraryEntry::Region regionFromName(const char *name);
+	// title from a fixed size header field, padded with NULs or spaces,
+	// empty if it holds anything besides printable ASCII
+	static std::string titleFromHeader(const char *field, size_t size);
+	static const char *regionName(EmuLibraryEntry::Region region);
+
+private:
+	std::mutex mutex{};
+	std::unordered_map<std::string, EmuLibraryEntry> entries{};
+	std::deque<std::string> queue{};
+	// CRCs from loaded games waiting for their file to be indexed
+	std::unordered_map<std::string, uint32> loadedCRC32{};
+	IG::Semaphore workSem{0};
+	bool started = false;
+	bool changed = false;
+
+	void queuePath(const char *path);
+	void run();
+	void indexFile(const std::string &path);
+	void indexDirectory(const std::string &path);
+	void pruneMissingFiles();
+};
@@ -31,7 +31,7 @@ public:
 	void loadFileBrowserItems();
 	void loadStandardItems();
 
-	static const uint STANDARD_ITEMS = 19;
+	static const uint STANDARD_ITEMS = 22;
 	static const uint MAX_SYSTEM_ITEMS = 5;
 
 protected:
@@ -39,6 +39,7 @@ protected:
 	TextMenuItem cheats;
 	TextMenuItem reset;
 	TextMenuItem loadState;
+	TextMenuItem inputMovie;
 	TextMenuItem recentGames;
 	TextMenuItem bundledGames;
 	TextMenuItem saveState;
@@ -62,5 +63,9 @@ protected:
 	TextMenuItem about;
 	TextMenuItem exitApp;
 	TextMenuItem screenshot;
+	#ifdef CONFIG_PROFILER
+	BoolMenuItem showFrameTimeGraph;
+	TextMenuItem exportProfilerTrace;
+	#endif
 	StaticArrayList<MenuItem*, STANDARD_ITEMS + MAX_SYSTEM_ITEMS> item{};
 };
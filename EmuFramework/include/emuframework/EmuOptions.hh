@@ -23,6 +23,7 @@
 extern Byte1Option optionAutoSaveState;
 extern Byte1Option optionConfirmAutoLoadState;
 extern Byte1Option optionSound;
+extern Byte1Option optionAudioRateControl;
 #ifdef CONFIG_AUDIO_LATENCY_HINT
 	#if defined CONFIG_AUDIO_ALSA || defined CONFIG_AUDIO_OPENSL_ES || defined CONFIG_AUDIO_PULSEAUDIO
 	// these backends may have additional buffering in the OS/driver
@@ -55,6 +56,10 @@ extern Byte1Option optionHideStatusBar;
 extern OptionSwappedGamepadConfirm optionSwappedGamepadConfirm;
 extern Byte1Option optionConfirmOverwriteState;
 extern Byte1Option optionFastForwardSpeed;
+extern Byte1Option optionEmuThread;
+extern Byte1Option optionRewindMemory;
+extern Byte1Option optionRunAheadFrames;
+extern Byte1Option optionArchiveCacheSize;
 #ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 extern Byte1Option optionNotifyInputDeviceChange;
 #endif
@@ -0,0 +1,72 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/util/ByteBuffer.hh>
+#include <vector>
+
+// Keeps a history of save states taken every few frames. Only the newest
+// state is stored in full, older ones are kept in a fixed-size ring as
+// run-length encoded & deflated XOR deltas against the following state.
+
+class EmuRewind
+{
+public:
+	static constexpr uint snapshotInterval = 4;
+	static constexpr uint maxSnapshots = 16384;
+
+	EmuRewind() {}
+	// allocate the history ring, 0 disables rewind and frees all buffers
+	void setMemoryBudget(size_t bytes);
+	bool isEnabled() const { return ring.size(); }
+	// discard all history, call when the loaded game changes
+	void reset();
+	// count emulated frames, capturing a state every snapshotInterval frames
+	void addFrames(uint frames);
+	// restore the previous snapshot, returns false if there's no history
+	bool stepBack();
+	uint snapshots() const { return count; }
+
+private:
+	struct Snapshot
+	{
+		uint32 offset = 0;
+		uint32 size = 0; // bytes used in the ring
+		uint32 deltaSize = 0; // size before deflating, same as size if stored as-is
+		uint32 stateSize = 0;
+
+		bool isPacked() const { return size != deltaSize; }
+	};
+
+	IG::ByteBuffer ring{};
+	IG::ByteBuffer prevState{};
+	IG::ByteBuffer state{};
+	IG::ByteBuffer delta{};
+	IG::ByteBuffer packedDelta{};
+	std::vector<Snapshot> snapshot{};
+	uint head = 0;
+	uint count = 0;
+	uint32 writeOffset = 0;
+	uint frameCount = 0;
+	bool hasPrevState = false;
+
+	void capture();
+	void push(const uint8 *data, size_t size, size_t deltaSize, uint32 stateSize);
+	Snapshot &oldest();
+	void popOldest();
+	Snapshot popNewest();
+};
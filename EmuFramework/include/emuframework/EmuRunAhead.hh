@@ -0,0 +1,46 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/util/ByteBuffer.hh>
+
+class EmuVideo;
+
+// Hides a game's internal input lag by showing a frame emulated a few
+// frames ahead of the real one: after each real frame the state is saved,
+// the extra frames run with the current input and only the last one is
+// presented, then the saved state is restored. Audio only comes from the
+// real frame so it plays back unchanged.
+
+class EmuRunAhead
+{
+public:
+	static constexpr uint maxFrames = 4;
+
+	EmuRunAhead() {}
+	// number of frames to run ahead, 0 disables run-ahead and frees the state buffer,
+	// always 0 for systems without EmuSystem::hasMemoryStates
+	void setFrames(uint frames);
+	uint frames() const { return frames_; }
+	bool isEnabled() const { return frames_; }
+	// run & present one frame, doing the extra run-ahead frames if enabled
+	void runFrame(EmuVideo &video, bool renderGfx, bool renderAudio);
+
+private:
+	IG::ByteBuffer state{};
+	uint frames_ = 0;
+};
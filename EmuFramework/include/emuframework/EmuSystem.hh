@@ -25,6 +25,7 @@
 #include <imagine/gui/View.hh>
 #include <imagine/util/audio/PcmFormat.hh>
 #include <imagine/util/string.h>
+#include <imagine/util/ByteBuffer.hh>
 #include <stdexcept>
 #include <experimental/optional>
 #include <emuframework/EmuVideo.hh>
@@ -43,6 +44,7 @@
 #endif
 
 class EmuInputView;
+struct EmuLibraryEntry;
 
 struct AspectRatioInfo
 {
@@ -67,6 +69,7 @@ class EmuSystem
 private:
 	static FS::PathString gamePath_, fullGamePath_;
 	static FS::FileString gameName_, fullGameName_, originalGameName_;
+	static uint32 gameCRC32_;
 	static FS::PathString defaultSavePath_;
 	static FS::PathString gameSavePath_;
 
@@ -107,9 +110,6 @@ public:
 	static FS::PathString savePath_;
 	static Base::Timer autoSaveStateTimer;
 	static int saveStateSlot;
-	static Base::FrameTimeBase startFrameTime;
-	static Base::FrameTimeBase timePerVideoFrame;
-	static uint emuFrameNow;
 	static bool runFrameOnDraw;
 	static Audio::PcmFormat pcmFormat;
 	static uint audioFramesPerVideoFrame;
@@ -137,6 +137,7 @@ public:
 	static bool handlesGenericIO;
 	static bool hasCheats;
 	static bool hasSound;
+	static bool hasMemoryStates;
 	static int forcedSoundRate;
 	static bool constFrameRate;
 	static NameFilterFunc defaultFsFilter;
@@ -151,6 +152,9 @@ public:
 	static void startAutoSaveStateTimer();
 	static Error loadState(const char *path);
 	static Error saveState(const char *path);
+	// serialize to/from memory, only supported if hasMemoryStates is set
+	static Error saveState(IG::ByteBuffer &buff);
+	static Error loadState(const IG::ByteBuffer &buff);
 	static bool stateExists(int slot);
 	static bool shouldOverwriteExistingState();
 	static const char *systemName();
@@ -162,9 +166,14 @@ public:
 	static FS::FileString fullGameName() { return strlen(fullGameName_.data()) ? fullGameName_ : gameName_; }
 	static FS::FileString gameFileName() { return FS::basename(fullGamePath_); }
 	static FS::FileString originalGameFileName() { return strlen(originalGameName_.data()) ? originalGameName_ : gameFileName(); }
+	// CRC32 of the loaded game's data if it was in memory to hash, otherwise 0
+	static uint32 gameCRC32() { return gameCRC32_; }
 	static void setFullGameName(const char *name) { string_copy(fullGameName_, name); }
 	static FS::FileString fullGameNameForPathDefaultImpl(const char *path);
 	static FS::FileString fullGameNameForPath(const char *path);
+	// fill in the title & region from a game file's header for the library index,
+	// called from the indexing thread so it can't touch emulator state
+	static void readLibraryMetadata(IO &io, EmuLibraryEntry &entry);
 	static FS::PathString baseSavePath();
 	static void makeDefaultSavePath();
 	static const char *defaultSavePath();
@@ -180,6 +189,9 @@ public:
 	static Error onOptionsLoaded();
 	static void writeConfig(IO &io);
 	static bool readConfig(IO &io, uint key, uint readSize);
+	// sets an option by name from the headless benchmark's --set argument,
+	// returns false if the name or value isn't valid
+	static bool setBenchOption(const char *name, const char *value);
 	static void createWithMedia(GenericIO io, const char *path, const char *name,
 		Error &err, OnLoadProgressDelegate onLoadProgress);
 	static Error loadGame(IO &io, OnLoadProgressDelegate onLoadProgress);
@@ -202,6 +214,14 @@ public:
 	static void configFrameTime();
 	static void clearInputBuffers(EmuInputView &view);
 	static void handleInputAction(uint state, uint emuKey);
+	// called on the main thread before an action is queued for
+	// handleInputAction(), which may run on the emulation thread, so cores
+	// handle UI actions like toggling the virtual keyboard here, returns
+	// true if the action was consumed, or it can be rewritten & queued
+	static bool handleUIInputAction(uint &state, uint &emuKey);
+	// apply input that arrived since the frame started, called by cores
+	// where the emulated system reads its controllers
+	static void pollInput();
 	static uint translateInputAction(uint input, bool &turbo);
 	static uint translateInputAction(uint input)
 	{
@@ -213,7 +233,6 @@ public:
 	static void stopSound();
 	static void startSound();
 	static void writeSound(const void *samples, uint framesToWrite);
-	static uint advanceFramesWithTime(Base::FrameTimeBase time);
 	static void setupGamePaths(const char *filePath);
 	static void setGameSavePath(const char *path);
 	static void setupGameSavePath();
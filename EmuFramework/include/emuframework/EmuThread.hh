@@ -0,0 +1,57 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/base/Pipe.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <atomic>
+
+// Runs EmuSystem::runFrame() on a dedicated thread so a slow frame doesn't
+// stall input handling & drawing on the main thread. Finished frames are
+// passed to the main thread through EmuVideo's frame queue.
+
+class EmuThread
+{
+public:
+	EmuThread() {}
+	void start();
+	bool isStarted() const { return started; }
+	bool isEmuThread() const;
+	// request the thread to run skipFrames + 1 frames, returns false
+	// without queuing anything if the previous request hasn't finished
+	bool runFrames(uint skipFrames, bool skipFramesAudio, bool renderAudio);
+	bool isBusy() const { return busy; }
+	// block until any in-progress frames finish, must be called before
+	// accessing emulator state from the main thread while the thread is active
+	void waitForIdle();
+	// called from the emulation thread when a frame is ready for display
+	void postFrameReady();
+
+private:
+	IG::Semaphore execSem{0}, idleSem{0};
+	Base::Pipe framePipe{};
+	IG::thread::id threadId{};
+	std::atomic_bool busy{};
+	std::atomic_bool waitingForIdle{};
+	uint skipFrames = 0;
+	bool skipFramesAudio = false;
+	bool renderAudio = false;
+	bool started = false;
+
+	void run();
+};
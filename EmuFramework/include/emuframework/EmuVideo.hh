@@ -17,6 +17,8 @@
 
 #include <imagine/gfx/Gfx.hh>
 #include <imagine/gfx/Texture.hh>
+#include <array>
+#include <atomic>
 
 class EmuVideo;
 
@@ -69,7 +71,32 @@ public:
 	bool isExternalTexture();
 	Gfx::Renderer &renderer() { return r; }
 	IG::WP size() const;
+	void setThreadedMode(bool on);
+	bool isThreadedMode() const { return threaded; }
+	// frames only go to the queue buffers & are never uploaded to a texture
+	void setHeadlessMode(bool on);
+	bool isHeadlessMode() const { return headless; }
+	// returns the last frame written in headless mode & marks it as read,
+	// or an empty pixmap if no frame was written since the last call
+	IG::Pixmap takeHeadlessFrame();
+	bool presentFrame();
 
 protected:
+	// frame queue used when running on the emulation thread,
+	// buffers are swapped between the writer & presenter without locking
+	static constexpr uint FRAME_READY_BIT = 0x4;
+	std::array<IG::MemPixmap, 3> frameBuff{};
+	std::atomic_uint readyFrameIdx{1};
+	uint writeFrameIdx = 0;
+	uint presentFrameIdx = 2;
+	IG::PixmapDesc frameDesc{};
+	// size of vidImg, safe to read while the main thread re-creates it
+	std::atomic<IG::WP> imgSize{};
+	bool threaded = false;
+	bool headless = false;
+
 	void doScreenshot(IG::Pixmap pix);
+	void setTextureFormat(IG::PixmapDesc desc);
+	bool usesFrameQueue() const;
+	void queueFrame(IG::Pixmap pix);
 };
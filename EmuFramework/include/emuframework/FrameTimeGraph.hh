@@ -0,0 +1,46 @@
+#pragma once
+
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/gfx/GfxText.hh>
+#include <imagine/gfx/ProjectionPlane.hh>
+#include <array>
+
+// Overlay showing the durations of recently displayed frames
+// recorded by the profiler along with their average & maximum
+
+class FrameTimeGraph
+{
+public:
+	static constexpr uint frames = 120;
+
+	FrameTimeGraph(Gfx::Renderer &r): r{r} {}
+	void setFace(Gfx::GlyphTextureSet &face);
+	void place(const Gfx::ProjectionPlane &projP);
+	void setVisible(bool on) { visible = on; }
+	bool isVisible() const { return visible; }
+	void draw(double targetFrameTime);
+
+private:
+	Gfx::Renderer &r;
+	Gfx::Text text{};
+	Gfx::ProjectionPlane projP{};
+	std::array<char, 64> str{};
+	uint framesUntilTextUpdate = 0;
+	bool visible = false;
+
+	void updateText(const uint64_t *nSecs, uint count);
+};
@@ -290,7 +290,10 @@ enum { CFGKEY_SOUND = 0, CFGKEY_TOUCH_CONTROL_DISPLAY = 1,
 	CFGKEY_CHECK_SAVE_PATH_WRITE_ACCESS = 74, CFGKEY_IMAGE_EFFECT_PIXEL_FORMAT = 75,
 	CFGKEY_SKIP_LATE_FRAMES = 76, CFGKEY_FRAME_RATE = 77,
 	CFGKEY_FRAME_RATE_PAL = 78, CFGKEY_TIME_FRAMES_WITH_SCREEN_REFRESH = 79,
-	CFGKEY_FAKE_USER_ACTIVITY = 80, CFGKEY_SHOW_BLUETOOTH_SCAN = 81
+	CFGKEY_FAKE_USER_ACTIVITY = 80, CFGKEY_SHOW_BLUETOOTH_SCAN = 81,
+	CFGKEY_EMU_THREAD = 82, CFGKEY_REWIND_MEMORY = 83,
+	CFGKEY_AUDIO_RATE_CONTROL = 84, CFGKEY_RUN_AHEAD = 85,
+	CFGKEY_ARCHIVE_CACHE_SIZE = 86
 	// 256+ is reserved
 };
 
@@ -101,6 +101,7 @@ protected:
 	#endif
 	TextMenuItem audioRateItem[4];
 	MultiChoiceMenuItem audioRate;
+	BoolMenuItem rateControl;
 	#ifdef CONFIG_AUDIO_OPENSL_ES
 	BoolMenuItem sndUnderrunCheck;
 	#endif
@@ -127,12 +128,19 @@ protected:
 	static constexpr uint MIN_FAST_FORWARD_SPEED = 2;
 	TextMenuItem fastForwardSpeedItem[6];
 	MultiChoiceMenuItem fastForwardSpeed;
+	BoolMenuItem emulationThread;
+	TextMenuItem rewindMemoryItem[5];
+	MultiChoiceMenuItem rewindMemory;
+	TextMenuItem runAheadItem[5];
+	MultiChoiceMenuItem runAhead;
+	TextMenuItem archiveCacheItem[5];
+	MultiChoiceMenuItem archiveCache;
 	#if defined __ANDROID__
 	TextMenuItem processPriorityItem[3];
 	MultiChoiceMenuItem processPriority;
 	BoolMenuItem fakeUserActivity;
 	#endif
-	StaticArrayList<MenuItem*, 24> item{};
+	StaticArrayList<MenuItem*, 28> item{};
 
 	void onSavePathChange(const char *path);
 	virtual void onFirmwarePathChange(const char *path, Input::Event e);
@@ -17,12 +17,14 @@
 
 #include <imagine/gui/TableView.hh>
 #include <imagine/gui/MenuItem.hh>
+#include <string>
 #include <vector>
 
 class RecentGameView : public TableView
 {
 private:
 	std::vector<TextMenuItem> recentGame{};
+	std::vector<std::string> recentGameTitle{};
 	TextMenuItem clear{};
 
 public:
@@ -164,7 +164,7 @@ public:
 	bool boundingAreaVisible() const;
 	void setMenuBtnPos(IG::Point2D<int> pos);
 	void setFFBtnPos(IG::Point2D<int> pos);
-	void inputAction(uint action, uint vBtn);
+	void inputAction(uint action, uint vBtn, Input::Time time = {});
 	void resetInput(bool init = 0);
 	void init(float alpha, uint gamepadBtnSizeInPixels, uint uiBtnSizeInPixels, const Gfx::ProjectionPlane &projP);
 	void place();
@@ -229,6 +229,10 @@ static bool readConfig2(IO &io)
 			bcase CFGKEY_HIDE_STATUS_BAR: optionHideStatusBar.readFromIO(io, size);
 			bcase CFGKEY_CONFIRM_OVERWRITE_STATE: optionConfirmOverwriteState.readFromIO(io, size);
 			bcase CFGKEY_FAST_FORWARD_SPEED: optionFastForwardSpeed.readFromIO(io, size);
+			bcase CFGKEY_EMU_THREAD: optionEmuThread.readFromIO(io, size);
+			bcase CFGKEY_REWIND_MEMORY: optionRewindMemory.readFromIO(io, size);
+			bcase CFGKEY_RUN_AHEAD: optionRunAheadFrames.readFromIO(io, size);
+			bcase CFGKEY_ARCHIVE_CACHE_SIZE: optionArchiveCacheSize.readFromIO(io, size);
 			#ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 			bcase CFGKEY_NOTIFY_INPUT_DEVICE_CHANGE: optionNotifyInputDeviceChange.readFromIO(io, size);
 			#endif
@@ -252,6 +256,7 @@ static bool readConfig2(IO &io)
 			#endif
 			#ifdef CONFIG_AUDIO_LATENCY_HINT
 			bcase CFGKEY_SOUND_BUFFERS: optionSoundBuffers.readFromIO(io, size);
+			bcase CFGKEY_AUDIO_RATE_CONTROL: optionAudioRateControl.readFromIO(io, size);
 			#endif
 			#ifdef EMU_FRAMEWORK_STRICT_UNDERRUN_CHECK_OPTION
 			bcase CFGKEY_SOUND_UNDERRUN_CHECK: optionSoundUnderrunCheck.readFromIO(io, size);
@@ -461,6 +466,11 @@ static OptionBase *cfgFileOption[] =
 	&optionSwappedGamepadConfirm,
 	&optionConfirmOverwriteState,
 	&optionFastForwardSpeed,
+	&optionEmuThread,
+	&optionRewindMemory,
+	&optionRunAheadFrames,
+	&optionArchiveCacheSize,
+	&optionAudioRateControl,
 	#ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 	&optionNotifyInputDeviceChange,
 	#endif
@@ -66,6 +66,17 @@ EmuView emuView2{{extraWin.win, renderer}, nullptr, nullptr};
 AppWindowData *emuWin = &mainWin;
 ViewStack viewStack{};
 MsgPopup popup{renderer};
+#ifdef CONFIG_PROFILER
+FrameTimeGraph frameTimeGraph{renderer};
+#endif
+EmuThread emuThread{};
+EmuRewind emuRewind{};
+EmuRunAhead emuRunAhead{};
+EmuInputQueue emuInputQueue{};
+EmuInputMovie emuInputMovie{};
+EmuFramePacer emuFramePacer{};
+EmuLibrary emuLibrary{};
+EmuArchiveCache emuArchiveCache{};
 BasicViewController modalViewController{};
 DelegateFunc<void ()> onUpdateInputDevices{};
 Base::Screen::OnFrameDelegate onFrameUpdate{};
@@ -135,12 +146,25 @@ static void drawEmuVideo(Gfx::Renderer &r)
 	else if(emuView2.hasLayer())
 		emuView2.draw();
 	popup.draw();
+	#ifdef CONFIG_PROFILER
+	frameTimeGraph.draw(EmuSystem::frameTime());
+	#endif
 	r.setClipRect(false);
 	r.presentDrawable(emuWin->drawable);
+	IG::Profiler::markFrame();
 }
 
 void EmuApp::updateAndDrawEmuVideo()
 {
+	IG_PROFILE_SCOPE("EmuApp::updateAndDrawEmuVideo");
+	if(emuVideo.isHeadlessMode())
+		return;
+	if(emuThread.isEmuThread())
+	{
+		// frame was queued in EmuVideo, draw it from the main thread
+		emuThread.postFrameReady();
+		return;
+	}
 	drawEmuVideo(renderer);
 }
 
@@ -192,6 +216,11 @@ static void applyFrameRates()
 
 static void startEmulation()
 {
+	if(optionEmuThread)
+		emuThread.start();
+	emuVideo.setThreadedMode(optionEmuThread);
+	emuRewind.setMemoryBudget(EmuSystem::hasMemoryStates ? optionRewindMemory * 1024 * 1024 : 0);
+	emuRunAhead.setFrames(optionRunAheadFrames);
 	setCPUNeedsLowLatency(true);
 	EmuSystem::start();
 	emuWin->win.screen()->addOnFrameOnce(onFrameUpdate);
@@ -231,10 +260,19 @@ void EmuApp::exitGame(bool allowAutosaveState)
 
 static void drawEmuFrame(Gfx::Renderer &r)
 {
-	if(EmuSystem::runFrameOnDraw)
+	if(emuVideo.isThreadedMode())
 	{
-		bool renderAudio = optionSound;
-		EmuSystem::runFrame(emuVideo, true, true, renderAudio);
+		emuVideo.presentFrame();
+		drawEmuVideo(r);
+	}
+	else if(EmuSystem::runFrameOnDraw)
+	{
+		bool renderAudio = optionSound && !rewindActive;
+		IG_PROFILE_SCOPE("EmuSystem::runFrame");
+		auto startTime = IG::Time::now();
+		emuRunAhead.runFrame(emuVideo, true, renderAudio);
+		emuFramePacer.addFrameCost(IG::Time::now() - startTime, 1);
+		emuRewind.addFrames(1);
 		EmuSystem::runFrameOnDraw = false;
 	}
 	else
@@ -461,6 +499,8 @@ void mainInitCommon(int argc, char** argv)
 	initOptions();
 	auto launchGame = parseCmdLineArgs(argc, argv);
 	loadConfigFile();
+	emuLibrary.load();
+	emuArchiveCache.setMaxSize(optionArchiveCacheSize * 128ull * 1024 * 1024);
 	if(auto err = EmuSystem::onOptionsLoaded();
 		err)
 	{
@@ -604,6 +644,7 @@ void mainInitCommon(int argc, char** argv)
 			}
 
 			saveConfigFile();
+			emuLibrary.save();
 
 			#ifdef CONFIG_BLUETOOTH
 			if(bta && (!backgrounded || (backgrounded && !optionKeepBluetoothActive)))
@@ -674,40 +715,86 @@ void mainInitCommon(int argc, char** argv)
 
 	onFrameUpdate = [](Base::Screen::FrameParams params)
 		{
+			bool threaded = emuVideo.isThreadedMode();
+			if(threaded && emuThread.isBusy())
+			{
+				// previous frame is still running, any elapsed frames
+				// are picked up by the next update
+				params.readdOnFrame();
+				return;
+			}
 			commonUpdateInput();
-			if(unlikely(fastForwardActive))
+			if(unlikely(rewindActive))
 			{
-				EmuSystem::runFrameOnDraw = true;
-				postDrawToEmuWindows();
-				iterateTimes((uint)optionFastForwardSpeed, i)
+				// show one frame from the restored state
+				if(emuRewind.stepBack())
+				{
+					if(threaded)
+					{
+						emuThread.runFrames(0, false, false);
+					}
+					else
+					{
+						EmuSystem::runFrameOnDraw = true;
+						postDrawToEmuWindows();
+					}
+				}
+			}
+			else if(unlikely(fastForwardActive))
+			{
+				if(threaded)
 				{
-					EmuSystem::runFrame(emuVideo, false, false, false);
+					emuThread.runFrames(optionFastForwardSpeed, false, optionSound);
+				}
+				else
+				{
+					EmuSystem::runFrameOnDraw = true;
+					postDrawToEmuWindows();
+					IG_PROFILE_SCOPE("EmuSystem::runFrame");
+					iterateTimes((uint)optionFastForwardSpeed, i)
+					{
+						emuInputQueue.startFrame();
+						EmuSystem::runFrame(emuVideo, false, false, false);
+					}
+					emuRewind.addFrames(optionFastForwardSpeed);
 				}
 			}
 			else
 			{
-				uint frames = EmuSystem::advanceFramesWithTime(params.timestamp());
+				uint frames = emuFramePacer.update(params.timestamp(), params.screen().frameTime());
 				//logDMsg("%d frames elapsed (%fs)", frames, Base::frameTimeBaseToSecsDec(params.frameTimeDiff()));
 				if(frames)
 				{
-					EmuSystem::runFrameOnDraw = true;
-					postDrawToEmuWindows();
-					constexpr uint maxLateFrameSkip = 6;
-					uint maxFrameSkip = optionSkipLateFrames ? maxLateFrameSkip : 0;
+					uint maxFrameSkip = optionSkipLateFrames ? emuFramePacer.maxFrameSkip() : 0;
 					#if defined CONFIG_BASE_SCREEN_FRAME_INTERVAL
 					if(!optionSkipLateFrames)
 						maxFrameSkip = optionFrameInterval - 1;
 					#endif
-					assumeExpr(maxFrameSkip <= maxLateFrameSkip);
+					assumeExpr(maxFrameSkip <= EmuFramePacer::maxFrameSkipLimit);
+					uint framesToSkip = 0;
 					if(frames > 1 && maxFrameSkip)
 					{
-						uint framesToSkip = frames - 1;
+						framesToSkip = frames - 1;
 						framesToSkip = std::min(framesToSkip, maxFrameSkip);
-						bool renderAudio = optionSound;
+					}
+					bool renderAudio = optionSound;
+					if(threaded)
+					{
+						emuThread.runFrames(framesToSkip, renderAudio, renderAudio);
+					}
+					else
+					{
+						EmuSystem::runFrameOnDraw = true;
+						postDrawToEmuWindows();
+						IG_PROFILE_SCOPE("EmuSystem::runFrame");
+						auto startTime = IG::Time::now();
 						iterateTimes(framesToSkip, i)
 						{
+							emuInputQueue.startFrame();
 							EmuSystem::runFrame(emuVideo, false, false, renderAudio);
 						}
+						emuFramePacer.addFrameCost(IG::Time::now() - startTime, framesToSkip);
+						emuRewind.addFrames(framesToSkip);
 					}
 				}
 			}
@@ -819,6 +906,9 @@ void mainInitWindowCommon(Base::Window &win)
 
 	setupFont(renderer);
 	popup.setFace(View::defaultFace);
+	#ifdef CONFIG_PROFILER
+	frameTimeGraph.setFace(View::defaultFace);
+	#endif
 	#ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
 	initVControls(renderer);
 	EmuControls::updateVControlImg();
@@ -947,6 +1037,9 @@ void placeElements()
 	logMsg("placing app elements");
 	TableView::setDefaultXIndent(mainWin.projectionPlane);
 	popup.place(emuWin->projectionPlane);
+	#ifdef CONFIG_PROFILER
+	frameTimeGraph.place(emuWin->projectionPlane);
+	#endif
 	placeEmuViews();
 	viewStack.place(mainWin.viewport().bounds(), mainWin.projectionPlane);
 	modalViewController.place(mainWin.viewport().bounds(), mainWin.projectionPlane);
@@ -998,7 +1091,10 @@ void loadGameComplete(bool tryAutoState, bool addToRecent)
 		}
 	}
 	if(addToRecent)
+	{
 		addRecentGame();
+		emuLibrary.addFile(EmuSystem::fullGamePath(), EmuSystem::gameCRC32());
+	}
 	startGameFromMenu();
 }
 
@@ -1285,6 +1381,7 @@ EmuSystem::Error EmuApp::saveState(const char *path)
 	{
 		return EmuSystem::makeError("System not running");
 	}
+	emuThread.waitForIdle();
 	fixFilePermissions(path);
 	logMsg("saving state %s", path);
 	return EmuSystem::saveState(path);
@@ -1306,6 +1403,9 @@ EmuSystem::Error EmuApp::loadState(const char *path)
 	{
 		return EmuSystem::makeError("File doesn't exist");
 	}
+	emuThread.waitForIdle();
+	// the movie's input wouldn't match the loaded state
+	emuInputMovie.stop();
 	fixFilePermissions(path);
 	logMsg("loading state %s", path);
 	return EmuSystem::loadState(path);
@@ -1367,6 +1467,7 @@ namespace Base
 
 void onInit(int argc, char** argv)
 {
+	IG::Profiler::setThreadName("Main");
 	if(auto err = EmuSystem::onInit();
 		err)
 	{
@@ -1376,4 +1477,14 @@ void onInit(int argc, char** argv)
 	mainInitCommon(argc, argv);
 }
 
+#ifdef CONFIG_BASE_X11
+bool onHeadlessInit(int argc, char** argv, int &exitCode)
+{
+	if(argc < 2 || !string_equal(argv[1], "--bench"))
+		return false;
+	exitCode = runHeadlessBenchmark(argc, argv);
+	return true;
+}
+#endif
+
 }
@@ -0,0 +1,176 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ArchiveCache"
+#include <emuframework/EmuArchiveCache.hh>
+#include <imagine/base/Base.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/ScopeGuard.hh>
+#include <imagine/util/string.h>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <utime.h>
+
+static FS::PathString cacheDirPath()
+{
+	return FS::makePathStringPrintf("%s/archive-cache", Base::documentsPath().data());
+}
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t size)
+{
+	auto bytes = (const uint8*)data;
+	iterateTimes(size, i)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001b3;
+	}
+	return hash;
+}
+
+void EmuArchiveCache::setMaxSize(uint64_t bytes)
+{
+	if(bytes == maxSize)
+		return;
+	maxSize = bytes;
+	if(maxSize)
+	{
+		logMsg("cache size limit %lluMiB", (unsigned long long)(maxSize / (1024 * 1024)));
+		evict(nullptr);
+	}
+}
+
+FS::PathString EmuArchiveCache::entryPath(const char *archivePath, uint32 crc32, const char *memberName, uint64_t size) const
+{
+	uint64_t hash = 0xcbf29ce484222325;
+	hash = fnv1a(hash, memberName, strlen(memberName));
+	hash = fnv1a(hash, &size, sizeof(size));
+	if(crc32)
+	{
+		hash = fnv1a(hash, &crc32, sizeof(crc32));
+	}
+	else
+	{
+		// archive doesn't store a CRC for its members, so fall back to
+		// identifying the archive file itself
+		auto status = FS::status(archivePath);
+		auto archiveSize = (uint64_t)status.size();
+		auto archiveTime = (int64_t)status.lastWriteTime();
+		hash = fnv1a(hash, archivePath, strlen(archivePath));
+		hash = fnv1a(hash, &archiveSize, sizeof(archiveSize));
+		hash = fnv1a(hash, &archiveTime, sizeof(archiveTime));
+	}
+	return FS::makePathStringPrintf("%s/%016llx", cacheDirPath().data(), (unsigned long long)hash);
+}
+
+FileIO EmuArchiveCache::open(ArchiveIO &io, const char *archivePath, uint32 crc32, const char *memberName, std::error_code &ec)
+{
+	ec = {};
+	uint64_t size = io.size();
+	if(!maxSize || size > maxSize)
+		return {};
+	auto path = entryPath(archivePath, crc32, memberName, size);
+	FileIO file{};
+	if(!file.open(path.data()) && file.size() == size)
+	{
+		logMsg("using cached %s for %s", path.data(), memberName);
+		// update the modification time for LRU eviction
+		utime(path.data(), nullptr);
+		return file;
+	}
+	FS::create_directory(cacheDirPath());
+	auto tempPath = FS::makePathStringPrintf("%s.tmp", path.data());
+	FileIO tempFile{};
+	if(tempFile.create(tempPath.data()))
+	{
+		// io hasn't been read yet so the caller can still use it directly
+		logErr("error creating %s", tempPath.data());
+		return {};
+	}
+	auto removeTempFile = IG::scopeGuard([&](){ FS::remove(tempPath); });
+	logMsg("extracting %s to %s", memberName, path.data());
+	std::vector<char> buff(1024 * 1024);
+	uint64_t bytesLeft = size;
+	while(bytesLeft)
+	{
+		auto bytesRead = io.read(buff.data(), std::min((uint64_t)buff.size(), bytesLeft), &ec);
+		if(bytesRead <= 0)
+		{
+			logErr("error reading %s from archive", memberName);
+			if(!ec)
+				ec = {EIO, std::system_category()};
+			return {};
+		}
+		if(tempFile.write(buff.data(), bytesRead, &ec) != bytesRead)
+		{
+			logErr("error writing %s", tempPath.data());
+			if(!ec)
+				ec = {ENOSPC, std::system_category()};
+			return {};
+		}
+		bytesLeft -= bytesRead;
+	}
+	tempFile.close();
+	FS::rename(tempPath.data(), path.data(), ec);
+	if(ec)
+	{
+		logErr("error renaming %s", tempPath.data());
+		return {};
+	}
+	removeTempFile.cancel();
+	evict(path.data());
+	if((ec = file.open(path.data())))
+	{
+		logErr("error opening %s", path.data());
+		return {};
+	}
+	return file;
+}
+
+void EmuArchiveCache::evict(const char *keepPath)
+{
+	struct CacheFile
+	{
+		FS::PathString path;
+		uint64_t size;
+		FS::file_time_type time;
+	};
+	std::vector<CacheFile> files{};
+	uint64_t totalSize = 0;
+	auto dirPath = cacheDirPath();
+	std::error_code ec{};
+	for(auto &entry : FS::directory_iterator{dirPath, ec})
+	{
+		auto path = FS::makePathString(dirPath.data(), entry.name());
+		auto status = FS::status(path);
+		if(status.type() != FS::file_type::regular)
+			continue;
+		files.push_back({path, status.size(), status.lastWriteTime()});
+		totalSize += status.size();
+	}
+	if(totalSize <= maxSize)
+		return;
+	std::sort(files.begin(), files.end(),
+		[](const CacheFile &f1, const CacheFile &f2){ return f1.time < f2.time; });
+	for(auto &f : files)
+	{
+		if(totalSize <= maxSize)
+			break;
+		if(keepPath && string_equal(f.path.data(), keepPath))
+			continue;
+		logMsg("removing %s from cache", f.path.data());
+		if(FS::remove(f.path))
+			totalSize -= f.size;
+	}
+}
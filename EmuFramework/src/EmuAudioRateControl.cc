@@ -0,0 +1,80 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "AudioRateControl"
+#include <emuframework/EmuAudioRateControl.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+// weight of the newest buffer level sample in the running average
+static constexpr double levelAvgWeight = 1. / 32.;
+// nominal rate passed to the resampler, the output rate is scaled from it by
+// the ratio, so it sets the ratio's resolution
+static constexpr uint32 rateScale = 1000000;
+
+void EmuAudioRateControl::reset()
+{
+	ratio_ = 1.;
+	avgFreeFraction = .5;
+	bufferFrames = 0;
+	if(resampler)
+	{
+		resampler.setRate(rateScale, rateScale);
+		resampler.reset();
+	}
+}
+
+void EmuAudioRateControl::updateRatio(int framesFree)
+{
+	// the buffer's size isn't known up front, so use the most
+	// free space seen since the last reset
+	bufferFrames = std::max(bufferFrames, (uint)std::max(framesFree, 0));
+	if(!bufferFrames)
+	{
+		ratio_ = 1.;
+	}
+	else
+	{
+		double freeFraction = std::max(framesFree, 0) / (double)bufferFrames;
+		avgFreeFraction += (freeFraction - avgFreeFraction) * levelAvgWeight;
+		// emptier buffer -> produce more output frames per input frame
+		ratio_ = 1. + maxRatioDelta * (2. * avgFreeFraction - 1.);
+	}
+	resampler.setRate(rateScale, std::lround(rateScale * ratio_));
+}
+
+const int16 *EmuAudioRateControl::resample(const int16 *samples, uint frames, uint channels,
+	int framesFree, uint &framesOut)
+{
+	assert(channels && channels <= maxChannels);
+	if(channels != this->channels)
+	{
+		if(!resampler.init(rateScale, rateScale, channels))
+		{
+			framesOut = frames;
+			return samples;
+		}
+		this->channels = channels;
+	}
+	updateRatio(framesFree);
+	resampler.push(samples, frames);
+	auto maxOutFrames = resampler.framesAvailable();
+	if(output.size() < maxOutFrames * channels)
+		output.resize(maxOutFrames * channels);
+	framesOut = resampler.pull(output.data(), maxOutFrames);
+	return output.data();
+}
@@ -0,0 +1,371 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "BenchRunner"
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuOptions.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/string.h>
+#include <imagine/pixmap/Pixmap.hh>
+#include <sys/resource.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "private.hh"
+
+// Runs a game without a window or audio output & prints timing results as
+// JSON to stdout, invoked as: <app> --bench <game path> [options]
+// With --frame-hashes, a hash of every rendered frame (warmup frames
+// included) is written to a file, & --check-hashes compares against one,
+// so renderer changes like threading can be checked for identical output.
+
+static constexpr uint defaultFrames = 1800;
+
+struct BenchConfig
+{
+	const char *gamePath{};
+	const char *statePath{};
+	const char *moviePath{};
+	const char *frameHashesPath{};
+	const char *checkHashesPath{};
+	std::vector<const char *> options{};
+	// 0 runs the movie's length after warmup, or defaultFrames without one
+	uint frames = 0;
+	uint warmupFrames = 60;
+	bool renderGfx = false;
+	bool processGfx = true;
+	bool renderAudio = false;
+};
+
+static void printUsage(const char *exec)
+{
+	fprintf(stderr, "usage: %s --bench <game path> [--state <path> | --movie <path>] [--frames <count>] [--warmup <count>] "
+		"[--render] [--no-process] [--audio] [--frame-hashes <path>] [--check-hashes <path>] [--set <option>=<value>]...\n", exec);
+}
+
+static bool parseUInt(const char *str, uint &val)
+{
+	char *end;
+	auto num = strtoul(str, &end, 10);
+	if(end == str || *end)
+		return false;
+	val = num;
+	return true;
+}
+
+static bool parseArgs(int argc, char** argv, BenchConfig &conf)
+{
+	for(int i = 2; i < argc; i++)
+	{
+		auto arg = argv[i];
+		bool hasVal = i + 1 < argc;
+		if(string_equal(arg, "--state") && hasVal)
+			conf.statePath = argv[++i];
+		else if(string_equal(arg, "--movie") && hasVal)
+			conf.moviePath = argv[++i];
+		else if(string_equal(arg, "--frames") && hasVal)
+		{
+			if(!parseUInt(argv[++i], conf.frames) || !conf.frames)
+				return false;
+		}
+		else if(string_equal(arg, "--warmup") && hasVal)
+		{
+			if(!parseUInt(argv[++i], conf.warmupFrames))
+				return false;
+		}
+		else if(string_equal(arg, "--render"))
+			conf.renderGfx = true;
+		else if(string_equal(arg, "--no-process"))
+			conf.processGfx = false;
+		else if(string_equal(arg, "--audio"))
+			conf.renderAudio = true;
+		else if(string_equal(arg, "--frame-hashes") && hasVal)
+			conf.frameHashesPath = argv[++i];
+		else if(string_equal(arg, "--check-hashes") && hasVal)
+			conf.checkHashesPath = argv[++i];
+		else if(string_equal(arg, "--set") && hasVal && strchr(argv[i + 1], '='))
+			conf.options.emplace_back(argv[++i]);
+		else if(arg[0] != '-' && !conf.gamePath)
+			conf.gamePath = arg;
+		else
+			return false;
+	}
+	if(conf.frameHashesPath || conf.checkHashesPath)
+	{
+		// hashes are of the finished frames
+		conf.renderGfx = true;
+		conf.processGfx = true;
+	}
+	// a movie sets its own start point
+	return conf.gamePath && !(conf.statePath && conf.moviePath);
+}
+
+static bool setOptions(const std::vector<const char *> &options)
+{
+	for(auto opt : options)
+	{
+		auto sep = strchr(opt, '=');
+		std::string name{opt, (size_t)(sep - opt)};
+		if(!EmuSystem::setBenchOption(name.c_str(), sep + 1))
+		{
+			fprintf(stderr, "invalid option: %s\n", opt);
+			return false;
+		}
+	}
+	return true;
+}
+
+static uint64_t frameHash(IG::Pixmap pix)
+{
+	if(!pix)
+		return 0;
+	// FNV-1a over the size & each line's pixels, skipping any pitch padding
+	uint64_t hash = 0xcbf29ce484222325;
+	auto hashBytes = [&](const void *data, size_t size)
+		{
+			auto bytes = (const uint8_t*)data;
+			for(size_t i = 0; i < size; i++)
+				hash = (hash ^ bytes[i]) * 0x100000001b3;
+		};
+	uint32_t size[2]{pix.w(), pix.h()};
+	hashBytes(size, sizeof(size));
+	auto lineBytes = pix.format().pixelBytes(pix.w());
+	iterateTimes(pix.h(), y)
+	{
+		hashBytes(pix.pixel({0, (int)y}), lineBytes);
+	}
+	return hash;
+}
+
+static bool readFrameHashes(const char *path, std::vector<uint64_t> &hashes)
+{
+	auto file = fopen(path, "r");
+	if(!file)
+		return false;
+	uint64_t hash;
+	while(fscanf(file, "%" SCNx64, &hash) == 1)
+		hashes.emplace_back(hash);
+	fclose(file);
+	return true;
+}
+
+static void printJSONString(const char *str)
+{
+	putchar('"');
+	for(; *str; str++)
+	{
+		auto c = (unsigned char)*str;
+		if(c == '"' || c == '\\')
+			printf("\\%c", c);
+		else if(c < 0x20)
+			printf("\\u%04x", c);
+		else
+			putchar(c);
+	}
+	putchar('"');
+}
+
+static double percentileUSecs(const std::vector<uint64_t> &sortedNSecs, double percentile)
+{
+	// nearest-rank method
+	auto rank = (size_t)std::ceil(percentile / 100. * sortedNSecs.size());
+	return sortedNSecs[std::max(rank, (size_t)1) - 1] / 1000.;
+}
+
+struct FrameHashes
+{
+	FILE *output{};
+	std::vector<uint64_t> expected{};
+	bool check = false;
+	uint frame = 0;
+	int firstMismatch = -1;
+
+	void addFrame()
+	{
+		if(!output && !check)
+			return;
+		auto hash = frameHash(emuVideo.takeHeadlessFrame());
+		if(output)
+			fprintf(output, "%016" PRIx64 "\n", hash);
+		if(check && firstMismatch == -1
+			&& (frame >= expected.size() || expected[frame] != hash))
+		{
+			firstMismatch = frame;
+		}
+		frame++;
+	}
+
+	bool matched() const
+	{
+		return firstMismatch == -1 && frame == expected.size();
+	}
+};
+
+static void runFrame(const BenchConfig &conf)
+{
+	emuInputQueue.startFrame();
+	EmuSystem::runFrame(emuVideo, conf.renderGfx, conf.processGfx, conf.renderAudio);
+}
+
+int runHeadlessBenchmark(int argc, char** argv)
+{
+	BenchConfig conf{};
+	if(!parseArgs(argc, argv, conf))
+	{
+		printUsage(argv[0]);
+		return 1;
+	}
+	if(auto err = EmuSystem::onInit();
+		err)
+	{
+		fprintf(stderr, "error initializing system: %s\n", err->what());
+		return 1;
+	}
+	initOptions();
+	loadConfigFile();
+	if(!setOptions(conf.options))
+		return 1;
+	if(auto err = EmuSystem::onOptionsLoaded();
+		err)
+	{
+		fprintf(stderr, "error loading options: %s\n", err->what());
+		return 1;
+	}
+	emuVideo.setHeadlessMode(true);
+	if(auto err = EmuSystem::loadGameFromPath(conf.gamePath, {});
+		err)
+	{
+		fprintf(stderr, "error loading game: %s\n", err->what());
+		return 1;
+	}
+	for(auto vidSys : {EmuSystem::VIDSYS_NATIVE_NTSC, EmuSystem::VIDSYS_PAL})
+	{
+		if(!EmuSystem::frameTimeIsValid(vidSys, EmuSystem::frameTime(vidSys)))
+			EmuSystem::setFrameTime(vidSys, EmuSystem::defaultFrameTime(vidSys));
+	}
+	EmuSystem::prepareAudioVideo();
+	if(conf.statePath)
+	{
+		if(auto err = EmuSystem::loadState(conf.statePath);
+			err)
+		{
+			fprintf(stderr, "error loading state: %s\n", err->what());
+			return 1;
+		}
+	}
+	if(conf.moviePath)
+	{
+		if(auto err = emuInputMovie.startPlayback(conf.moviePath);
+			err)
+		{
+			fprintf(stderr, "error loading movie: %s\n", err->what());
+			return 1;
+		}
+	}
+	if(!conf.frames)
+	{
+		conf.frames = conf.moviePath ? std::max(emuInputMovie.frames(), conf.warmupFrames + 1) - conf.warmupFrames
+			: defaultFrames;
+	}
+	FrameHashes hashes{};
+	if(conf.checkHashesPath)
+	{
+		if(!readFrameHashes(conf.checkHashesPath, hashes.expected))
+		{
+			fprintf(stderr, "error reading frame hashes: %s\n", conf.checkHashesPath);
+			return 1;
+		}
+		hashes.check = true;
+	}
+	if(conf.frameHashesPath)
+	{
+		hashes.output = fopen(conf.frameHashesPath, "w");
+		if(!hashes.output)
+		{
+			fprintf(stderr, "error opening frame hashes: %s\n", conf.frameHashesPath);
+			return 1;
+		}
+	}
+	logMsg("running %u warmup & %u timed frames", conf.warmupFrames, conf.frames);
+	iterateTimes(conf.warmupFrames, i)
+	{
+		runFrame(conf);
+		hashes.addFrame();
+	}
+	std::vector<uint64_t> frameNSecs(conf.frames);
+	uint64_t totalNSecs = 0;
+	for(auto &nSecs : frameNSecs)
+	{
+		auto startTime = IG::Time::now();
+		runFrame(conf);
+		nSecs = (IG::Time::now() - startTime).nSecs();
+		totalNSecs += nSecs;
+		// hashing isn't timed
+		hashes.addFrame();
+	}
+	if(hashes.output)
+		fclose(hashes.output);
+	double totalSecs = totalNSecs / 1e9;
+	std::sort(frameNSecs.begin(), frameNSecs.end());
+	struct rusage usage{};
+	getrusage(RUSAGE_SELF, &usage); // ru_maxrss is in KiB on Linux
+	printf("{\"system\":");
+	printJSONString(EmuSystem::systemName());
+	printf(",\"game\":");
+	printJSONString(conf.gamePath);
+	printf(",\"state\":");
+	if(conf.statePath)
+		printJSONString(conf.statePath);
+	else
+		printf("null");
+	printf(",\"movie\":");
+	if(conf.moviePath)
+		printJSONString(conf.moviePath);
+	else
+		printf("null");
+	printf(",\"frames\":%u,\"warmupFrames\":%u", conf.frames, conf.warmupFrames);
+	printf(",\"renderGfx\":%s,\"processGfx\":%s,\"renderAudio\":%s",
+		conf.renderGfx ? "true" : "false", conf.processGfx ? "true" : "false", conf.renderAudio ? "true" : "false");
+	printf(",\"seconds\":%.6f,\"fps\":%.3f", totalSecs, conf.frames / totalSecs);
+	printf(",\"frameTimeUSecs\":{\"mean\":%.3f,\"min\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,\"max\":%.3f}",
+		totalSecs * 1e6 / conf.frames, frameNSecs.front() / 1000.,
+		percentileUSecs(frameNSecs, 50), percentileUSecs(frameNSecs, 90),
+		percentileUSecs(frameNSecs, 99), frameNSecs.back() / 1000.);
+	printf(",\"peakRSSKiB\":%ld", (long)usage.ru_maxrss);
+	if(hashes.check)
+	{
+		printf(",\"frameHashesMatch\":%s,\"firstFrameHashMismatch\":", hashes.matched() ? "true" : "false");
+		if(hashes.firstMismatch != -1)
+			printf("%d", hashes.firstMismatch);
+		else
+			printf("null");
+	}
+	printf("}\n");
+	fflush(stdout);
+	if(hashes.check && !hashes.matched())
+	{
+		fprintf(stderr, "frame hashes don't match %s\n", conf.checkHashesPath);
+		return 1;
+	}
+	// the game is left loaded so nothing like backup memory gets written
+	// back to disk, the process exits right after this returns
+	return 0;
+}
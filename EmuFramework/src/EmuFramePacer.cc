@@ -0,0 +1,165 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "FramePacer"
+#include <emuframework/EmuFramePacer.hh>
+#include <emuframework/EmuAudioRateControl.hh>
+#include <emuframework/EmuOptions.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/utility.h>
+#include <algorithm>
+#include <cmath>
+
+// timestamps further apart than this many vblanks are treated as a stall
+// instead of time the emulation needs to catch up on
+static constexpr uint maxVBlankGap = 8;
+// interval samples differing from the estimate by more than this fraction are
+// ignored, unless enough arrive in a row to show the estimate itself is wrong
+static constexpr double maxVBlankDeviation = .2;
+static constexpr uint maxOutlierSamples = 30;
+// the first samples are averaged evenly so the estimate settles quickly,
+// after that each one moves it by 1/filterSamples
+static constexpr uint filterSamples = 64;
+// fraction of a vblank available for running frames, the rest is left
+// for presenting & the UI
+static constexpr double frameBudget = .75;
+
+void EmuFramePacer::setFrameTime(double secs)
+{
+	frameSecs = secs;
+	reset();
+}
+
+void EmuFramePacer::reset()
+{
+	lastTimestamp = {};
+	pendingFrames = 0;
+	vblankSecs = 0;
+	vblankSamples = 0;
+	outlierSamples = 0;
+	outlierSecs = 0;
+	lockedVBlankFrames = 0;
+}
+
+uint EmuFramePacer::update(Base::FrameTimeBase timestamp, double nominalVBlankSecs)
+{
+	if(unlikely(!lastTimestamp))
+	{
+		// first frame
+		lastTimestamp = timestamp;
+		if(!vblankSecs)
+		{
+			vblankSecs = nominalVBlankSecs > 0 ? nominalVBlankSecs : frameSecs;
+			updateLock();
+		}
+		return 1;
+	}
+	assumeExpr(frameSecs > 0);
+	assumeExpr(vblankSecs > 0);
+	if(timestamp <= lastTimestamp)
+		return 0;
+	double intervalSecs = Base::frameTimeBaseToSecsDec(timestamp - lastTimestamp);
+	lastTimestamp = timestamp;
+	// snap the interval to whole vblanks so jitter in when this callback
+	// runs doesn't change how many frames are due
+	uint vblanks = std::max(std::lround(intervalSecs / vblankSecs), 1l);
+	if(vblanks > maxVBlankGap)
+	{
+		logMsg("%.3fs since last frame, restarting schedule", intervalSecs);
+		pendingFrames = 0;
+		return 1;
+	}
+	updateVBlankEstimate(intervalSecs / vblanks);
+	if(lockedVBlankFrames)
+		pendingFrames += vblanks * lockedVBlankFrames;
+	else
+		pendingFrames += vblanks * vblankSecs / frameSecs;
+	// small bias so a sum like 0.5 + 0.5 isn't rounded down
+	uint frames = pendingFrames + 1e-6;
+	pendingFrames = std::max(pendingFrames - frames, 0.);
+	return frames;
+}
+
+uint EmuFramePacer::maxFrameSkip() const
+{
+	auto costNSecs = frameCostNSecs.load(std::memory_order_relaxed);
+	if(!costNSecs || !vblankSecs)
+		return maxFrameSkipLimit;
+	int framesInBudget = vblankSecs * frameBudget * 1e9 / costNSecs;
+	// always allow one skipped frame so a system too slow to run full speed
+	// still alternates instead of falling further behind every vblank
+	return std::clamp(framesInBudget - 1, 1, (int)maxFrameSkipLimit);
+}
+
+void EmuFramePacer::addFrameCost(IG::Time time, uint frames)
+{
+	if(!frames)
+		return;
+	uint64_t nSecs = time.nSecs() / frames;
+	auto avgNSecs = frameCostNSecs.load(std::memory_order_relaxed);
+	avgNSecs = avgNSecs ? (avgNSecs * 7 + nSecs) / 8 : nSecs;
+	frameCostNSecs.store(avgNSecs, std::memory_order_relaxed);
+}
+
+void EmuFramePacer::updateVBlankEstimate(double intervalSecs)
+{
+	if(std::abs(intervalSecs - vblankSecs) > vblankSecs * maxVBlankDeviation)
+	{
+		outlierSecs += intervalSecs;
+		if(++outlierSamples < maxOutlierSamples)
+			return;
+		// restart from the average of the rejected intervals
+		intervalSecs = outlierSecs / outlierSamples;
+		logMsg("vblank estimate %.3fms disagrees with measured intervals, restarting from %.3fms",
+			vblankSecs * 1000., intervalSecs * 1000.);
+		vblankSamples = 0;
+	}
+	outlierSamples = 0;
+	outlierSecs = 0;
+	vblankSamples = std::min(vblankSamples + 1, filterSamples);
+	vblankSecs += (intervalSecs - vblankSecs) / vblankSamples;
+	updateLock();
+}
+
+static bool isNearInteger(double val, uint &intVal)
+{
+	intVal = std::lround(val);
+	return intVal && std::abs(val / intVal - 1.) <= EmuAudioRateControl::maxRatioDelta;
+}
+
+void EmuFramePacer::updateLock()
+{
+	double prevLockedVBlankFrames = lockedVBlankFrames;
+	lockedVBlankFrames = 0;
+	// without rate control the audio output would drift by the same
+	// amount as the locked frame rate differs from the emulated one
+	if(optionAudioRateControl && frameSecs && vblankSecs)
+	{
+		// any difference from the exact emulated rate is absorbed by audio rate control
+		double framesPerVBlank = vblankSecs / frameSecs;
+		uint n;
+		if(framesPerVBlank >= 1. && isNearInteger(framesPerVBlank, n))
+			lockedVBlankFrames = n;
+		else if(framesPerVBlank < 1. && isNearInteger(1. / framesPerVBlank, n))
+			lockedVBlankFrames = 1. / n;
+	}
+	if(lockedVBlankFrames != prevLockedVBlankFrames)
+	{
+		if(lockedVBlankFrames)
+			logMsg("locked to %.3f frames per %.3fHz vblank", lockedVBlankFrames, 1. / vblankSecs);
+		else
+			logMsg("unlocked, %.3fHz vblank", 1. / vblankSecs);
+	}
+}
@@ -41,6 +41,7 @@ bool touchControlsAreOn = false;
 VControllerLayoutPosition vControllerLayoutPos[2][7];
 bool vControllerLayoutPosChanged = false;
 bool fastForwardActive = false;
+bool rewindActive = false;
 
 #ifdef CONFIG_VCONTROLS_GAMEPAD
 static Gfx::GC vControllerGCSize()
@@ -189,6 +190,20 @@ IG::Point2D<int> vControllerLayoutToPixelPos(VControllerLayoutPosition lPos)
 	return {x, y};
 }
 
+void queueInputAction(uint state, uint emuKey, Input::Time time)
+{
+	if(EmuSystem::handleUIInputAction(state, emuKey))
+		return;
+	if(!emuInputQueue.push(state, emuKey, time))
+	{
+		// frames aren't keeping up, apply what's queued now so nothing is lost
+		logMsg("input queue full, flushing");
+		emuThread.waitForIdle();
+		emuInputQueue.poll();
+		emuInputQueue.push(state, emuKey, time);
+	}
+}
+
 void processRelPtr(Input::Event e)
 {
 	using namespace IG;
@@ -196,7 +211,7 @@ void processRelPtr(Input::Event e)
 	{
 		//logMsg("reversed trackball X direction");
 		relPtr.x = e.pos().x;
-		EmuSystem::handleInputAction(Input::RELEASED, relPtr.xAction);
+		queueInputAction(Input::RELEASED, relPtr.xAction, e.time());
 	}
 	else
 		relPtr.x += e.pos().x;
@@ -204,14 +219,14 @@ void processRelPtr(Input::Event e)
 	if(e.pos().x)
 	{
 		relPtr.xAction = EmuSystem::translateInputAction(e.pos().x > 0 ? EmuControls::systemKeyMapStart+1 : EmuControls::systemKeyMapStart+3);
-		EmuSystem::handleInputAction(Input::PUSHED, relPtr.xAction);
+		queueInputAction(Input::PUSHED, relPtr.xAction, e.time());
 	}
 
 	if(relPtr.y != 0 && sign(relPtr.y) != sign(e.pos().y))
 	{
 		//logMsg("reversed trackball Y direction");
 		relPtr.y = e.pos().y;
-		EmuSystem::handleInputAction(Input::RELEASED, relPtr.yAction);
+		queueInputAction(Input::RELEASED, relPtr.yAction, e.time());
 	}
 	else
 		relPtr.y += e.pos().y;
@@ -219,7 +234,7 @@ void processRelPtr(Input::Event e)
 	if(e.pos().y)
 	{
 		relPtr.yAction = EmuSystem::translateInputAction(e.pos().y > 0 ? EmuControls::systemKeyMapStart+2 : EmuControls::systemKeyMapStart);
-		EmuSystem::handleInputAction(Input::PUSHED, relPtr.yAction);
+		queueInputAction(Input::PUSHED, relPtr.yAction, e.time());
 	}
 
 	//logMsg("trackball event %d,%d, rel ptr %d,%d", e.x, e.y, relPtr.x, relPtr.y);
@@ -230,6 +245,7 @@ void commonInitInput()
 	relPtr = {};
 	turboActions = {};
 	fastForwardActive = false;
+	rewindActive = false;
 }
 
 void commonUpdateInput()
@@ -245,12 +261,12 @@ void commonUpdateInput()
 			if(turboClock == 0)
 			{
 				//logMsg("turbo push for player %d, action %d", e.player, e.action);
-				EmuSystem::handleInputAction(Input::PUSHED, e.action);
+				queueInputAction(Input::PUSHED, e.action, {});
 			}
 			else if(turboClock == turboFrames/2)
 			{
 				//logMsg("turbo release for player %d, action %d", e.player, e.action);
-				EmuSystem::handleInputAction(Input::RELEASED, e.action);
+				queueInputAction(Input::RELEASED, e.action, {});
 			}
 		}
 	}
@@ -268,13 +284,13 @@ void commonUpdateInput()
 	{
 		relPtr.x = applyRelPointerDecel(relPtr.x);
 		if(!relPtr.x)
-			EmuSystem::handleInputAction(Input::RELEASED, relPtr.xAction);
+			queueInputAction(Input::RELEASED, relPtr.xAction, {});
 	}
 	if(relPtr.y)
 	{
 		relPtr.y = applyRelPointerDecel(relPtr.y);
 		if(!relPtr.y)
-			EmuSystem::handleInputAction(Input::RELEASED, relPtr.yAction);
+			queueInputAction(Input::RELEASED, relPtr.yAction, {});
 	}
 #endif
 }
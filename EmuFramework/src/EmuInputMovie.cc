@@ -0,0 +1,306 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "InputMovie"
+#include <emuframework/EmuInputMovie.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/algorithm.h>
+#include <imagine/util/string.h>
+#include <algorithm>
+#include <array>
+#include "private.hh"
+
+// File format: magic, version, start type, frame count, start state & the
+// event stream, with the state & stream prefixed by their 32-bit sizes.
+// The stream holds one record per frame with input, skipping frames with
+// none: the frames since the previous record, the action count, then each
+// action as the emuKey shifted left once with the low bit set if pushed.
+// All three are stored as LEB128 varints.
+
+static constexpr std::array<char, 6> fileMagic{'E', 'M', 'U', 'M', 'O', 'V'};
+static constexpr uint8 fileVersion = 1;
+
+static void writeVarint(std::vector<uint8> &out, uint64_t val)
+{
+	while(val >= 0x80)
+	{
+		out.push_back((val & 0x7F) | 0x80);
+		val >>= 7;
+	}
+	out.push_back(val);
+}
+
+static bool readVarint(const std::vector<uint8> &in, size_t &pos, uint64_t &val)
+{
+	val = 0;
+	for(uint shift = 0; pos != in.size() && shift < 64; shift += 7)
+	{
+		uint8 b = in[pos++];
+		val |= uint64_t(b & 0x7F) << shift;
+		if(!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+EmuSystem::Error EmuInputMovie::startRecording(const char *path, Start start)
+{
+	if(!EmuSystem::gameIsRunning())
+	{
+		return EmuSystem::makeError("System not running");
+	}
+	stop();
+	emuThread.waitForIdle();
+	this->start = start;
+	if(start == Start::STATE)
+	{
+		if(auto err = EmuSystem::saveState(startState);
+			err)
+		{
+			return err;
+		}
+	}
+	else
+		startState.clear();
+	// begin from the same restored state playback will use
+	if(auto err = restoreStart();
+		err)
+	{
+		return err;
+	}
+	string_copy(this->path, path);
+	events.clear();
+	frameActions.clear();
+	frame = lastEventFrame = 0;
+	unloggedInputWarned = false;
+	mode = Mode::RECORD;
+	logMsg("recording to %s", path);
+	return {};
+}
+
+EmuSystem::Error EmuInputMovie::startPlayback(const char *path)
+{
+	if(!EmuSystem::gameIsRunning())
+	{
+		return EmuSystem::makeError("System not running");
+	}
+	stop();
+	emuThread.waitForIdle();
+	FileIO file{};
+	if(file.open(path))
+	{
+		return EmuSystem::makeError("Error opening movie");
+	}
+	std::array<char, fileMagic.size()> magic{};
+	if(file.read(magic.data(), magic.size()) != (ssize_t)magic.size() || magic != fileMagic
+		|| file.readVal<uint8>() != fileVersion)
+	{
+		return EmuSystem::makeError("Unknown movie format");
+	}
+	std::error_code ec{};
+	auto startType = file.readVal<uint8>(&ec);
+	totalFrames = file.readVal<uint32>(&ec);
+	auto stateSize = file.readVal<uint32>(&ec);
+	if(ec || startType > (uint8)Start::STATE || (startType == (uint8)Start::STATE && !stateSize)
+		|| !startState.resize(stateSize)
+		|| (stateSize && file.read(startState.data(), stateSize) != (ssize_t)stateSize))
+	{
+		return EmuSystem::makeFileReadError();
+	}
+	start = (Start)startType;
+	auto eventsSize = file.readVal<uint32>(&ec);
+	if(ec)
+	{
+		return EmuSystem::makeFileReadError();
+	}
+	events.resize(eventsSize);
+	if(eventsSize && file.read(events.data(), eventsSize) != (ssize_t)eventsSize)
+	{
+		return EmuSystem::makeFileReadError();
+	}
+	if(auto err = restoreStart();
+		err)
+	{
+		return err;
+	}
+	heldKeys.clear();
+	readPos = 0;
+	frame = lastEventFrame = 0;
+	readNextEventFrame();
+	mode = Mode::PLAY;
+	logMsg("playing %s, %u frames", path, totalFrames);
+	return {};
+}
+
+EmuSystem::Error EmuInputMovie::stop()
+{
+	if(!isActive())
+		return {};
+	emuThread.waitForIdle();
+	EmuSystem::Error err{};
+	if(isRecording())
+	{
+		// actions logged after the last frame never took effect
+		frameActions.clear();
+		err = write();
+		logMsg("stopped recording after %u frames", frame);
+		mode = Mode::OFF;
+	}
+	else if(isPlaying())
+	{
+		logMsg("stopped playback at frame %u of %u", frame, totalFrames);
+		endPlayback();
+	}
+	return err;
+}
+
+void EmuInputMovie::logAction(uint state, uint emuKey)
+{
+	frameActions.push_back({emuKey, state});
+}
+
+void EmuInputMovie::warnUnloggedInput()
+{
+	if(unloggedInputWarned)
+		return;
+	unloggedInputWarned = true;
+	logWarn("unlogged pointer input at frame %u, movie won't replay it", frame);
+	EmuApp::postMessage(4, true, "Light gun & mouse input isn't recorded in input movies");
+}
+
+void EmuInputMovie::nextFrame()
+{
+	if(isRecording())
+	{
+		if(frameActions.size())
+		{
+			writeVarint(events, frame - lastEventFrame);
+			writeVarint(events, frameActions.size());
+			for(auto a : frameActions)
+			{
+				writeVarint(events, (uint64_t)a.emuKey << 1 | (a.state == Input::PUSHED));
+			}
+			lastEventFrame = frame;
+			frameActions.clear();
+		}
+		frame++;
+	}
+	else if(isPlaying())
+	{
+		if(frame == totalFrames)
+		{
+			logMsg("playback finished");
+			endPlayback();
+			return;
+		}
+		if(frame == nextEventFrame)
+		{
+			uint64_t count;
+			if(!readVarint(events, readPos, count))
+			{
+				logErr("movie truncated at frame %u", frame);
+				endPlayback();
+				return;
+			}
+			iterateTimes(count, i)
+			{
+				uint64_t action;
+				if(!readVarint(events, readPos, action))
+				{
+					logErr("movie truncated at frame %u", frame);
+					break;
+				}
+				uint emuKey = action >> 1;
+				bool pushed = action & 1;
+				auto held = std::find(heldKeys.begin(), heldKeys.end(), emuKey);
+				if(pushed && held == heldKeys.end())
+					heldKeys.push_back(emuKey);
+				else if(!pushed && held != heldKeys.end())
+					heldKeys.erase(held);
+				EmuSystem::handleInputAction(pushed ? Input::PUSHED : Input::RELEASED, emuKey);
+			}
+			lastEventFrame = frame;
+			readNextEventFrame();
+		}
+		frame++;
+	}
+}
+
+EmuSystem::Error EmuInputMovie::restoreStart()
+{
+	if(start == Start::STATE)
+	{
+		if(auto err = EmuSystem::loadState(startState);
+			err)
+		{
+			return err;
+		}
+	}
+	else
+		EmuSystem::reset(EmuSystem::RESET_HARD);
+	emuInputQueue.clear();
+	return {};
+}
+
+EmuSystem::Error EmuInputMovie::write()
+{
+	FileIO file{};
+	if(file.create(path.data()))
+	{
+		logErr("error creating %s", path.data());
+		return EmuSystem::makeFileWriteError();
+	}
+	std::error_code ec{};
+	file.write(fileMagic.data(), fileMagic.size(), &ec);
+	file.writeVal(fileVersion, &ec);
+	file.writeVal((uint8)start, &ec);
+	file.writeVal((uint32)frame, &ec);
+	file.writeVal((uint32)startState.size(), &ec);
+	file.write(startState.data(), startState.size(), &ec);
+	file.writeVal((uint32)events.size(), &ec);
+	file.write(events.data(), events.size(), &ec);
+	if(ec)
+	{
+		logErr("error writing %s", path.data());
+		return EmuSystem::makeFileWriteError();
+	}
+	logMsg("wrote %u frames, %zu bytes of input", frame, events.size());
+	return {};
+}
+
+bool EmuInputMovie::readNextEventFrame()
+{
+	uint64_t frames;
+	if(!readVarint(events, readPos, frames))
+	{
+		// no more input, run until totalFrames
+		nextEventFrame = ~0u;
+		return false;
+	}
+	nextEventFrame = lastEventFrame + frames;
+	return true;
+}
+
+void EmuInputMovie::endPlayback()
+{
+	mode = Mode::OFF;
+	// don't leave recorded input held after the movie
+	for(auto emuKey : heldKeys)
+	{
+		EmuSystem::handleInputAction(Input::RELEASED, emuKey);
+	}
+	heldKeys.clear();
+}
@@ -0,0 +1,61 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <emuframework/EmuInputQueue.hh>
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuInputMovie.hh>
+#include "private.hh"
+
+EmuInputQueue::EmuInputQueue()
+{
+	events.init(capacity * sizeof(Event));
+}
+
+bool EmuInputQueue::push(uint state, uint emuKey, Input::Time time)
+{
+	if(events.freeSpace() < sizeof(Event))
+		return false;
+	Event e{time, emuKey, state};
+	events.write(&e, sizeof(e));
+	return true;
+}
+
+void EmuInputQueue::poll()
+{
+	while(events.writtenSize() >= sizeof(Event))
+	{
+		Event e;
+		events.read(&e, sizeof(e));
+		if(emuInputMovie.isPlaying())
+			continue;
+		if(e.time.nSecs())
+			lastEventTime_ = e.time;
+		if(emuInputMovie.isRecording())
+			emuInputMovie.logAction(e.state, e.emuKey);
+		EmuSystem::handleInputAction(e.state, e.emuKey);
+	}
+}
+
+void EmuInputQueue::startFrame()
+{
+	poll();
+	if(emuInputMovie.isActive())
+		emuInputMovie.nextFrame();
+}
+
+void EmuInputQueue::clear()
+{
+	events.reset();
+}
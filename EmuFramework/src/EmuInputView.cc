@@ -43,6 +43,7 @@ void EmuInputView::resetInput()
 	vController.resetInput();
 	#endif
 	ffKeyPushed = ffToggleActive = false;
+	rewindActive = false;
 }
 
 void EmuInputView::updateFastforward()
@@ -50,6 +51,21 @@ void EmuInputView::updateFastforward()
 	fastForwardActive = ffKeyPushed || ffToggleActive;
 }
 
+#ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
+// pointer devices like light guns are applied by the core directly instead
+// of through the action queue, so input movies can't log or replay them
+static bool handleCorePointerInput(Input::Event e)
+{
+	if(emuInputMovie.isPlaying())
+		return false;
+	if(!EmuSystem::handlePointerInputEvent(e, emuVideoLayer.gameRect()))
+		return false;
+	if(emuInputMovie.isRecording())
+		emuInputMovie.warnUnloggedInput();
+	return true;
+}
+#endif
+
 bool EmuInputView::inputEvent(Input::Event e)
 {
 	#ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
@@ -71,9 +87,9 @@ bool EmuInputView::inputEvent(Input::Event e)
 			|| vController.isInKeyboardMode())
 		{
 			vController.applyInput(e);
-			EmuSystem::handlePointerInputEvent(e, emuVideoLayer.gameRect());
+			handleCorePointerInput(e);
 		}
-		else if(EmuSystem::handlePointerInputEvent(e, emuVideoLayer.gameRect()))
+		else if(handleCorePointerInput(e))
 		{
 			//logMsg("game consumed pointer input event");
 		}
@@ -242,6 +258,12 @@ bool EmuInputView::inputEvent(Input::Event e)
 						return true;
 					}
 
+					bcase guiKeyIdxRewind:
+					{
+						rewindActive = e.pushed() && emuRewind.isEnabled() && !emuInputMovie.isActive();
+						logMsg("rewind key state: %d", e.pushed());
+					}
+
 					bdefault:
 					{
 						//logMsg("action %d, %d", emuKey, state);
@@ -259,7 +281,7 @@ bool EmuInputView::inputEvent(Input::Event e)
 								turboActions.removeEvent(sysAction);
 							}
 						}
-						EmuSystem::handleInputAction(e.state(), sysAction);
+						queueInputAction(e.state(), sysAction, e.time());
 					}
 				}
 			}
@@ -0,0 +1,385 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Library"
+#include <emuframework/EmuLibrary.hh>
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuApp.hh>
+#include <imagine/base/Base.hh>
+#include <imagine/fs/FS.hh>
+#include <imagine/fs/ArchiveFS.hh>
+#include <imagine/io/FileIO.hh>
+#include <imagine/thread/Thread.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/string.h>
+#include <array>
+#include <vector>
+#include <cstring>
+#include "private.hh"
+
+static constexpr std::array<char, 6> fileMagic{'E', 'M', 'U', 'L', 'I', 'B'};
+static constexpr uint8 fileVersion = 2;
+// smallest entry in the index file: an empty path & strings plus the fixed fields
+static constexpr size_t minEntryBytes = 2 + 8 + 8 + 4 + 1 + 2 * 3;
+
+[[gnu::weak]] void EmuSystem::readLibraryMetadata(IO &io, EmuLibraryEntry &entry) {}
+
+static FS::PathString libraryPath()
+{
+	if(Base::documentsPathIsShared())
+		return FS::makePathStringPrintf("%s/explusalpha.com/%s.library", Base::documentsPath().data(), EmuSystem::shortSystemName());
+	else
+		return FS::makePathStringPrintf("%s/library", Base::documentsPath().data());
+}
+
+static bool readString(IO &io, std::string &str)
+{
+	std::error_code ec{};
+	auto len = io.readVal<uint16>(&ec);
+	if(ec)
+		return false;
+	str.resize(len);
+	return io.read(&str[0], len) == len;
+}
+
+static void writeString(IO &io, const std::string &str)
+{
+	uint16 len = std::min(str.size(), (size_t)UINT16_MAX);
+	io.writeVal(len, nullptr);
+	io.write(str.data(), len);
+}
+
+void EmuLibrary::load()
+{
+	auto path = libraryPath();
+	FileIO file{};
+	if(file.open(path.data()))
+	{
+		logMsg("no library index");
+		return;
+	}
+	std::array<char, fileMagic.size()> magic{};
+	if(file.read(magic.data(), magic.size()) != (ssize_t)magic.size() || magic != fileMagic
+		|| file.readVal<uint8>() != fileVersion)
+	{
+		logWarn("ignoring unknown library index format");
+		return;
+	}
+	auto count = file.readVal<uint32>();
+	// don't trust the count for the allocation, a damaged file can't
+	// hold more entries than fit in its size
+	size_t maxCount = file.size() / minEntryBytes;
+	if(count > maxCount)
+	{
+		logWarn("library index claims %u entries, only room for %zu", count, maxCount);
+		count = maxCount;
+	}
+	std::lock_guard<std::mutex> lock{mutex};
+	entries.reserve(count);
+	iterateTimes(count, i)
+	{
+		std::string entryPath{};
+		EmuLibraryEntry entry{};
+		std::error_code ec{};
+		if(!readString(file, entryPath))
+			break;
+		entry.size = file.readVal<uint64_t>(&ec);
+		entry.mtime = file.readVal<int64_t>(&ec);
+		entry.crc32 = file.readVal<uint32>(&ec);
+		entry.region = (EmuLibraryEntry::Region)file.readVal<uint8>(&ec);
+		if(ec || !readString(file, entry.system) || !readString(file, entry.title)
+			|| !readString(file, entry.archiveMember))
+		{
+			logErr("library index truncated at entry %u", i);
+			break;
+		}
+		entries.insert_or_assign(std::move(entryPath), std::move(entry));
+	}
+	logMsg("loaded %zu library entries", entries.size());
+}
+
+void EmuLibrary::save()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+	if(!changed)
+		return;
+	auto path = libraryPath();
+	FileIO file{};
+	if(file.create(path.data()))
+	{
+		logErr("error creating %s", path.data());
+		return;
+	}
+	file.write(fileMagic.data(), fileMagic.size());
+	file.writeVal(fileVersion, nullptr);
+	file.writeVal((uint32)entries.size(), nullptr);
+	for(auto &[entryPath, entry] : entries)
+	{
+		writeString(file, entryPath);
+		file.writeVal(entry.size, nullptr);
+		file.writeVal(entry.mtime, nullptr);
+		file.writeVal(entry.crc32, nullptr);
+		file.writeVal((uint8)entry.region, nullptr);
+		writeString(file, entry.system);
+		writeString(file, entry.title);
+		writeString(file, entry.archiveMember);
+	}
+	changed = false;
+	logMsg("saved %zu library entries", entries.size());
+}
+
+std::optional<EmuLibraryEntry> EmuLibrary::entry(const char *path)
+{
+	auto status = FS::status(path);
+	std::lock_guard<std::mutex> lock{mutex};
+	auto it = entries.find(path);
+	if(it == entries.end() || it->second.size != status.size() || it->second.mtime != (int64_t)status.lastWriteTime())
+		return {};
+	return it->second;
+}
+
+void EmuLibrary::addFile(const char *path, uint32 crc32)
+{
+	if(crc32)
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		loadedCRC32.insert_or_assign(path, crc32);
+	}
+	queuePath(path);
+}
+
+void EmuLibrary::addDirectory(const char *path)
+{
+	// directories are queued with a trailing slash to tell them apart from files
+	queuePath(string_makePrintf<sizeof(FS::PathString)>("%s/", path).data());
+}
+
+void EmuLibrary::queuePath(const char *path)
+{
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		if(std::find(queue.begin(), queue.end(), path) != queue.end())
+			return;
+		queue.emplace_back(path);
+		if(!started)
+		{
+			started = true;
+			IG::makeDetachedThread(
+				[this]()
+				{
+					run();
+				});
+		}
+	}
+	workSem.notify();
+}
+
+void EmuLibrary::run()
+{
+	logMsg("started library indexing thread");
+	pruneMissingFiles();
+	while(1)
+	{
+		workSem.wait();
+		std::string path{};
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			if(queue.empty())
+				continue;
+			path = std::move(queue.front());
+			queue.pop_front();
+		}
+		if(path.back() == '/')
+		{
+			path.pop_back();
+			indexDirectory(path);
+		}
+		else
+			indexFile(path);
+	}
+}
+
+void EmuLibrary::pruneMissingFiles()
+{
+	std::vector<std::string> paths{};
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		paths.reserve(entries.size());
+		for(auto &[path, entry] : entries)
+		{
+			paths.emplace_back(path);
+		}
+	}
+	// check without the lock held so lookups aren't blocked on file system access
+	uint pruned = 0;
+	for(auto &path : paths)
+	{
+		if(FS::exists(path.c_str()))
+			continue;
+		std::lock_guard<std::mutex> lock{mutex};
+		entries.erase(path);
+		changed = true;
+		pruned++;
+	}
+	if(pruned)
+		logMsg("removed %u library entries of missing files", pruned);
+}
+
+static bool isGameFile(const char *name)
+{
+	return EmuSystem::defaultFsFilter(name)
+		|| (!EmuSystem::handlesArchiveFiles && EmuApp::hasArchiveExtension(name));
+}
+
+void EmuLibrary::indexDirectory(const std::string &path)
+{
+	std::error_code ec{};
+	uint files = 0;
+	for(auto &entry : FS::directory_iterator{path.c_str(), ec})
+	{
+		if(entry.type() != FS::file_type::regular || !isGameFile(entry.name()))
+			continue;
+		indexFile(FS::makePathString(path.c_str(), entry.name()).data());
+		files++;
+	}
+	logMsg("checked %u files in %s", files, path.c_str());
+}
+
+void EmuLibrary::indexFile(const std::string &path)
+{
+	std::error_code ec{};
+	auto status = FS::status(path.c_str(), ec);
+	if(ec || status.type() != FS::file_type::regular)
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		if(entries.erase(path))
+			changed = true;
+		return;
+	}
+	uint64_t size = status.size();
+	int64_t mtime = status.lastWriteTime();
+	uint32 crc32 = 0;
+	{
+		std::lock_guard<std::mutex> lock{mutex};
+		if(auto it = loadedCRC32.find(path);
+			it != loadedCRC32.end())
+		{
+			crc32 = it->second;
+			loadedCRC32.erase(it);
+		}
+		auto it = entries.find(path);
+		if(it != entries.end() && it->second.size == size && it->second.mtime == mtime)
+		{
+			if(crc32 && it->second.crc32 != crc32)
+			{
+				it->second.crc32 = crc32;
+				changed = true;
+			}
+			return;
+		}
+	}
+	EmuLibraryEntry entry{};
+	entry.size = size;
+	entry.mtime = mtime;
+	entry.crc32 = crc32;
+	auto name = FS::basename(path.c_str());
+	if(!EmuSystem::handlesArchiveFiles && EmuApp::hasArchiveExtension(name.data()))
+	{
+		for(auto &archEntry : FS::ArchiveIterator{path.c_str(), ec})
+		{
+			if(archEntry.type() == FS::file_type::directory || !EmuSystem::defaultFsFilter(archEntry.name()))
+				continue;
+			entry.crc32 = archEntry.crc32();
+			entry.archiveMember = archEntry.name();
+			auto io = archEntry.moveIO();
+			EmuSystem::readLibraryMetadata(io, entry);
+			break;
+		}
+		if(ec || entry.archiveMember.empty())
+		{
+			logMsg("no game found in archive %s", path.c_str());
+			return;
+		}
+		name = FS::makeFileString(entry.archiveMember.c_str());
+	}
+	else
+	{
+		FileIO file{};
+		if(file.open(path.c_str()))
+			return;
+		EmuSystem::readLibraryMetadata(file, entry);
+	}
+	if(entry.region == EmuLibraryEntry::Region::UNKNOWN)
+		entry.region = regionFromName(name.data());
+	if(entry.system.empty())
+		entry.system = EmuSystem::systemName();
+	if(entry.title.empty())
+		entry.title = EmuSystem::fullGameNameForPathDefaultImpl(name.data()).data();
+	logMsg("indexed %s: crc32:%08X system:%s region:%s title:%s", path.c_str(), entry.crc32,
+		entry.system.c_str(), regionName(entry.region), entry.title.c_str());
+	std::lock_guard<std::mutex> lock{mutex};
+	entries.insert_or_assign(path, std::move(entry));
+	changed = true;
+}
+
+EmuLibraryEntry::Region EmuLibrary::regionFromName(const char *name)
+{
+	using Region = EmuLibraryEntry::Region;
+	static constexpr struct { const char *tag; Region region; } tags[]
+	{
+		{"(World)", Region::WORLD}, {"(W)", Region::WORLD},
+		{"(USA", Region::USA}, {"(U)", Region::USA}, {"(US)", Region::USA},
+		{"(Europe", Region::EUROPE}, {"(E)", Region::EUROPE}, {"(EU)", Region::EUROPE}, {"(PAL)", Region::EUROPE},
+		{"(Japan", Region::JAPAN}, {"(J)", Region::JAPAN}, {"(JP)", Region::JAPAN},
+		{"(UE)", Region::WORLD}, {"(JU)", Region::WORLD}, {"(JUE)", Region::WORLD},
+		{"(F)", Region::EUROPE}, {"(G)", Region::EUROPE}, {"(I)", Region::EUROPE}, {"(S)", Region::EUROPE},
+		{"(K)", Region::OTHER}, {"(Korea)", Region::OTHER}, {"(Brazil)", Region::OTHER}, {"(RU)", Region::OTHER},
+	};
+	for(auto &t : tags)
+	{
+		if(strstr(name, t.tag))
+			return t.region;
+	}
+	return Region::UNKNOWN;
+}
+
+std::string EmuLibrary::titleFromHeader(const char *field, size_t size)
+{
+	size_t len = 0;
+	while(len < size && field[len])
+		len++;
+	while(len && field[len - 1] == ' ')
+		len--;
+	for(size_t i = 0; i < len; i++)
+	{
+		if(field[i] < 0x20 || field[i] > 0x7E)
+			return {};
+	}
+	return {field, len};
+}
+
+const char *EmuLibrary::regionName(EmuLibraryEntry::Region region)
+{
+	using Region = EmuLibraryEntry::Region;
+	switch(region)
+	{
+		case Region::USA: return "USA";
+		case Region::EUROPE: return "Europe";
+		case Region::JAPAN: return "Japan";
+		case Region::WORLD: return "World";
+		case Region::OTHER: return "Other";
+		default: return "Unknown";
+	}
+}
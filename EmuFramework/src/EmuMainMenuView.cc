@@ -61,6 +61,7 @@ public:
 			[this](TextMenuItem &, View &view, Input::Event e)
 			{
 				dismiss();
+				emuInputMovie.stop();
 				EmuSystem::reset(EmuSystem::RESET_SOFT);
 				startGameFromMenu();
 			}
@@ -71,6 +72,7 @@ public:
 			[this](TextMenuItem &, View &view, Input::Event e)
 			{
 				dismiss();
+				emuInputMovie.stop();
 				EmuSystem::reset(EmuSystem::RESET_HARD);
 				startGameFromMenu();
 			}
@@ -89,6 +91,95 @@ protected:
 	TextMenuItem soft, hard, cancel;
 };
 
+static FS::PathString inputMoviePath()
+{
+	return FS::makePathStringPrintf("%s/%s.movie", EmuSystem::savePath(), EmuSystem::gameName().data());
+}
+
+class InputMovieAlertView : public BaseAlertView
+{
+public:
+	InputMovieAlertView(ViewAttachParams attach, const char *label):
+		BaseAlertView(attach, label,
+			[this](const TableView &)
+			{
+				return hasMovie ? 4 : 3;
+			},
+			[this](const TableView &, int idx) -> MenuItem&
+			{
+				if(!hasMovie && idx >= 2)
+					idx++;
+				switch(idx)
+				{
+					default: bug_unreachable("idx == %d", idx); [[fallthrough]];
+					case 0: return recordPowerOn;
+					case 1: return recordState;
+					case 2: return play;
+					case 3: return cancel;
+				}
+			}),
+		recordPowerOn
+		{
+			"Record From Power On",
+			[this](TextMenuItem &, View &view, Input::Event e)
+			{
+				dismiss();
+				startRecording(EmuInputMovie::Start::POWER_ON);
+			}
+		},
+		recordState
+		{
+			"Record From Current State",
+			[this](TextMenuItem &, View &view, Input::Event e)
+			{
+				dismiss();
+				startRecording(EmuInputMovie::Start::STATE);
+			}
+		},
+		play
+		{
+			"Play Recording",
+			[this](TextMenuItem &, View &view, Input::Event e)
+			{
+				dismiss();
+				if(auto err = emuInputMovie.startPlayback(inputMoviePath().data());
+					err)
+				{
+					popup.printf(4, true, "Input Movie: %s", err->what());
+				}
+				else
+					startGameFromMenu();
+			}
+		},
+		cancel
+		{
+			"Cancel",
+			[this](TextMenuItem &, View &view, Input::Event e)
+			{
+				dismiss();
+			}
+		},
+		hasMovie{FS::exists(inputMoviePath())}
+	{
+		recordState.setActive(EmuSystem::hasMemoryStates);
+	}
+
+protected:
+	TextMenuItem recordPowerOn, recordState, play, cancel;
+	bool hasMovie;
+
+	static void startRecording(EmuInputMovie::Start start)
+	{
+		if(auto err = emuInputMovie.startRecording(inputMoviePath().data(), start);
+			err)
+		{
+			popup.printf(4, true, "Input Movie: %s", err->what());
+		}
+		else
+			startGameFromMenu();
+	}
+};
+
 char saveSlotChar(int slot)
 {
 	switch(slot)
@@ -188,6 +279,7 @@ void EmuMainMenuView::onShow()
 	recentGames.setActive(recentGameList.size());
 	cheats.setActive(EmuSystem::gameIsRunning());
 	reset.setActive(EmuSystem::gameIsRunning());
+	inputMovie.setActive(EmuSystem::gameIsRunning());
 	saveState.setActive(EmuSystem::gameIsRunning());
 	loadState.setActive(EmuSystem::gameIsRunning() && EmuSystem::stateExists(EmuSystem::saveStateSlot));
 	stateSlotText[12] = saveSlotChar(EmuSystem::saveStateSlot);
@@ -220,6 +312,7 @@ void EmuMainMenuView::loadStandardItems()
 	item.emplace_back(&reset);
 	item.emplace_back(&loadState);
 	item.emplace_back(&saveState);
+	item.emplace_back(&inputMovie);
 	stateSlotText[12] = saveSlotChar(EmuSystem::saveStateSlot);
 	item.emplace_back(&stateSlot);
 	if(!Config::MACHINE_IS_OUYA)
@@ -243,6 +336,10 @@ void EmuMainMenuView::loadStandardItems()
 	#endif
 	item.emplace_back(&benchmark);
 	item.emplace_back(&screenshot);
+	#ifdef CONFIG_PROFILER
+	item.emplace_back(&showFrameTimeGraph);
+	item.emplace_back(&exportProfilerTrace);
+	#endif
 	item.emplace_back(&about);
 	item.emplace_back(&exitApp);
 }
@@ -289,6 +386,7 @@ EmuMainMenuView::EmuMainMenuView(ViewAttachParams attach, bool customMenu):
 						[](TextMenuItem &, View &view, Input::Event e)
 						{
 							view.dismiss();
+							emuInputMovie.stop();
 							EmuSystem::reset(EmuSystem::RESET_SOFT);
 							startGameFromMenu();
 						});
@@ -321,6 +419,36 @@ EmuMainMenuView::EmuMainMenuView(ViewAttachParams attach, bool customMenu):
 			}
 		}
 	},
+	inputMovie
+	{
+		"Input Movie",
+		[this](TextMenuItem &item, View &, Input::Event e)
+		{
+			if(!item.active() || !EmuSystem::gameIsRunning())
+				return;
+			if(emuInputMovie.isActive())
+			{
+				auto &ynAlertView = *new YesNoAlertView{attachParams(),
+					emuInputMovie.isRecording() ? "Stop & save input recording?" : "Stop input playback?"};
+				ynAlertView.setOnYes(
+					[](TextMenuItem &, View &view, Input::Event e)
+					{
+						view.dismiss();
+						if(auto err = emuInputMovie.stop();
+							err)
+						{
+							popup.printf(4, true, "Input Movie: %s", err->what());
+						}
+					});
+				modalViewController.pushAndShow(ynAlertView, e);
+			}
+			else
+			{
+				auto &movieAlertView = *new InputMovieAlertView{attachParams(), "Input Movie"};
+				modalViewController.pushAndShow(movieAlertView, e);
+			}
+		}
+	},
 	recentGames
 	{
 		"Recent Games",
@@ -569,6 +697,29 @@ EmuMainMenuView::EmuMainMenuView(ViewAttachParams attach, bool customMenu):
 			}
 		}
 	}
+	#ifdef CONFIG_PROFILER
+	,showFrameTimeGraph
+	{
+		"Frame Time Graph",
+		frameTimeGraph.isVisible(),
+		[](BoolMenuItem &item, View &view, Input::Event e)
+		{
+			frameTimeGraph.setVisible(item.flipBoolValue(view));
+		}
+	},
+	exportProfilerTrace
+	{
+		"Export Profiler Trace",
+		[](TextMenuItem &, View &, Input::Event e)
+		{
+			auto path = FS::makePathStringPrintf("%s/profiler-trace.json", Base::storagePath().data());
+			if(IG::Profiler::writeChromeTrace(path.data()))
+				popup.printf(3, false, "Wrote trace to:\n%s", path.data());
+			else
+				popup.printf(3, true, "Error writing trace to:\n%s", path.data());
+		}
+	}
+	#endif
 {
 	if(!customMenu)
 	{
@@ -48,6 +48,7 @@ bool optionOrientationIsValid(uint32 val)
 Byte1Option optionAutoSaveState(CFGKEY_AUTO_SAVE_STATE, 1);
 Byte1Option optionConfirmAutoLoadState(CFGKEY_CONFIRM_AUTO_LOAD_STATE, 1);
 Byte1Option optionSound(CFGKEY_SOUND, 1);
+Byte1Option optionAudioRateControl(CFGKEY_AUDIO_RATE_CONTROL, 1);
 
 #ifdef CONFIG_AUDIO_LATENCY_HINT
 Byte1Option optionSoundBuffers(CFGKEY_SOUND_BUFFERS,
@@ -94,6 +95,12 @@ Byte1Option optionHideStatusBar(CFGKEY_HIDE_STATUS_BAR, 1, (!Config::envIsAndroi
 OptionSwappedGamepadConfirm optionSwappedGamepadConfirm(CFGKEY_SWAPPED_GAMEPAD_CONFIM, Input::SWAPPED_GAMEPAD_CONFIRM_DEFAULT);
 Byte1Option optionConfirmOverwriteState(CFGKEY_CONFIRM_OVERWRITE_STATE, 1, 0);
 Byte1Option optionFastForwardSpeed(CFGKEY_FAST_FORWARD_SPEED, 4, 0, optionIsValidWithMinMax<2, 7>);
+Byte1Option optionEmuThread(CFGKEY_EMU_THREAD, 0, 0);
+// rewind history size in MiB, 0 disables rewind
+Byte1Option optionRewindMemory(CFGKEY_REWIND_MEMORY, 0, 0, optionIsValidWithMax<64>);
+Byte1Option optionRunAheadFrames(CFGKEY_RUN_AHEAD, 0, 0, optionIsValidWithMax<EmuRunAhead::maxFrames>);
+// archive extraction cache size in units of 128MiB, 0 disables the cache
+Byte1Option optionArchiveCacheSize(CFGKEY_ARCHIVE_CACHE_SIZE, 0, 0, optionIsValidWithMax<32>);
 #ifdef CONFIG_INPUT_DEVICE_HOTSWAP
 Byte1Option optionNotifyInputDeviceChange(CFGKEY_NOTIFY_INPUT_DEVICE_CHANGE, Config::Input::DEVICE_HOTSWAP, !Config::Input::DEVICE_HOTSWAP);
 #endif
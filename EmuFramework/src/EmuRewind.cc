@@ -0,0 +1,376 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Rewind"
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuRewind.hh>
+#include <imagine/logger/logger.h>
+#include <algorithm>
+#include <zlib.h>
+
+// Delta format: a sequence of (zero run length, literal length, literal bytes)
+// with lengths stored as LEB128 varints. Literals are the XOR of both states
+// and absorb short runs of matching bytes so tokens don't get too small.
+// Deltas are then deflated at the fastest level, which mostly shrinks the
+// literals, and kept as-is if that doesn't save anything.
+
+static constexpr uint minZeroRun = 8;
+// streams are kept between snapshots so zlib's state isn't re-allocated each time
+static z_stream deflateStream{};
+static z_stream inflateStream{};
+static bool hasDeflateStream = false, hasInflateStream = false;
+
+static uint8 *writeVarint(uint8 *out, size_t val)
+{
+	while(val >= 0x80)
+	{
+		*out++ = (val & 0x7F) | 0x80;
+		val >>= 7;
+	}
+	*out++ = val;
+	return out;
+}
+
+static const uint8 *readVarint(const uint8 *in, const uint8 *end, size_t &val)
+{
+	val = 0;
+	uint shift = 0;
+	while(in != end)
+	{
+		uint8 b = *in++;
+		val |= size_t(b & 0x7F) << shift;
+		if(!(b & 0x80))
+			break;
+		shift += 7;
+	}
+	return in;
+}
+
+static size_t maxEncodedSize(size_t len)
+{
+	// at most one token per minZeroRun + 1 bytes, each with two varints
+	return len + (len / (minZeroRun + 1) + 1) * 2 * 10;
+}
+
+static size_t encodeDelta(const uint8 *a, const uint8 *b, size_t len, uint8 *out)
+{
+	auto outStart = out;
+	size_t i = 0;
+	while(i < len)
+	{
+		size_t zeroStart = i;
+		while(i + 8 <= len)
+		{
+			uint64 wa, wb;
+			memcpy(&wa, a + i, 8);
+			memcpy(&wb, b + i, 8);
+			if(wa != wb)
+				break;
+			i += 8;
+		}
+		while(i < len && a[i] == b[i])
+			i++;
+		size_t zeroRun = i - zeroStart;
+		if(i == len)
+		{
+			if(zeroRun)
+			{
+				out = writeVarint(out, zeroRun);
+				out = writeVarint(out, 0);
+			}
+			break;
+		}
+		size_t litStart = i;
+		while(i < len)
+		{
+			if(a[i] != b[i])
+			{
+				i++;
+				continue;
+			}
+			size_t j = i;
+			while(j < len && a[j] == b[j] && j - i < minZeroRun)
+				j++;
+			if(j - i >= minZeroRun || j == len)
+				break;
+			i = j;
+		}
+		out = writeVarint(out, zeroRun);
+		out = writeVarint(out, i - litStart);
+		for(size_t k = litStart; k < i; k++)
+		{
+			*out++ = a[k] ^ b[k];
+		}
+	}
+	return out - outStart;
+}
+
+static void applyDelta(const uint8 *delta, size_t deltaSize, uint8 *buff, size_t len)
+{
+	auto end = delta + deltaSize;
+	size_t i = 0;
+	while(delta != end)
+	{
+		size_t zeroRun, litLen;
+		delta = readVarint(delta, end, zeroRun);
+		delta = readVarint(delta, end, litLen);
+		i += zeroRun;
+		if(unlikely(i + litLen > len || litLen > size_t(end - delta)))
+		{
+			logErr("delta out of range");
+			return;
+		}
+		for(size_t k = 0; k < litLen; k++)
+		{
+			buff[i + k] ^= delta[k];
+		}
+		i += litLen;
+		delta += litLen;
+	}
+}
+
+static size_t compressDelta(const uint8 *delta, size_t deltaSize, uint8 *out, size_t outSize)
+{
+	if(!hasDeflateStream)
+	{
+		if(deflateInit(&deflateStream, Z_BEST_SPEED) != Z_OK)
+		{
+			logErr("error initializing deflate stream");
+			return 0;
+		}
+		hasDeflateStream = true;
+	}
+	else
+		deflateReset(&deflateStream);
+	deflateStream.next_in = (Bytef*)delta;
+	deflateStream.avail_in = deltaSize;
+	deflateStream.next_out = out;
+	deflateStream.avail_out = outSize;
+	if(deflate(&deflateStream, Z_FINISH) != Z_STREAM_END)
+		return 0;
+	return deflateStream.total_out;
+}
+
+static bool uncompressDelta(const uint8 *data, size_t size, uint8 *out, size_t outSize)
+{
+	if(!hasInflateStream)
+	{
+		if(inflateInit(&inflateStream) != Z_OK)
+		{
+			logErr("error initializing inflate stream");
+			return false;
+		}
+		hasInflateStream = true;
+	}
+	else
+		inflateReset(&inflateStream);
+	inflateStream.next_in = (Bytef*)data;
+	inflateStream.avail_in = size;
+	inflateStream.next_out = out;
+	inflateStream.avail_out = outSize;
+	return inflate(&inflateStream, Z_FINISH) == Z_STREAM_END && inflateStream.total_out == outSize;
+}
+
+static void deinitZStreams()
+{
+	if(hasDeflateStream)
+	{
+		deflateEnd(&deflateStream);
+		hasDeflateStream = false;
+	}
+	if(hasInflateStream)
+	{
+		inflateEnd(&inflateStream);
+		hasInflateStream = false;
+	}
+}
+
+static bool resizeZeroFilled(IG::ByteBuffer &buff, size_t size)
+{
+	auto oldSize = buff.size();
+	if(!buff.resize(size))
+		return false;
+	if(size > oldSize)
+		memset(buff.data() + oldSize, 0, size - oldSize);
+	return true;
+}
+
+void EmuRewind::setMemoryBudget(size_t bytes)
+{
+	if(bytes == ring.size())
+		return;
+	reset();
+	ring.deinit();
+	if(!bytes)
+	{
+		prevState.deinit();
+		state.deinit();
+		delta.deinit();
+		packedDelta.deinit();
+		snapshot = {};
+		deinitZStreams();
+		return;
+	}
+	logMsg("allocating %zu bytes for rewind history", bytes);
+	if(!ring.resize(bytes))
+	{
+		logErr("out of memory for rewind history");
+		return;
+	}
+	snapshot.resize(maxSnapshots);
+}
+
+void EmuRewind::reset()
+{
+	head = count = 0;
+	writeOffset = 0;
+	frameCount = 0;
+	hasPrevState = false;
+}
+
+void EmuRewind::addFrames(uint frames)
+{
+	if(!isEnabled() || !EmuSystem::gameIsRunning())
+		return;
+	frameCount += frames;
+	if(frameCount < snapshotInterval)
+		return;
+	frameCount = 0;
+	capture();
+}
+
+void EmuRewind::capture()
+{
+	if(auto err = EmuSystem::saveState(state);
+		err)
+	{
+		logErr("error capturing state: %s", err->what());
+		return;
+	}
+	auto stateSize = state.size();
+	if(hasPrevState)
+	{
+		// delta restores prevState when XORed with state, both are zero
+		// padded to the same length in case the state size changed
+		auto prevStateSize = prevState.size();
+		auto len = std::max(stateSize, prevStateSize);
+		if(!resizeZeroFilled(state, len) || !resizeZeroFilled(prevState, len)
+			|| !delta.resize(maxEncodedSize(len)))
+		{
+			logErr("out of memory for rewind delta");
+			reset();
+			return;
+		}
+		delta.resize(encodeDelta(prevState.data(), state.data(), len, delta.data()));
+		size_t packedSize = 0;
+		if(packedDelta.resize(compressBound(delta.size())))
+			packedSize = compressDelta(delta.data(), delta.size(), packedDelta.data(), packedDelta.size());
+		if(packedSize && packedSize < delta.size())
+			push(packedDelta.data(), packedSize, delta.size(), prevStateSize);
+		else
+			push(delta.data(), delta.size(), delta.size(), prevStateSize);
+		state.resize(stateSize);
+	}
+	std::swap(prevState, state);
+	hasPrevState = true;
+}
+
+void EmuRewind::push(const uint8 *data, size_t size, size_t deltaSize, uint32 stateSize)
+{
+	if(size > ring.size())
+	{
+		logWarn("delta of %zu bytes exceeds history size", size);
+		head = count = 0;
+		writeOffset = 0;
+		return;
+	}
+	if(count == maxSnapshots)
+		popOldest();
+	if(writeOffset + size > ring.size())
+	{
+		// anything past the wrap point is older than what's at the start
+		while(count && oldest().offset >= writeOffset)
+			popOldest();
+		writeOffset = 0;
+	}
+	while(count && oldest().offset < writeOffset + size && oldest().offset + oldest().size > writeOffset)
+		popOldest();
+	memcpy(ring.data() + writeOffset, data, size);
+	snapshot[head] = {writeOffset, (uint32)size, (uint32)deltaSize, stateSize};
+	head = (head + 1) % maxSnapshots;
+	count++;
+	writeOffset += size;
+}
+
+EmuRewind::Snapshot &EmuRewind::oldest()
+{
+	assert(count);
+	return snapshot[(head + maxSnapshots - count) % maxSnapshots];
+}
+
+void EmuRewind::popOldest()
+{
+	assert(count);
+	count--;
+}
+
+EmuRewind::Snapshot EmuRewind::popNewest()
+{
+	assert(count);
+	head = (head + maxSnapshots - 1) % maxSnapshots;
+	count--;
+	auto &s = snapshot[head];
+	writeOffset = count ? s.offset : 0;
+	return s;
+}
+
+bool EmuRewind::stepBack()
+{
+	if(!hasPrevState)
+		return false;
+	frameCount = 0;
+	if(count)
+	{
+		auto s = popNewest();
+		auto len = std::max((size_t)s.stateSize, prevState.size());
+		if(!resizeZeroFilled(prevState, len))
+		{
+			reset();
+			return false;
+		}
+		const uint8 *deltaData = ring.data() + s.offset;
+		if(s.isPacked())
+		{
+			if(!delta.resize(s.deltaSize)
+				|| !uncompressDelta(deltaData, s.size, delta.data(), s.deltaSize))
+			{
+				logErr("error unpacking delta");
+				reset();
+				return false;
+			}
+			deltaData = delta.data();
+		}
+		applyDelta(deltaData, s.deltaSize, prevState.data(), len);
+		prevState.resize(s.stateSize);
+	}
+	if(auto err = EmuSystem::loadState(prevState);
+		err)
+	{
+		logErr("error restoring state: %s", err->what());
+		reset();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "RunAhead"
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuRunAhead.hh>
+#include <emuframework/EmuInputQueue.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/algorithm.h>
+#include "private.hh"
+
+void EmuRunAhead::setFrames(uint frames)
+{
+	// a state is saved & restored every frame, so only use
+	// systems that can do that without touching the filesystem
+	if(!EmuSystem::hasMemoryStates)
+		frames = 0;
+	frames = std::min(frames, maxFrames);
+	if(frames == frames_)
+		return;
+	logMsg("running %u frame(s) ahead", frames);
+	frames_ = frames;
+	if(!frames)
+		state.deinit();
+}
+
+void EmuRunAhead::runFrame(EmuVideo &video, bool renderGfx, bool renderAudio)
+{
+	emuInputQueue.startFrame();
+	if(!frames_)
+	{
+		EmuSystem::runFrame(video, renderGfx, true, renderAudio);
+		return;
+	}
+	// real frame, only its audio is output
+	EmuSystem::runFrame(video, false, false, renderAudio);
+	if(auto err = EmuSystem::saveState(state);
+		err)
+	{
+		logErr("error saving state, disabling run-ahead: %s", err->what());
+		setFrames(0);
+		return;
+	}
+	// input applied during the extra frames would be undone by the restore
+	emuInputQueue.setLatePolling(false);
+	iterateTimes(frames_ - 1, i)
+	{
+		EmuSystem::runFrame(video, false, false, false);
+	}
+	EmuSystem::runFrame(video, renderGfx, true, false);
+	emuInputQueue.setLatePolling(true);
+	if(auto err = EmuSystem::loadState(state);
+		err)
+	{
+		logErr("error restoring state, disabling run-ahead: %s", err->what());
+		setFrames(0);
+	}
+}
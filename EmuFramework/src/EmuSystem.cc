@@ -18,13 +18,16 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/FileUtils.hh>
 #include <emuframework/FilePicker.hh>
+#include <emuframework/EmuAudioRateControl.hh>
 #include <imagine/fs/ArchiveFS.hh>
+#include <imagine/io/FileIO.hh>
 #include <imagine/audio/Audio.hh>
 #include <imagine/util/utility.h>
 #include <imagine/util/math/int.hh>
 #include <imagine/util/ScopeGuard.hh>
 #include <algorithm>
 #include <string>
+#include <zlib.h>
 #include "private.hh"
 
 EmuSystem::State EmuSystem::state = EmuSystem::State::OFF;
@@ -36,14 +39,13 @@ FS::PathString EmuSystem::gameSavePath_{};
 FS::FileString EmuSystem::gameName_{};
 FS::FileString EmuSystem::fullGameName_{};
 FS::FileString EmuSystem::originalGameName_{};
-Base::FrameTimeBase EmuSystem::startFrameTime = 0;
-Base::FrameTimeBase EmuSystem::timePerVideoFrame = 0;
-uint EmuSystem::emuFrameNow = 0;
+uint32 EmuSystem::gameCRC32_ = 0;
 bool EmuSystem::runFrameOnDraw = false;
 int EmuSystem::saveStateSlot = 0;
 Audio::PcmFormat EmuSystem::pcmFormat = {44100, Audio::SampleFormats::s16, 2};
 uint EmuSystem::audioFramesPerVideoFrame = 0;
 Base::Timer EmuSystem::autoSaveStateTimer;
+static EmuAudioRateControl audioRateControl{};
 [[gnu::weak]] bool EmuSystem::inputHasKeyboard = false;
 [[gnu::weak]] bool EmuSystem::inputHasOptionsView = false;
 [[gnu::weak]] bool EmuSystem::hasBundledGames = false;
@@ -55,6 +57,7 @@ double EmuSystem::frameTimePAL = 1./50.;
 [[gnu::weak]] bool EmuSystem::handlesGenericIO = true;
 [[gnu::weak]] bool EmuSystem::hasCheats = false;
 [[gnu::weak]] bool EmuSystem::hasSound = true;
+[[gnu::weak]] bool EmuSystem::hasMemoryStates = false;
 [[gnu::weak]] int EmuSystem::forcedSoundRate = 0;
 [[gnu::weak]] bool EmuSystem::constFrameRate = false;
 
@@ -92,6 +95,7 @@ void EmuSystem::startSound()
 			Audio::setHintOutputLatency(wantedLatency);
 			#endif
 			Audio::openPcm(pcmFormat);
+			audioRateControl.reset();
 		}
 		else if(Audio::framesFree() <= (int)audioFramesPerVideoFrame)
 			Audio::resumePcm();
@@ -109,6 +113,20 @@ void EmuSystem::stopSound()
 
 void EmuSystem::writeSound(const void *samples, uint framesToWrite)
 {
+	IG_PROFILE_SCOPE("EmuSystem::writeSound");
+	if(unlikely(!Audio::isOpen()))
+	{
+		// samples are still generated when running headless, just discard them
+		return;
+	}
+	if(optionAudioRateControl && pcmFormat.sample.bits == 16
+		&& (uint)pcmFormat.channels <= EmuAudioRateControl::maxChannels)
+	{
+		uint framesOut;
+		samples = audioRateControl.resample((const int16*)samples, framesToWrite,
+			pcmFormat.channels, Audio::framesFree(), framesOut);
+		framesToWrite = framesOut;
+	}
 	Audio::writePcm(samples, framesToWrite);
 	if(!Audio::isPlaying() && Audio::framesFree() <= (int)audioFramesPerVideoFrame)
 	{
@@ -128,25 +146,6 @@ bool EmuSystem::shouldOverwriteExistingState()
 	return !optionConfirmOverwriteState || !EmuSystem::stateExists(EmuSystem::saveStateSlot);
 }
 
-uint EmuSystem::advanceFramesWithTime(Base::FrameTimeBase time)
-{
-	if(unlikely(!startFrameTime))
-	{
-		// first frame
-		startFrameTime = time;
-		emuFrameNow = 0;
-		return 1;
-	}
-	assumeExpr(timePerVideoFrame > 0);
-	assumeExpr(startFrameTime > 0);
-	assumeExpr(time > startFrameTime);
-	auto timeTotal = time - startFrameTime;
-	auto frameNow = IG::divRoundClosest(timeTotal, timePerVideoFrame);
-	auto elapsedEmuFrames = frameNow - emuFrameNow;
-	emuFrameNow = frameNow;
-	return elapsedEmuFrames;
-}
-
 void EmuSystem::setupGamePaths(const char *filePath)
 {
 	if(FS::exists(filePath))
@@ -284,6 +283,7 @@ void EmuSystem::clearGamePaths()
 	gameName_ = {};
 	fullGameName_ = {};
 	originalGameName_ = {};
+	gameCRC32_ = 0;
 	gamePath_ = {};
 	fullGamePath_ = {};
 	defaultSavePath_ = {};
@@ -317,6 +317,9 @@ void EmuSystem::closeGame(bool allowAutosaveState)
 {
 	if(gameIsRunning())
 	{
+		emuThread.waitForIdle();
+		emuRewind.reset();
+		emuInputMovie.stop();
 		if(Audio::isOpen())
 			Audio::clearPcm();
 		if(allowAutosaveState)
@@ -332,11 +335,12 @@ void EmuSystem::closeGame(bool allowAutosaveState)
 
 void EmuSystem::resetFrameTime()
 {
-	startFrameTime = 0;
+	emuFramePacer.reset();
 }
 
 void EmuSystem::pause()
 {
+	emuThread.waitForIdle();
 	if(isActive())
 		state = State::PAUSED;
 	stopSound();
@@ -346,12 +350,20 @@ void EmuSystem::pause()
 void EmuSystem::start()
 {
 	state = State::ACTIVE;
+	emuInputQueue.clear();
 	clearInputBuffers(emuInputView);
 	resetFrameTime();
 	startSound();
 	startAutoSaveStateTimer();
 }
 
+void EmuSystem::pollInput()
+{
+	// movies log & replay input per frame
+	if(emuInputQueue.latePollingEnabled() && !emuInputMovie.isActive())
+		emuInputQueue.poll();
+}
+
 IG::Time EmuSystem::benchmark()
 {
 	auto now = IG::Time::now();
@@ -378,8 +390,7 @@ void EmuSystem::configFrameTime()
 	pcmFormat.rate = optionSoundRate;
 	configAudioRate(frameTime(), optionSoundRate);
 	audioFramesPerVideoFrame = std::ceil(pcmFormat.rate * frameTime());
-	timePerVideoFrame = Base::frameTimeBaseFromSecs(frameTime());
-	resetFrameTime();
+	emuFramePacer.setFrameTime(frameTime());
 }
 
 void EmuSystem::configAudioPlayback()
@@ -489,6 +500,19 @@ EmuSystem::Error EmuSystem::loadGameFromPath(const char *pathStr, OnLoadProgress
 	return loadGameFromFile(io.makeGeneric(), path.data(), onLoadProgress);
 }
 
+// games up to this size are hashed for the library after loading when the
+// file is memory mapped, the core has just read it so it's already in memory
+static constexpr size_t maxHashedGameSize = 64 * 1024 * 1024;
+
+static uint32 mappedIOCRC32(IO &io)
+{
+	auto data = io.mmapConst();
+	auto size = io.size();
+	if(!data || size > maxHashedGameSize)
+		return 0;
+	return crc32(crc32(0, nullptr, 0), (const Bytef*)data, size);
+}
+
 EmuSystem::Error EmuSystem::loadGameFromFile(GenericIO file, const char *name, OnLoadProgressDelegate onLoadProgress)
 {
 	Error err;
@@ -497,6 +521,7 @@ EmuSystem::Error EmuSystem::loadGameFromFile(GenericIO file, const char *name, O
 		ArchiveIO io{};
 		std::error_code ec{};
 		FS::FileString originalName{};
+		uint32 crc32 = 0;
 		for(auto &entry : FS::ArchiveIterator{std::move(file), ec})
 		{
 			if(entry.type() == FS::file_type::directory)
@@ -508,6 +533,7 @@ EmuSystem::Error EmuSystem::loadGameFromFile(GenericIO file, const char *name, O
 			if(EmuSystem::defaultFsFilter(name))
 			{
 				string_copy(originalName, name);
+				crc32 = entry.crc32();
 				io = entry.moveIO();
 				break;
 			}
@@ -522,14 +548,37 @@ EmuSystem::Error EmuSystem::loadGameFromFile(GenericIO file, const char *name, O
 			//popup.postError("No recognized file extensions in archive");
 			return makeError("No recognized file extensions in archive");
 		}
+		FileIO cachedFile{};
+		if(emuArchiveCache.isEnabled())
+		{
+			cachedFile = emuArchiveCache.open(io, name, crc32, originalName.data(), ec);
+			if(ec)
+			{
+				logErr("error caching %s, loading it from the archive: %s", originalName.data(), ec.message().c_str());
+				// the failed extraction may have read part of the entry, so
+				// rewind it or re-open the archive if it can't seek
+				if(io.seekS(0) != 0)
+				{
+					io = FS::fileFromArchive(name, originalName.data());
+					if(!io)
+						return makeError("Error extracting from archive: %s", ec.message().c_str());
+				}
+			}
+		}
 		closeAndSetupNew(name);
 		originalGameName_ = originalName;
-		err = EmuSystem::loadGame(io, onLoadProgress);
+		if(cachedFile)
+			err = EmuSystem::loadGame(cachedFile, onLoadProgress);
+		else
+			err = EmuSystem::loadGame(io, onLoadProgress);
+		gameCRC32_ = crc32;
 	}
 	else
 	{
 		closeAndSetupNew(name);
 		err = EmuSystem::loadGame(file, onLoadProgress);
+		if(!err)
+			gameCRC32_ = mappedIOCRC32(file);
 	}
 	if(err)
 	{
@@ -602,8 +651,20 @@ char EmuSystem::saveSlotCharUpper(int slot)
 
 [[gnu::weak]] void EmuSystem::initOptions() {}
 
+[[gnu::weak]] EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	return makeError("Memory save states not supported");
+}
+
+[[gnu::weak]] EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	return makeError("Memory save states not supported");
+}
+
 [[gnu::weak]] EmuSystem::Error EmuSystem::onOptionsLoaded() { return {}; }
 
+[[gnu::weak]] bool EmuSystem::setBenchOption(const char *name, const char *value) { return false; }
+
 [[gnu::weak]] void EmuSystem::saveBackupMem() {}
 
 [[gnu::weak]] void EmuSystem::savePathChanged() {}
@@ -618,6 +679,8 @@ char EmuSystem::saveSlotCharUpper(int slot)
 
 [[gnu::weak]] bool EmuSystem::handlePointerInputEvent(Input::Event e, IG::WindowRect gameRect) { return false; }
 
+[[gnu::weak]] bool EmuSystem::handleUIInputAction(uint &state, uint &emuKey) { return false; }
+
 [[gnu::weak]] void EmuSystem::onPrepareVideo(EmuVideo &video) {}
 
 [[gnu::weak]] FS::FileString EmuSystem::fullGameNameForPath(const char *path)
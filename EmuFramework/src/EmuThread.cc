@@ -0,0 +1,112 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "EmuThread"
+#include <emuframework/EmuSystem.hh>
+#include <emuframework/EmuThread.hh>
+#include <imagine/logger/logger.h>
+#include "private.hh"
+
+void postDrawToEmuWindows();
+
+void EmuThread::start()
+{
+	if(started)
+		return;
+	started = true;
+	framePipe.init({},
+		[](Base::Pipe &pipe)
+		{
+			while(pipe.hasData())
+			{
+				uint8 msg;
+				pipe.read(&msg, sizeof(msg));
+			}
+			if(EmuSystem::isActive())
+				postDrawToEmuWindows();
+			return 1;
+		});
+	IG::makeDetachedThread(
+		[this]()
+		{
+			threadId = IG::this_thread::get_id();
+			logMsg("started emulation thread");
+			IG::Profiler::setThreadName("Emulation");
+			run();
+		});
+}
+
+void EmuThread::run()
+{
+	while(1)
+	{
+		execSem.wait();
+		IG_PROFILE_SCOPE("EmuSystem::runFrame");
+		auto startTime = IG::Time::now();
+		iterateTimes(skipFrames, i)
+		{
+			emuInputQueue.startFrame();
+			EmuSystem::runFrame(emuVideo, false, false, skipFramesAudio);
+		}
+		emuRunAhead.runFrame(emuVideo, true, renderAudio);
+		emuFramePacer.addFrameCost(IG::Time::now() - startTime, skipFrames + 1);
+		emuRewind.addFrames(skipFrames + 1);
+		busy = false;
+		if(waitingForIdle.exchange(false))
+			idleSem.notify();
+	}
+}
+
+bool EmuThread::isEmuThread() const
+{
+	return started && IG::this_thread::get_id() == threadId;
+}
+
+bool EmuThread::runFrames(uint skipFrames, bool skipFramesAudio, bool renderAudio)
+{
+	assert(started);
+	if(busy)
+	{
+		return false;
+	}
+	this->skipFrames = skipFrames;
+	this->skipFramesAudio = skipFramesAudio;
+	this->renderAudio = renderAudio;
+	busy = true;
+	execSem.notify();
+	return true;
+}
+
+void EmuThread::waitForIdle()
+{
+	if(!started || isEmuThread())
+		return;
+	waitingForIdle = true;
+	if(busy)
+	{
+		idleSem.wait();
+	}
+	else if(!waitingForIdle.exchange(false))
+	{
+		// thread finished between the two checks and will signal
+		idleSem.wait();
+	}
+}
+
+void EmuThread::postFrameReady()
+{
+	uint8 msg = 0;
+	framePipe.write(&msg, sizeof(msg));
+}
@@ -18,16 +18,28 @@
 #include <emuframework/EmuOptions.hh>
 #include <emuframework/EmuApp.hh>
 #include <emuframework/Screenshot.hh>
+#include <emuframework/EmuThread.hh>
 #include "private.hh"
 
 void EmuVideo::resetImage()
 {
 	auto desc = vidImg.usedPixmapDesc();
 	vidImg.deinit();
+	imgSize = IG::WP{};
 	setFormat(desc);
 }
 
 void EmuVideo::setFormat(IG::PixmapDesc desc)
+{
+	frameDesc = desc;
+	if(usesFrameQueue())
+	{
+		return; // texture format is updated in presentFrame()
+	}
+	setTextureFormat(desc);
+}
+
+void EmuVideo::setTextureFormat(IG::PixmapDesc desc)
 {
 	if(vidImg && desc == vidImg.usedPixmapDesc())
 	{
@@ -44,6 +56,7 @@ void EmuVideo::setFormat(IG::PixmapDesc desc)
 	{
 		vidImg.setFormat(desc, 1);
 	}
+	imgSize = desc.size();
 	logMsg("resized to:%dx%d", desc.w(), desc.h());
 	// update all EmuVideoLayers
 	#ifdef CONFIG_GFX_OPENGL_SHADER_PIPELINE
@@ -57,6 +70,15 @@ void EmuVideo::setFormat(IG::PixmapDesc desc)
 
 EmuVideoImage EmuVideo::startFrame()
 {
+	if(usesFrameQueue())
+	{
+		auto &buff = frameBuff[writeFrameIdx];
+		if((IG::PixmapDesc)buff != frameDesc)
+		{
+			buff = {frameDesc};
+		}
+		return {*this, (IG::Pixmap)buff};
+	}
 	auto lockedTex = vidImg.lock(0);
 	if(!lockedTex)
 	{
@@ -81,6 +103,11 @@ void EmuVideo::writeFrame(Gfx::LockedTextureBuffer texBuff)
 
 void EmuVideo::writeFrame(IG::Pixmap pix)
 {
+	if(usesFrameQueue())
+	{
+		queueFrame(pix);
+		return;
+	}
 	if(screenshotNextFrame)
 	{
 		doScreenshot(pix);
@@ -88,6 +115,74 @@ void EmuVideo::writeFrame(IG::Pixmap pix)
 	vidImg.write(0, pix, {}, vidImg.bestAlignment(pix));
 }
 
+void EmuVideo::queueFrame(IG::Pixmap pix)
+{
+	auto &buff = frameBuff[writeFrameIdx];
+	if(pix.pixel({}) != buff.pixel({}))
+	{
+		// frame wasn't rendered directly into the queue buffer
+		if((IG::PixmapDesc)buff != (IG::PixmapDesc)pix)
+		{
+			buff = {(IG::PixmapDesc)pix};
+		}
+		buff.write(pix, {});
+	}
+	writeFrameIdx = readyFrameIdx.exchange(writeFrameIdx | FRAME_READY_BIT) & ~FRAME_READY_BIT;
+}
+
+bool EmuVideo::presentFrame()
+{
+	if(!(readyFrameIdx & FRAME_READY_BIT))
+		return false;
+	presentFrameIdx = readyFrameIdx.exchange(presentFrameIdx) & ~FRAME_READY_BIT;
+	auto &buff = frameBuff[presentFrameIdx];
+	setTextureFormat(buff);
+	if(screenshotNextFrame)
+	{
+		doScreenshot(buff);
+	}
+	vidImg.write(0, buff, {}, vidImg.bestAlignment(buff));
+	return true;
+}
+
+IG::Pixmap EmuVideo::takeHeadlessFrame()
+{
+	assumeExpr(headless);
+	if(!(readyFrameIdx & FRAME_READY_BIT))
+		return {};
+	presentFrameIdx = readyFrameIdx.exchange(presentFrameIdx) & ~FRAME_READY_BIT;
+	return frameBuff[presentFrameIdx];
+}
+
+void EmuVideo::setThreadedMode(bool on)
+{
+	if(threaded == on)
+		return;
+	logMsg("%s threaded mode", on ? "enabling" : "disabling");
+	threaded = on;
+	if(!on)
+	{
+		for(auto &buff : frameBuff)
+		{
+			buff = {};
+		}
+	}
+	readyFrameIdx = 1;
+	writeFrameIdx = 0;
+	presentFrameIdx = 2;
+}
+
+void EmuVideo::setHeadlessMode(bool on)
+{
+	logMsg("%s headless mode", on ? "enabling" : "disabling");
+	headless = on;
+}
+
+bool EmuVideo::usesFrameQueue() const
+{
+	return headless || (threaded && emuThread.isEmuThread());
+}
+
 void EmuVideo::takeGameScreenshot()
 {
 	screenshotNextFrame = true;
@@ -138,8 +233,7 @@ void EmuVideoImage::endFrame()
 
 IG::WP EmuVideo::size() const
 {
-	if(!vidImg)
-		return {};
-	else
-		return vidImg.usedPixmapDesc().size();
+	if(headless)
+		return frameDesc.size();
+	return imgSize;
 }
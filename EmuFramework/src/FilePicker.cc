@@ -96,10 +96,12 @@ EmuFilePicker *EmuFilePicker::makeForBenchmarking(ViewAttachParams attach, bool
 EmuFilePicker *EmuFilePicker::makeForLoading(ViewAttachParams attach, bool singleDir)
 {
 	auto picker = new EmuFilePicker{attach, lastLoadPath.data(), false, EmuSystem::defaultFsFilter, singleDir};
+	emuLibrary.addDirectory(picker->path().data());
 	picker->setOnChangePath(
 		[](FSPicker &picker, FS::PathString, Input::Event)
 		{
 			lastLoadPath = picker.path();
+			emuLibrary.addDirectory(lastLoadPath.data());
 		});
 	picker->setOnSelectFile(
 		[](FSPicker &picker, const char *name, Input::Event e)
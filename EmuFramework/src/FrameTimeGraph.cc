@@ -0,0 +1,96 @@
+/*  This file is part of EmuFramework.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with EmuFramework.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "FrameTimeGraph"
+#include <emuframework/FrameTimeGraph.hh>
+#include <imagine/gfx/GeomRect.hh>
+#include <imagine/time/Profiler.hh>
+#include <imagine/util/algorithm.h>
+#include <algorithm>
+
+#ifdef CONFIG_PROFILER
+
+void FrameTimeGraph::setFace(Gfx::GlyphTextureSet &face)
+{
+	text.setFace(&face);
+	text.setString(str.data());
+}
+
+void FrameTimeGraph::place(const Gfx::ProjectionPlane &projP)
+{
+	this->projP = projP;
+	if(strlen(str.data()))
+		text.compile(r, projP);
+}
+
+void FrameTimeGraph::updateText(const uint64_t *nSecs, uint count)
+{
+	uint64_t total = 0, max = 0;
+	iterateTimes(count, i)
+	{
+		total += nSecs[i];
+		max = std::max(max, nSecs[i]);
+	}
+	string_printf(str, "avg %.2fms max %.2fms", total / 1e6 / count, max / 1e6);
+	text.setString(str.data());
+	text.compile(r, projP);
+}
+
+void FrameTimeGraph::draw(double targetFrameTime)
+{
+	using namespace Gfx;
+	if(!visible)
+		return;
+	std::array<uint64_t, frames> nSecs;
+	auto count = IG::Profiler::recentFrameTimes(nSecs.data(), frames);
+	if(!count)
+		return;
+	if(!framesUntilTextUpdate--)
+	{
+		updateText(nSecs.data(), count);
+		framesUntilTextUpdate = 30;
+	}
+	// graph spans 3 target frame times vertically
+	Gfx::GC width = projP.w / 3., height = projP.h / 6.;
+	Gfx::GC x = -projP.wHalf(), y = projP.hHalf() - height;
+	Gfx::GC barWidth = width / frames;
+	double maxNSecs = targetFrameTime * 3e9;
+	r.noTexProgram.use(r, projP.makeTranslate());
+	r.setBlendMode(BLEND_MODE_ALPHA);
+	r.setColor(0., 0., 0., .5);
+	GeomRect::draw(r, GCRect{x, y, x + width, y + height});
+	iterateTimes(count, i)
+	{
+		double frameTime = nSecs[i] / 1e9;
+		if(frameTime <= targetFrameTime * 1.25)
+			r.setColor(0., 1., 0., .7);
+		else if(frameTime <= targetFrameTime * 2.25)
+			r.setColor(1., 1., 0., .7);
+		else
+			r.setColor(1., 0., 0., .7);
+		Gfx::GC barHeight = height * std::min(nSecs[i] / maxNSecs, 1.);
+		Gfx::GC barX = x + barWidth * (frames - count + i);
+		GeomRect::draw(r, GCRect{barX, y, barX + barWidth, y + barHeight});
+	}
+	// mark the target frame time
+	Gfx::GC lineY = y + height / 3.;
+	r.setColor(1., 1., 1., .7);
+	GeomRect::draw(r, GCRect{x, lineY, x + width, lineY + projP.unprojectYSize(1)});
+	r.setColor(1., 1., 1., 1.);
+	r.texAlphaProgram.use(r);
+	text.draw(r, x, projP.alignYToPixel(y), LT2DO, projP);
+}
+
+#endif
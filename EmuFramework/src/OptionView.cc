@@ -150,6 +150,12 @@ static void setAudioRate(uint rate)
 	EmuSystem::configAudioPlayback();
 }
 
+static void setArchiveCacheSize(uint val)
+{
+	optionArchiveCacheSize = val;
+	emuArchiveCache.setMaxSize(optionArchiveCacheSize * 128ull * 1024 * 1024);
+}
+
 static void setMenuOrientation(uint val)
 {
 	optionMenuOrientation = val;
@@ -462,6 +468,7 @@ void AudioOptionView::loadStockItems()
 	#ifdef CONFIG_AUDIO_LATENCY_HINT
 	item.emplace_back(&soundBuffers);
 	#endif
+	item.emplace_back(&rateControl);
 	#ifdef EMU_FRAMEWORK_STRICT_UNDERRUN_CHECK_OPTION
 	item.emplace_back(&sndUnderrunCheck);
 	#endif
@@ -479,6 +486,13 @@ void SystemOptionView::loadStockItems()
 	item.emplace_back(&savePath);
 	item.emplace_back(&checkSavePathWriteAccess);
 	item.emplace_back(&fastForwardSpeed);
+	item.emplace_back(&emulationThread);
+	if(EmuSystem::hasMemoryStates)
+	{
+		item.emplace_back(&rewindMemory);
+		item.emplace_back(&runAhead);
+	}
+	item.emplace_back(&archiveCache);
 	#ifdef __ANDROID__
 	item.emplace_back(&processPriority);
 	if(!optionFakeUserActivity.isConst)
@@ -1110,6 +1124,15 @@ AudioOptionView::AudioOptionView(ViewAttachParams attach, bool customMenu):
 		{
 			return audioRateItem[idx];
 		}
+	},
+	rateControl
+	{
+		"Dynamic Rate Control",
+		(bool)optionAudioRateControl,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionAudioRateControl = item.flipBoolValue(*this);
+		}
 	}
 	#ifdef EMU_FRAMEWORK_STRICT_UNDERRUN_CHECK_OPTION
 	,sndUnderrunCheck
@@ -1254,6 +1277,77 @@ SystemOptionView::SystemOptionView(ViewAttachParams attach, bool customMenu):
 			return 0;
 		}(),
 		fastForwardSpeedItem
+	},
+	emulationThread
+	{
+		"Run Emulation On Separate Thread",
+		(bool)optionEmuThread,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			optionEmuThread = item.flipBoolValue(*this);
+		}
+	},
+	rewindMemoryItem
+	{
+		{"Off", [this]() { optionRewindMemory = 0; }},
+		{"8MB", [this]() { optionRewindMemory = 8; }},
+		{"16MB", [this]() { optionRewindMemory = 16; }},
+		{"32MB", [this]() { optionRewindMemory = 32; }},
+		{"64MB", [this]() { optionRewindMemory = 64; }},
+	},
+	rewindMemory
+	{
+		"Rewind Buffer Size",
+		[]() -> uint
+		{
+			switch(optionRewindMemory.val)
+			{
+				default: return 0;
+				case 8: return 1;
+				case 16: return 2;
+				case 32: return 3;
+				case 64: return 4;
+			}
+		}(),
+		rewindMemoryItem
+	},
+	runAheadItem
+	{
+		{"Off", [this]() { optionRunAheadFrames = 0; }},
+		{"1", [this]() { optionRunAheadFrames = 1; }},
+		{"2", [this]() { optionRunAheadFrames = 2; }},
+		{"3", [this]() { optionRunAheadFrames = 3; }},
+		{"4", [this]() { optionRunAheadFrames = 4; }},
+	},
+	runAhead
+	{
+		"Run-ahead Frames",
+		std::min((uint)optionRunAheadFrames, 4u),
+		runAheadItem
+	},
+	archiveCacheItem
+	{
+		{"Off", []() { setArchiveCacheSize(0); }},
+		{"512MB", []() { setArchiveCacheSize(4); }},
+		{"1GB", []() { setArchiveCacheSize(8); }},
+		{"2GB", []() { setArchiveCacheSize(16); }},
+		{"4GB", []() { setArchiveCacheSize(32); }},
+	},
+	archiveCache
+	{
+		"Archive Extraction Cache",
+		[]() -> uint
+		{
+			switch(optionArchiveCacheSize.val)
+			{
+				default: return 0;
+				case 4: return 1;
+				case 8: return 2;
+				case 16: return 3;
+				case 32: return 4;
+			}
+		}(),
+		archiveCacheItem
 	}
 	#if defined __ANDROID__
 	,processPriorityItem
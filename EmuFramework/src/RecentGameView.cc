@@ -43,14 +43,20 @@ RecentGameView::RecentGameView(ViewAttachParams attach):
 {
 	name_ = appViewTitle();
 	recentGame.reserve(recentGameList.size());
+	recentGameTitle.reserve(recentGameList.size());
 	for(auto &e : recentGameList)
 	{
-		recentGame.emplace_back(e.name.data(),
+		// indexed games show the library's title, which comes from the game's
+		// header when the core reads titles in readLibraryMetadata(), and are
+		// known to still exist
+		auto libEntry = emuLibrary.entry(e.path.data());
+		recentGameTitle.emplace_back(libEntry ? libEntry->title : e.name.data());
+		recentGame.emplace_back(recentGameTitle.back().c_str(),
 			[&e](TextMenuItem &t, View &view, Input::Event ev)
 			{
 				e.handleMenuSelection(view.renderer(), t, ev);
 			});
-		recentGame.back().setActive(FS::exists(e.path.data()));
+		recentGame.back().setActive(libEntry || FS::exists(e.path.data()));
 	}
 	clear.setActive(recentGameList.size());
 }
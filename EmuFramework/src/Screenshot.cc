@@ -18,6 +18,7 @@
 #include <imagine/logger/logger.h>
 #include <imagine/data-type/image/sys.hh>
 #include <imagine/pixmap/Pixmap.hh>
+#include <imagine/pixmap/PixelConvert.hh>
 #include <imagine/io/FileIO.hh>
 #include <imagine/mem/mem.h>
 
@@ -25,20 +26,24 @@
 
 bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 {
+	if(!IG::canConvertPixels(IG::PIXEL_RGBA8888, vidPix.format().id()))
+	{
+		logErr("can't write %s screenshots", vidPix.format().name());
+		return false;
+	}
 	auto screen = vidPix.pixel({});
 	IG::MemPixmap tempPix{{vidPix.size(), IG::PIXEL_FMT_RGB888}};
+	IG::MemPixmap rowRGBA{{{(int)vidPix.w(), 1}, IG::PIXEL_FMT_RGBA8888}};
 	for(uint y = 0; y < vidPix.h(); y++, screen += vidPix.pitchBytes())
 	{
+		IG::convertPixels(IG::PIXEL_RGBA8888, rowRGBA.pixel({}), vidPix.format().id(), screen, vidPix.w());
 		auto rowpix = tempPix.pixel({0, (int)y});
-		for(uint x = 0; x < vidPix.w(); x++)
+		auto srcPix = rowRGBA.pixel({});
+		for(uint x = 0; x < vidPix.w(); x++, srcPix += 4)
 		{
-			// assumes RGB565
-			uint16 pixVal = *(uint16 *)(screen+2*x);
-			uint32 r = pixVal >> 11, g = (pixVal >> 5) & 0x3f, b = pixVal & 0x1f;
-			r *= 8; g *= 4; b *= 8;
-			*(rowpix++) = r;
-			*(rowpix++) = g;
-			*(rowpix++) = b;
+			*(rowpix++) = srcPix[0];
+			*(rowpix++) = srcPix[1];
+			*(rowpix++) = srcPix[2];
 		}
 	}
 	Quartz2dImage::writeImage(tempPix, fname);
@@ -147,6 +152,14 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 		return false;
 	}
 
+	if(!IG::canConvertPixels(IG::PIXEL_RGBA8888, vidPix.format().id()))
+	{
+		logErr("can't write %s screenshots", vidPix.format().name());
+		png_destroy_write_struct(&pngPtr, &infoPtr);
+		FS::remove(fname);
+		return false;
+	}
+
 	uint imgwidth = vidPix.w();
 	uint imgheight = vidPix.h();
 
@@ -158,32 +171,15 @@ bool writeScreenshot(const IG::Pixmap &vidPix, const char *fname)
 
 	png_write_info(pngPtr, infoPtr);
 
-	//png_set_packing(pngPtr);
+	// rows are converted to RGBA8888, libpng drops the alpha byte
+	png_set_filler(pngPtr, 0, PNG_FILLER_AFTER);
 
-	png_byte *rowPtr= (png_byte*)mem_alloc(png_get_rowbytes(pngPtr, infoPtr));
+	png_byte *rowPtr= (png_byte*)mem_alloc(imgwidth * 4);
 	auto screen = vidPix.pixel({});
 	for(uint y=0; y < vidPix.h(); y++, screen+=vidPix.pitchBytes())
 	{
-		png_byte *rowpix = rowPtr;
-		for(uint x=0; x < vidPix.w(); x++)
-		{
-			// assumes RGB565
-			uint16 pixVal = *(uint16 *)(screen+2*x);
-			uint32 r = pixVal >> 11, g = (pixVal >> 5) & 0x3f, b = pixVal & 0x1f;
-			r *= 8; g *= 4; b *= 8;
-			*(rowpix++) = r;
-			*(rowpix++) = g;
-			*(rowpix++) = b;
-			if(imgwidth != vidPix.w())
-			{
-				*(rowpix++) = r;
-				*(rowpix++) = g;
-				*(rowpix++) = b;
-			}
-		}
+		IG::convertPixels(IG::PIXEL_RGBA8888, rowPtr, vidPix.format().id(), screen, vidPix.w());
 		png_write_row(pngPtr, rowPtr);
-		if(imgheight != vidPix.h())
-			png_write_row(pngPtr, rowPtr);
 	}
 
 	mem_free(rowPtr);
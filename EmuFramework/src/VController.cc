@@ -21,6 +21,7 @@
 #include <imagine/util/math/int.hh>
 #include <imagine/util/math/space.hh>
 #include "private.hh"
+#include "privateInput.hh"
 
 void VControllerDPad::init() {}
 
@@ -727,12 +728,12 @@ void VController::setBaseBtnSize(uint gamepadBtnSizeInPixels, uint uiBtnSizeInPi
 	ffBound = IG::makeWindowRectRel({0, 0}, {size, size});
 }
 
-void VController::inputAction(uint action, uint vBtn)
+void VController::inputAction(uint action, uint vBtn, Input::Time time)
 {
 	if(isInKeyboardMode())
 	{
 		assert(vBtn < IG::size(kbMap));
-		EmuSystem::handleInputAction(action, kbMap[vBtn]);
+		queueInputAction(action, kbMap[vBtn], time);
 	}
 	else
 	{
@@ -750,7 +751,7 @@ void VController::inputAction(uint action, uint vBtn)
 				turboActions.removeEvent(keyCode);
 			}
 		}
-		EmuSystem::handleInputAction(action, keyCode);
+		queueInputAction(action, keyCode, time);
 	}
 }
 
@@ -866,7 +867,7 @@ void VController::applyInput(Input::Event e)
 		if(vBtn != -1 && !IG::contains(elem, vBtn))
 		{
 			//logMsg("releasing %d", vBtn);
-			inputAction(Input::RELEASED, vBtn);
+			inputAction(Input::RELEASED, vBtn, e.time());
 		}
 	}
 
@@ -876,7 +877,7 @@ void VController::applyInput(Input::Event e)
 		if(vBtn != -1 && !IG::contains(currElem, vBtn))
 		{
 			//logMsg("pushing %d", vBtn);
-			inputAction(Input::PUSHED, vBtn);
+			inputAction(Input::PUSHED, vBtn, e.time());
 			if(optionVibrateOnPush)
 			{
 				Base::vibrate(32);
@@ -28,6 +28,16 @@
 #include <emuframework/EmuSystem.hh>
 #include <emuframework/MsgPopup.hh>
 #include <emuframework/Recent.hh>
+#include <emuframework/EmuThread.hh>
+#include <emuframework/EmuRewind.hh>
+#include <emuframework/EmuRunAhead.hh>
+#include <emuframework/EmuInputQueue.hh>
+#include <emuframework/EmuInputMovie.hh>
+#include <emuframework/EmuFramePacer.hh>
+#include <emuframework/EmuLibrary.hh>
+#include <emuframework/EmuArchiveCache.hh>
+#include <emuframework/FrameTimeGraph.hh>
+#include <imagine/time/Profiler.hh>
 #ifdef CONFIG_EMUFRAMEWORK_VCONTROLS
 #include <emuframework/VController.hh>
 #endif
@@ -62,12 +72,24 @@ extern std::unique_ptr<Base::UserActivityFaker> userActivityFaker;
 extern DelegateFunc<void ()> onUpdateInputDevices;
 extern FS::PathString lastLoadPath;
 extern MsgPopup popup;
+#ifdef CONFIG_PROFILER
+extern FrameTimeGraph frameTimeGraph;
+#endif
 extern EmuVideo emuVideo;
+extern EmuThread emuThread;
+extern EmuRewind emuRewind;
+extern EmuRunAhead emuRunAhead;
+extern EmuInputQueue emuInputQueue;
+extern EmuInputMovie emuInputMovie;
+extern EmuFramePacer emuFramePacer;
+extern EmuLibrary emuLibrary;
+extern EmuArchiveCache emuArchiveCache;
 extern EmuInputView emuInputView;
 extern StaticArrayList<RecentGameInfo, RecentGameInfo::MAX_RECENT> recentGameList;
 static constexpr const char *strftimeFormat = "%x  %r";
 
 void loadConfigFile();
+int runHeadlessBenchmark(int argc, char** argv);
 void saveConfigFile();
 void addRecentGame(const char *fullPath, const char *name);
 bool isMenuDismissKey(Input::Event e);
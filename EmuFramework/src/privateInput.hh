@@ -109,6 +109,7 @@ struct VControllerLayoutPosition
 };
 
 extern bool fastForwardActive;
+extern bool rewindActive;
 
 static const int guiKeyIdxLoadGame = 0;
 static const int guiKeyIdxMenu = 1;
@@ -119,6 +120,7 @@ static const int guiKeyIdxIncStateSlot = 5;
 static const int guiKeyIdxFastForward = 6;
 static const int guiKeyIdxGameScreenshot = 7;
 static const int guiKeyIdxExit = 8;
+static const int guiKeyIdxRewind = 9;
 
 static const uint VCTRL_LAYOUT_DPAD_IDX = 0,
 	VCTRL_LAYOUT_CENTER_BTN_IDX = 1,
@@ -136,6 +138,8 @@ extern KeyMapping keyMapping;
 extern bool physicalControlsPresent;
 extern VControllerLayoutPosition vControllerLayoutPos[2][7];
 
+// pass an emulated input action to the emulation, see EmuInputQueue
+void queueInputAction(uint state, uint emuKey, Input::Time time);
 void processRelPtr(Input::Event e);
 void commonInitInput();
 void commonUpdateInput();
@@ -30,6 +30,7 @@ gba/GBA-arm.cpp \
 gba/GBA.cpp \
 gba/gbafilter.cpp \
 gba/RTC.cpp \
+gba/RenderThread.cpp \
 gba/Sound.cpp \
 gba/Sram.cpp \
 common/memgzio.c \
@@ -5,6 +5,27 @@
 #include <vbam/gba/GBA.h>
 #include <vbam/gba/RTC.h>
 
+class CustomVideoOptionView : public VideoOptionView
+{
+	BoolMenuItem renderThread
+	{
+		"Render Video In Separate Thread",
+		(bool)optionRenderThread,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			// used when the next game loads
+			optionRenderThread = item.flipBoolValue(*this);
+		}
+	};
+
+public:
+	CustomVideoOptionView(ViewAttachParams attach): VideoOptionView{attach, true}
+	{
+		loadStockItems();
+		item.emplace_back(&renderThread);
+	}
+};
+
 class CustomSystemOptionView : public SystemOptionView
 {
 	TextMenuItem rtcItem[3]
@@ -49,6 +70,7 @@ View *EmuApp::makeCustomView(ViewAttachParams attach, ViewID id)
 {
 	switch(id)
 	{
+		case ViewID::VIDEO_OPTIONS: return new CustomVideoOptionView(attach);
 		case ViewID::SYSTEM_OPTIONS: return new CustomSystemOptionView(attach);
 		case ViewID::EDIT_CHEATS: return new EmuEditCheatListView(attach);
 		case ViewID::LIST_CHEATS: return new EmuCheatsView(attach);
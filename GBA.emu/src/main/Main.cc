@@ -16,6 +16,7 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/EmuLibrary.hh>
 #include "internal.hh"
 #include "Cheats.hh"
 #include <vbam/gba/GBA.h>
@@ -38,6 +39,7 @@ bool detectedRtcGame = 0;
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2012-2014\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nVBA-m Team\nvba-m.com";
 bool EmuSystem::hasBundledGames = true;
 bool EmuSystem::hasCheats = true;
+bool EmuSystem::hasMemoryStates = true;
 
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter =
 	[](const char *name)
@@ -108,6 +110,30 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return makeFileReadError();
 }
 
+// upper bound for the compressed memory state, the actual size
+// is read back from the memgzio header after writing
+static constexpr uint maxMemStateSize = 0x100000;
+
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	if(!buff.resize(maxMemStateSize))
+		return makeError("Out of memory");
+	if(!CPUWriteMemState(gGba, (char*)buff.data(), buff.size()))
+		return makeFileWriteError();
+	int32 dataSize;
+	memcpy(&dataSize, buff.data() + 4, sizeof(dataSize));
+	buff.resize(dataSize + 8);
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	if(CPUReadMemState(gGba, (char*)buff.data(), buff.size()))
+		return {};
+	else
+		return makeFileReadError();
+}
+
 void EmuSystem::saveBackupMem()
 {
 	if(gameIsRunning())
@@ -180,12 +206,32 @@ EmuSystem::Error EmuSystem::loadGame(IO &io, OnLoadProgressDelegate)
 	}
 	CPUInit(gGba, 0, 0);
 	CPUReset(gGba);
+	CPUSetRenderThread(gGba, optionRenderThread);
 	auto saveStr = FS::makePathStringPrintf("%s/%s.sav", EmuSystem::savePath(), EmuSystem::gameName().data());
 	CPUReadBatteryFile(gGba, saveStr.data());
 	readCheatFile();
 	return {};
 }
 
+void EmuSystem::readLibraryMetadata(IO &io, EmuLibraryEntry &entry)
+{
+	// the last character of the header's game code gives the region
+	std::array<char, 0xB0> header;
+	if(io.read(header.data(), header.size()) != (ssize_t)header.size())
+		return;
+	entry.title = EmuLibrary::titleFromHeader(&header[0xA0], 12);
+	switch(header[0xAF])
+	{
+		case 'E': entry.region = EmuLibraryEntry::Region::USA; break;
+		case 'J': entry.region = EmuLibraryEntry::Region::JAPAN; break;
+		case 'P':
+		case 'D':
+		case 'F':
+		case 'I':
+		case 'S': entry.region = EmuLibraryEntry::Region::EUROPE; break;
+	}
+}
+
 void EmuSystem::onPrepareVideo(EmuVideo &video)
 {
 	video.setFormat({{240, 160}, pixFmt});
@@ -197,7 +243,7 @@ void systemDrawScreen(EmuVideo &video)
 	IG::Pixmap framePix{{{240, 160}, IG::PIXEL_RGB565}, gGba.lcd.pix};
 	if(!directColorLookup)
 	{
-		img.pixmap().writeTransformed([](uint16 p){ return systemColorMap.map16[p]; }, framePix);
+		img.pixmap().writePaletted(framePix, systemColorMap.map16);
 	}
 	else
 	{
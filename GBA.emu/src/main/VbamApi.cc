@@ -5,6 +5,7 @@
 #include <vbam/Util.h>
 #include <imagine/logger/logger.h>
 #include <imagine/audio/Audio.hh>
+#include <imagine/util/container/PerfectHashTable.hh>
 #include "internal.hh"
 
 int systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
@@ -58,6 +59,19 @@ struct GameSettings
 	int mirroringEnabled;
 };
 
+static constexpr uint32 gameCode(const char *id)
+{
+	return (uint8)id[0] << 24 | (uint8)id[1] << 16 | (uint8)id[2] << 8 | (uint8)id[3];
+}
+
+struct GameSettingsKeyTraits
+{
+	using Key = uint32;
+	static constexpr Key key(const GameSettings &e) { return gameCode(e.gameID); }
+	static constexpr uint64_t hash(Key code) { return code; }
+	static constexpr bool equal(Key a, Key b) { return a == b; }
+};
+
 static void resetGameSettings()
 {
 	//agbPrintEnable(0);
@@ -70,7 +84,7 @@ void setGameSpecificSettings(GBASys &gba)
 {
 	resetGameSettings();
 	bool mirroringEnable = 0;
-	static const GameSettings setting[] = {
+	static constexpr GameSettings settingList[] = {
 	{       "Dragon Ball Z - The Legacy of Goku II (Europe)(En,Fr,De,Es,It)",
 	        "ALFP",
 	        1,
@@ -930,32 +944,30 @@ void setGameSpecificSettings(GBASys &gba)
 
 	resetGameSettings();
 	logMsg("game id: %c%c%c%c", gba.mem.rom[0xac], gba.mem.rom[0xad], gba.mem.rom[0xae], gba.mem.rom[0xaf]);
-	for(auto e : setting)
+	static constexpr auto setting = IG::makePerfectHashTable<GameSettingsKeyTraits>(settingList);
+	static_assert(setting.isValid(), "error building game settings hash table");
+	if(auto e = setting.find(gameCode((const char*)&gba.mem.rom[0xac])))
 	{
-		if(IG::equal_n(e.gameID, 4, &gba.mem.rom[0xac]))
+		logMsg("loading settings for: %s", e->gameName);
+		if(e->rtcEnabled >= 0)
+		{
+			logMsg("using RTC");
+			detectedRtcGame = 1;
+		}
+		if(e->flashSize > 0)
+		{
+			logMsg("using flash size %d", e->flashSize);
+			flashSetSize(e->flashSize);
+		}
+		if(e->saveType >= 0)
+		{
+			logMsg("using save type %d", e->saveType);
+			cpuSaveType = e->saveType;
+		}
+		if(e->mirroringEnabled >= 0)
 		{
-			logMsg("loading settings for: %s", e.gameName);
-			if(e.rtcEnabled >= 0)
-			{
-				logMsg("using RTC");
-				detectedRtcGame = 1;
-			}
-			if(e.flashSize > 0)
-			{
-				logMsg("using flash size %d", e.flashSize);
-				flashSetSize(e.flashSize);
-			}
-			if(e.saveType >= 0)
-			{
-				logMsg("using save type %d", e.saveType);
-				cpuSaveType = e.saveType;
-			}
-			if(e.mirroringEnabled >= 0)
-			{
-				logMsg("using mirroring");
-				mirroringEnable = e.mirroringEnabled;
-			}
-			break;
+			logMsg("using mirroring");
+			mirroringEnable = e->mirroringEnabled;
 		}
 	}
 
@@ -18,7 +18,7 @@
 
 enum
 {
-	CFGKEY_RTC_EMULATION = 256
+	CFGKEY_RTC_EMULATION = 256, CFGKEY_RENDER_THREAD = 257
 };
 
 const char *EmuSystem::configFilename = "GbaEmu.config";
@@ -29,6 +29,22 @@ const AspectRatioInfo EmuSystem::aspectRatioInfo[]
 };
 const uint EmuSystem::aspectRatioInfos = IG::size(EmuSystem::aspectRatioInfo);
 Byte1Option optionRtcEmulation(CFGKEY_RTC_EMULATION, RTC_EMU_AUTO, 0, optionIsValidWithMax<2>);
+Byte1Option optionRenderThread(CFGKEY_RENDER_THREAD, 0);
+
+bool EmuSystem::setBenchOption(const char *name, const char *value)
+{
+	if(string_equal(name, "renderThread"))
+	{
+		if(string_equal(value, "0"))
+			optionRenderThread = 0;
+		else if(string_equal(value, "1"))
+			optionRenderThread = 1;
+		else
+			return false;
+		return true;
+	}
+	return false;
+}
 
 bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 {
@@ -36,6 +52,7 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 	{
 		default: return 0;
 		bcase CFGKEY_RTC_EMULATION: optionRtcEmulation.readFromIO(io, readSize);
+		bcase CFGKEY_RENDER_THREAD: optionRenderThread.readFromIO(io, readSize);
 	}
 	return 1;
 }
@@ -43,4 +60,5 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 void EmuSystem::writeConfig(IO &io)
 {
 	optionRtcEmulation.writeWithKeyIfNotDefault(io);
+	optionRenderThread.writeWithKeyIfNotDefault(io);
 }
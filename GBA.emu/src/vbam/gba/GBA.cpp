@@ -21,6 +21,7 @@
 #include "../System.h"
 #include "agbprint.h"
 #include "GBALink.h"
+#include "RenderThread.h"
 #include <imagine/logger/logger.h>
 #include <imagine/io/FileIO.hh>
 
@@ -674,40 +675,39 @@ inline int CPUUpdateTicks(ARM7TDMI &cpu)
   return cpuLoopTicks;
 }
 
-static void CPUUpdateWindow0(GBASys &gba)
+void GBALCD::updateWindow(bool gfxInWin[240], u16 WINH)
 {
-  int x00 = gba.mem.ioMem.WIN0H>>8;
-  int x01 = gba.mem.ioMem.WIN0H & 255;
+  int x00 = WINH>>8;
+  int x01 = WINH & 255;
 
   if(x00 <= x01) {
     for(int i = 0; i < 240; i++) {
-      gba.lcd.gfxInWin0[i] = (i >= x00 && i < x01);
+      gfxInWin[i] = (i >= x00 && i < x01);
     }
   } else {
     for(int i = 0; i < 240; i++) {
-    	gba.lcd.gfxInWin0[i] = (i >= x00 || i < x01);
+    	gfxInWin[i] = (i >= x00 || i < x01);
     }
   }
 }
 
-static void CPUUpdateWindow1(GBASys &gba)
+static void CPUUpdateWindow0(GBASys &gba)
 {
-  int x00 = gba.mem.ioMem.WIN1H>>8;
-  int x01 = gba.mem.ioMem.WIN1H & 255;
+  gba.lcd.updateWindow(gba.lcd.gfxInWin0, gba.mem.ioMem.WIN0H);
+}
 
-  if(x00 <= x01) {
-    for(int i = 0; i < 240; i++) {
-    	gba.lcd.gfxInWin1[i] = (i >= x00 && i < x01);
-    }
-  } else {
-    for(int i = 0; i < 240; i++) {
-    	gba.lcd.gfxInWin1[i] = (i >= x00 || i < x01);
-    }
-  }
+static void CPUUpdateWindow1(GBASys &gba)
+{
+  gba.lcd.updateWindow(gba.lcd.gfxInWin1, gba.mem.ioMem.WIN1H);
 }
 
 static void CPUUpdateRenderBuffers(GBASys &gba, bool force)
 {
+  if(gba.renderThread) {
+    // the line buffers belong to the render thread's copy of the LCD
+    gba.renderThread->clearLineBuffers(force ? 0x0F00 : (~gba.lcd.layerEnable & 0x0F00));
+    return;
+  }
   if(!(gba.lcd.layerEnable & 0x0100) || force) {
     gfxClearArray(gba.lcd.line0);
   }
@@ -946,6 +946,8 @@ static bool CPUReadState(GBASys &gba, gzFile gzFile)
   CPUUpdateRenderBuffers(gba, true);
   CPUUpdateWindow0(gba);
   CPUUpdateWindow1(gba);
+  if(gba.renderThread)
+    gba.renderThread->markAllDirty();
   gbaSaveType = 0;
   switch(saveType) {
   case 0:
@@ -1437,6 +1439,8 @@ void CPUCleanUp()
   elfCleanUp();
 #endif //NO_DEBUGGER
 
+  CPUSetRenderThread(gGba, false);
+
   systemSaveUpdateCounter = SYSTEM_SAVE_NOT_UPDATED;
 }
 
@@ -3028,6 +3032,10 @@ void CPUReset(GBASys &gba)
       }
   }
   rtcReset();
+  if(gba.renderThread) {
+    gba.renderThread->waitForIdle();
+    gba.renderThread->markAllDirty();
+  }
   // clean io memory
   memset(gba.mem.ioMem.b, 0, 0x400);
   // clean OAM, palette, picture, & vram
@@ -3197,6 +3205,20 @@ void CPUReset(GBASys &gba)
   //SWITicks = 0;
 }
 
+void CPUSetRenderThread(GBASys &gba, bool on)
+{
+  if(on == (bool)gba.renderThread)
+    return;
+  if(on) {
+    gba.renderThread = new GBARenderThread(gba.lcd);
+  } else {
+    gba.renderThread->waitForIdle();
+    gba.renderThread->copyRenderState(gba.lcd);
+    delete gba.renderThread;
+    gba.renderThread = nullptr;
+  }
+}
+
 void CPUInterrupt(GBASys &gba, ARM7TDMI &cpu)
 {
 	cpu.interrupt(gba.mem.ioMem);
@@ -3421,7 +3443,10 @@ void CPULoop(GBASys &gba, EmuVideo &video, bool renderGfx, bool processGfx, bool
             	{
             	}*/
 
-              (*gba.lcd.renderLine)(gba.lcd.lineMix, gba.lcd, ioMem);
+              if(gba.renderThread)
+                gba.renderThread->queueLine(gba.lcd, ioMem);
+              else
+                (*gba.lcd.renderLine)(gba.lcd.lineMix, gba.lcd, ioMem);
               /*switch(systemColorDepth) {
 				#ifdef SUPPORT_PIX_16BIT
                 case 16:
@@ -3461,9 +3486,13 @@ void CPULoop(GBASys &gba, EmuVideo &video, bool renderGfx, bool processGfx, bool
 				#endif
               }*/
             }
-            if(ioMem.VCOUNT == 159 && likely(renderGfx))
+            if(ioMem.VCOUNT == 159)
             {
-            	systemDrawScreen(video);
+            	// leave the render thread idle between frames
+            	if(gba.renderThread)
+            		gba.renderThread->waitForIdle();
+            	if(likely(renderGfx))
+            		systemDrawScreen(video);
             }
             // entering H-Blank
             ioMem.DISPSTAT |= 2;
@@ -344,6 +344,8 @@ struct GBALCD
 		ioMem.resetLcdRegs(useBios, skipBios);
 		layerEnable = ioMem.DISPCNT & layerSettings;
 	}
+
+	static void updateWindow(bool gfxInWin[240], u16 WINH);
 };
 
 typedef union {
@@ -955,6 +957,8 @@ public:
 	}
 };
 
+class GBARenderThread;
+
 struct GBASys
 {
 #ifndef __clang__
@@ -968,6 +972,7 @@ struct GBASys
 	GBATimers timers;
 	GBADMA dma;
 	GBAMem mem;
+	GBARenderThread *renderThread = nullptr;
 };
 
 extern GBASys gGba;
@@ -1034,6 +1039,7 @@ extern void CPUUpdateRegister(ARM7TDMI &cpu, u32, u16);
 extern void applyTimer(ARM7TDMI &cpu);
 extern void CPUInit(GBASys &gba, const char *,bool);
 extern void CPUReset(GBASys &gba);
+extern void CPUSetRenderThread(GBASys &gba, bool on);
 extern void CPULoop(int);
 extern void CPUCheckDMA(GBASys &gba, ARM7TDMI &cpu, int,int);
 extern bool CPUIsGBAImage(const char *);
@@ -8,6 +8,7 @@
 #include "agbprint.h"
 #include "GBAcpu.h"
 #include "GBALink.h"
+#include "RenderThread.h"
 
 static const u32  objTilesAddress [3] = {0x010000, 0x014000, 0x014000};
 
@@ -624,6 +625,8 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, u32 address, u32 value)
     else
 #endif
       WRITE32LE(((u32 *)&paletteRAM[address & 0x3FC]), value);
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markPaletteDirty(address);
     break;
   case 0x06:
     address = (address & 0x1fffc);
@@ -639,6 +642,8 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, u32 address, u32 value)
 #endif
 
       WRITE32LE(((u32 *)&vram[address]), value);
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markVRAMDirty(address);
     break;
   case 0x07:
 #ifdef BKPT_SUPPORT
@@ -649,6 +654,8 @@ static inline void CPUWriteMemory(ARM7TDMI &cpu, u32 address, u32 value)
 #endif
       WRITE32LE(((u32 *)&oam[address & 0x3fc]), value);
       //oamUpdated = 1;
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markOAMDirty(address);
     break;
   case 0x0D:
     if(cpuEEPROMEnabled) {
@@ -724,6 +731,8 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, u32 address, u16 value)
     else
 #endif
       WRITE16LE(((u16 *)&paletteRAM[address & 0x3fe]), value);
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markPaletteDirty(address);
     break;
   case 6:
     address = (address & 0x1fffe);
@@ -738,6 +747,8 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, u32 address, u16 value)
     else
 #endif
       WRITE16LE(((u16 *)&vram[address]), value);
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markVRAMDirty(address);
     break;
   case 7:
 #ifdef BKPT_SUPPORT
@@ -748,6 +759,8 @@ static inline void CPUWriteHalfWord(ARM7TDMI &cpu, u32 address, u16 value)
 #endif
       WRITE16LE(((u16 *)&oam[address & 0x3fe]), value);
       //oamUpdated = 1;
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markOAMDirty(address);
     break;
   case 8:
   case 9:
@@ -879,6 +892,8 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, u32 address, u8 b)
   case 5:
     // no need to switch
   	*((uint16a *)&cpu.gba->lcd.paletteRAM[address & 0x3FE]) = (b << 8) | b;
+    if(unlikely(cpu.gba->renderThread))
+      cpu.gba->renderThread->markPaletteDirty(address);
     break;
   case 6:
     address = (address & 0x1fffe);
@@ -897,6 +912,8 @@ static inline void CPUWriteByte(ARM7TDMI &cpu, u32 address, u8 b)
       else
 #endif
       	*((uint16a *)&vram[address]) = (b << 8) | b;
+      if(unlikely(cpu.gba->renderThread))
+        cpu.gba->renderThread->markVRAMDirty(address);
     }
     break;
   case 7:
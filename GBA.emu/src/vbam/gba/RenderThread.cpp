@@ -0,0 +1,194 @@
+#include "RenderThread.h"
+#include "GBAGfx.h"
+#include <imagine/logger/logger.h>
+#include <imagine/util/algorithm.h>
+#include <imagine/time/Profiler.hh>
+#include <cstring>
+
+GBARenderThread::GBARenderThread(const GBALCD &srcLcd):
+	lcd{srcLcd},
+	// declared last so everything it uses is constructed first
+	thread
+	{
+		[this]()
+		{
+			logMsg("started render thread");
+			IG::Profiler::setThreadName("GBA Render");
+			run();
+		}
+	}
+{}
+
+GBARenderThread::~GBARenderThread()
+{
+	quit = true;
+	workSem.notify();
+	thread.join();
+	logMsg("stopped render thread");
+}
+
+static void clearLayerLineBuffers(GBALCD &lcd, uint layers)
+{
+	#ifndef GBALCD_TEMP_LINE_BUFFER
+	if(layers & 0x0100)
+		gfxClearArray(lcd.line0);
+	if(layers & 0x0200)
+		gfxClearArray(lcd.line1);
+	if(layers & 0x0400)
+		gfxClearArray(lcd.line2);
+	if(layers & 0x0800)
+		gfxClearArray(lcd.line3);
+	#endif
+}
+
+void GBARenderThread::markAllDirty()
+{
+	std::fill_n(dirtyBits, dirtyWords, ~0u);
+	anyDirty = true;
+}
+
+const u8 *GBARenderThread::blockSource(const GBALCD &srcLcd, uint index) const
+{
+	uint offset = index * blockSize;
+	if(offset < vramSize)
+		return &srcLcd.vram[offset];
+	offset -= vramSize;
+	if(offset < paletteSize)
+		return &srcLcd.paletteRAM[offset];
+	return &srcLcd.oam[offset - paletteSize];
+}
+
+u8 *GBARenderThread::blockDest(uint index)
+{
+	return (u8*)blockSource(lcd, index);
+}
+
+void GBARenderThread::queueLine(GBALCD &srcLcd, const GBAMem::IoMem &ioMem)
+{
+	if(lineWrite - lineRead.load(std::memory_order_acquire) == lineCapacity)
+	{
+		// only happens when frames run without being drawn
+		waitForIdle();
+	}
+	if(anyDirty)
+	{
+		uint dirtyBlocks = 0;
+		for(auto bits : dirtyBits)
+		{
+			dirtyBlocks += __builtin_popcount(bits);
+		}
+		if(dataWrite - dataRead.load(std::memory_order_acquire) + dirtyBlocks > dataCapacity)
+		{
+			waitForIdle();
+		}
+		iterateTimes(dirtyWords, w)
+		{
+			auto bits = dirtyBits[w];
+			while(bits)
+			{
+				uint index = w * 32 + __builtin_ctz(bits);
+				bits &= bits - 1;
+				auto &block = data[dataWrite % dataCapacity];
+				block.index = index;
+				memcpy(block.data, blockSource(srcLcd, index), blockSize);
+				dataWrite++;
+			}
+			dirtyBits[w] = 0;
+		}
+		anyDirty = false;
+	}
+	auto &cmd = line[lineWrite % lineCapacity];
+	cmd.renderLine = srcLcd.renderLine;
+	cmd.lineMix = srcLcd.lineMix;
+	memcpy(cmd.ioMem.b, ioMem.b, lineRegsSize);
+	cmd.layerEnable = srcLcd.layerEnable;
+	// the renderer consumes the affine reference point changes
+	cmd.gfxBG2Changed = srcLcd.gfxBG2Changed;
+	cmd.gfxBG3Changed = srcLcd.gfxBG3Changed;
+	srcLcd.gfxBG2Changed = srcLcd.gfxBG3Changed = 0;
+	cmd.dataEnd = dataWrite;
+	cmd.clearLayers = clearLayersPending;
+	clearLayersPending = 0;
+	lineWrite.store(lineWrite.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	workSem.notify();
+}
+
+void GBARenderThread::waitForIdle()
+{
+	if(lineRead.load() == lineWrite)
+		return;
+	waitingForIdle = true;
+	if(lineRead.load() != lineWrite)
+	{
+		idleSem.wait();
+	}
+	else if(!waitingForIdle.exchange(false))
+	{
+		// thread finished between the two checks and will signal
+		idleSem.wait();
+	}
+}
+
+void GBARenderThread::copyRenderState(GBALCD &destLcd) const
+{
+	#ifndef GBALCD_TEMP_LINE_BUFFER
+	memcpy(destLcd.line0, lcd.line0, sizeof(lcd.line0));
+	memcpy(destLcd.line1, lcd.line1, sizeof(lcd.line1));
+	memcpy(destLcd.line2, lcd.line2, sizeof(lcd.line2));
+	memcpy(destLcd.line3, lcd.line3, sizeof(lcd.line3));
+	memcpy(destLcd.lineOBJ, lcd.lineOBJ, sizeof(lcd.lineOBJ));
+	#endif
+	// apply clears requested after the last queued line
+	clearLayerLineBuffers(destLcd, clearLayersPending);
+	memcpy(destLcd.lineOBJWin, lcd.lineOBJWin, sizeof(lcd.lineOBJWin));
+	memcpy(destLcd.lineOBJpixleft, lcd.lineOBJpixleft, sizeof(lcd.lineOBJpixleft));
+	destLcd.gfxBG2Changed |= lcd.gfxBG2Changed;
+	destLcd.gfxBG3Changed |= lcd.gfxBG3Changed;
+	destLcd.gfxBG2X = lcd.gfxBG2X;
+	destLcd.gfxBG2Y = lcd.gfxBG2Y;
+	destLcd.gfxBG3X = lcd.gfxBG3X;
+	destLcd.gfxBG3Y = lcd.gfxBG3Y;
+	destLcd.gfxLastVCOUNT = lcd.gfxLastVCOUNT;
+}
+
+void GBARenderThread::renderLine(const LineCommand &cmd)
+{
+	uint32 dataPos = dataRead.load(std::memory_order_relaxed);
+	for(; dataPos != cmd.dataEnd; dataPos++)
+	{
+		auto &block = data[dataPos % dataCapacity];
+		memcpy(blockDest(block.index), block.data, blockSize);
+	}
+	dataRead.store(dataPos, std::memory_order_release);
+	clearLayerLineBuffers(lcd, cmd.clearLayers);
+	if(cmd.ioMem.WIN0H != win0H)
+	{
+		win0H = cmd.ioMem.WIN0H;
+		GBALCD::updateWindow(lcd.gfxInWin0, win0H);
+	}
+	if(cmd.ioMem.WIN1H != win1H)
+	{
+		win1H = cmd.ioMem.WIN1H;
+		GBALCD::updateWindow(lcd.gfxInWin1, win1H);
+	}
+	lcd.layerEnable = cmd.layerEnable;
+	lcd.gfxBG2Changed |= cmd.gfxBG2Changed;
+	lcd.gfxBG3Changed |= cmd.gfxBG3Changed;
+	cmd.renderLine(cmd.lineMix, lcd, cmd.ioMem);
+}
+
+void GBARenderThread::run()
+{
+	uint32 lineIdx = 0;
+	while(1)
+	{
+		workSem.wait();
+		if(quit)
+			return;
+		renderLine(line[lineIdx % lineCapacity]);
+		lineIdx++;
+		lineRead.store(lineIdx);
+		if(lineIdx == lineWrite && waitingForIdle.exchange(false))
+			idleSem.notify();
+	}
+}
@@ -0,0 +1,107 @@
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "GBA.h"
+#include <imagine/thread/Thread.hh>
+#include <imagine/thread/Semaphore.hh>
+#include <atomic>
+
+// Renders scanlines on a worker thread instead of inline at each H-Blank.
+// The emulation thread queues a command per line holding the render function
+// & a snapshot of the display registers, along with copies of any 64 byte
+// blocks of VRAM, palette RAM & OAM written since the previous line. The
+// worker applies the blocks to its own GBALCD, which shadows the video memory
+// & keeps the renderer's state, then calls the same render function as the
+// inline path, so its output is identical. Lines are written straight to the
+// emulation side's pix buffer, which must only be read after waitForIdle().
+
+class GBARenderThread
+{
+public:
+	GBARenderThread(const GBALCD &lcd);
+	~GBARenderThread();
+
+	// mark video memory as written, address is relative to the start of each area
+	void markVRAMDirty(u32 address) { markDirty(address & 0x1FFFF); }
+	void markPaletteDirty(u32 address) { markDirty(vramSize + (address & 0x3FF)); }
+	void markOAMDirty(u32 address) { markDirty(vramSize + paletteSize + (address & 0x3FF)); }
+	// resend all video memory with the next line, after it's changed outside
+	// the memory write functions
+	void markAllDirty();
+	// clear the line buffers of the given layers (DISPCNT bits 8-11) before
+	// rendering the next line, in place of CPUUpdateRenderBuffers()
+	void clearLineBuffers(uint layers) { clearLayersPending |= layers; }
+	void queueLine(GBALCD &lcd, const GBAMem::IoMem &ioMem);
+	// block until all queued lines are rendered
+	void waitForIdle();
+	// copy the renderer's state back for inline rendering, including any
+	// pending line buffer clears, only valid when idle
+	void copyRenderState(GBALCD &lcd) const;
+
+private:
+	static constexpr uint vramSize = 0x20000;
+	static constexpr uint paletteSize = 0x400;
+	static constexpr uint oamSize = 0x400;
+	static constexpr uint blockBits = 6;
+	static constexpr uint blockSize = 1 << blockBits;
+	static constexpr uint blocks = (vramSize + paletteSize + oamSize) / blockSize;
+	static constexpr uint dirtyWords = (blocks + 31) / 32;
+	// power of 2 holding more than a copy of all video memory
+	static constexpr uint dataCapacity = 4096;
+	static_assert(dataCapacity >= blocks, "data ring can't hold all video memory");
+	static constexpr uint lineCapacity = 256;
+	// display registers up to & including COLY are read by the renderers
+	static constexpr uint lineRegsSize = 0x56;
+
+	struct LineCommand
+	{
+		GBALCD::RenderLineFunc renderLine;
+		MixColorType *lineMix;
+		GBAMem::IoMem ioMem;
+		uint layerEnable;
+		int gfxBG2Changed;
+		int gfxBG3Changed;
+		uint32 dataEnd;
+		uint clearLayers;
+	};
+
+	struct DataBlock
+	{
+		uint32 index;
+		u8 data[blockSize] __attribute__ ((aligned(4)));
+	};
+
+	// emulation thread state
+	u32 dirtyBits[dirtyWords]{};
+	bool anyDirty = false;
+	uint clearLayersPending = 0;
+	uint32 dataWrite = 0;
+
+	// shared state
+	std::atomic<uint32> lineWrite{};
+	std::atomic<uint32> lineRead{};
+	std::atomic<uint32> dataRead{};
+	std::atomic_bool waitingForIdle{};
+	std::atomic_bool quit{};
+	IG::Semaphore workSem{0}, idleSem{0};
+	LineCommand line[lineCapacity];
+	DataBlock data[dataCapacity];
+
+	// render thread state
+	GBALCD lcd;
+	uint win0H = 0x10000, win1H = 0x10000;
+
+	IG::thread thread;
+
+	void markDirty(u32 offset)
+	{
+		dirtyBits[offset >> (blockBits + 5)] |= 1u << ((offset >> blockBits) & 31);
+		anyDirty = true;
+	}
+	const u8 *blockSource(const GBALCD &srcLcd, uint index) const;
+	u8 *blockDest(uint index);
+	void run();
+	void renderLine(const LineCommand &cmd);
+};
+
+#endif
@@ -0,0 +1,231 @@
+/*  Renders synthetic scenes with the Mode 0-5 line renderers, either inline
+	or through GBARenderThread, & prints a hash of every frame. Each scene
+	starts from random video memory & registers, then makes random VRAM,
+	palette, OAM, display register, layer & renderer changes between lines.
+	The threaded run also stops & restarts the render thread mid-run for
+	some seeds, like changing the option while a game runs.
+	usage: rendertest <inline|threaded> <frames> */
+
+#include "GBA.h"
+#include "GBAGfx.h"
+#include "RenderThread.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+
+CLINK void logger_printf(LoggerSeverity, const char *, ...) {}
+CLINK void bug_doExit(const char *, ...) { abort(); }
+
+// same as in GBA.cpp, which would pull in the rest of the core
+void GBALCD::updateWindow(bool gfxInWin[240], u16 WINH)
+{
+	int x00 = WINH >> 8;
+	int x01 = WINH & 255;
+	if(x00 <= x01)
+	{
+		for(int i = 0; i < 240; i++)
+			gfxInWin[i] = (i >= x00 && i < x01);
+	}
+	else
+	{
+		for(int i = 0; i < 240; i++)
+			gfxInWin[i] = (i >= x00 || i < x01);
+	}
+}
+
+static const GBALCD::RenderLineFunc renderLineFunc[]
+{
+	mode0RenderLine, mode1RenderLine, mode2RenderLine, mode3RenderLine, mode4RenderLine, mode5RenderLine,
+	mode0RenderLineAll, mode1RenderLineAll, mode2RenderLineAll, mode3RenderLineAll, mode4RenderLineAll, mode5RenderLineAll,
+	mode0RenderLineNoWindow, mode1RenderLineNoWindow, mode2RenderLineNoWindow, mode3RenderLineNoWindow,
+	mode4RenderLineNoWindow, mode5RenderLineNoWindow
+};
+
+enum { AREA_PALETTE, AREA_VRAM, AREA_OAM };
+
+struct Scene
+{
+	GBALCD lcd{};
+	GBAMem::IoMem io{};
+	std::unique_ptr<GBARenderThread> renderThread{};
+	std::mt19937 rng;
+
+	Scene(unsigned seed): rng{seed}
+	{
+		for(u32 a = 0; a < 0x18000; a += 2)
+			write16(AREA_VRAM, a, rng());
+		for(u32 a = 0; a < 0x400; a += 2)
+		{
+			write16(AREA_PALETTE, a, rng());
+			write16(AREA_OAM, a, rng());
+		}
+		for(unsigned i = 0; i < 0x56; i++)
+			io.b[i] = rng();
+		io.DISPCNT &= 0xFF77;
+		lcd.layerEnable = io.DISPCNT;
+		GBALCD::updateWindow(lcd.gfxInWin0, io.WIN0H);
+		GBALCD::updateWindow(lcd.gfxInWin1, io.WIN1H);
+	}
+
+	// like the CPUWriteHalfWord video memory cases
+	void write16(unsigned area, u32 addr, u16 v)
+	{
+		switch(area)
+		{
+			case AREA_PALETTE:
+				WRITE16LE((u16*)&lcd.paletteRAM[addr & 0x3FE], v);
+				if(renderThread)
+					renderThread->markPaletteDirty(addr);
+				break;
+			case AREA_VRAM:
+				addr &= 0x17FFE;
+				WRITE16LE((u16*)&lcd.vram[addr], v);
+				if(renderThread)
+					renderThread->markVRAMDirty(addr);
+				break;
+			case AREA_OAM:
+				WRITE16LE((u16*)&lcd.oam[addr & 0x3FE], v);
+				if(renderThread)
+					renderThread->markOAMDirty(addr);
+				break;
+		}
+	}
+
+	// like CPUUpdateRenderBuffers()
+	void clearLineBuffers(bool force)
+	{
+		uint layers = force ? 0x0F00 : (~lcd.layerEnable & 0x0F00);
+		if(renderThread)
+		{
+			renderThread->clearLineBuffers(layers);
+			return;
+		}
+		if(layers & 0x0100)
+			gfxClearArray(lcd.line0);
+		if(layers & 0x0200)
+			gfxClearArray(lcd.line1);
+		if(layers & 0x0400)
+			gfxClearArray(lcd.line2);
+		if(layers & 0x0800)
+			gfxClearArray(lcd.line3);
+	}
+
+	void changeBetweenLines()
+	{
+		unsigned changes = rng() % 8;
+		for(unsigned i = 0; i < changes; i++)
+		{
+			switch(rng() % 10)
+			{
+				case 0 ... 2: write16(AREA_VRAM, rng() % 0x18000, rng()); break;
+				case 3: write16(AREA_PALETTE, rng() % 0x400, rng()); break;
+				case 4: write16(AREA_OAM, rng() % 0x400, rng()); break;
+				case 5:
+				{
+					// any display register except DISPSTAT
+					unsigned reg = 0x08 + (rng() % 0x24) * 2;
+					if(reg == 0x0C)
+						break;
+					WRITE16LE((u16*)&io.b[reg], rng());
+					if(reg == 0x40)
+						GBALCD::updateWindow(lcd.gfxInWin0, io.WIN0H);
+					if(reg == 0x42)
+						GBALCD::updateWindow(lcd.gfxInWin1, io.WIN1H);
+					break;
+				}
+				case 6:
+					io.BG2X_L = rng();
+					lcd.gfxBG2Changed |= 1;
+					break;
+				case 7:
+					io.WIN0H = rng();
+					GBALCD::updateWindow(lcd.gfxInWin0, io.WIN0H);
+					break;
+				case 8:
+				{
+					// new mode & layer enables
+					u16 dispCnt = (io.DISPCNT & ~0x7F07) | (rng() & 0x7F00) | (rng() % 6);
+					bool layersChanged = (io.DISPCNT ^ dispCnt) & 0x0F00;
+					io.DISPCNT = dispCnt;
+					lcd.layerEnable = dispCnt;
+					if(layersChanged)
+						clearLineBuffers(false);
+					break;
+				}
+				case 9:
+					lcd.renderLine = renderLineFunc[rng() % std::size(renderLineFunc)];
+					if(rng() % 16 == 0)
+						clearLineBuffers(true);
+					break;
+			}
+		}
+	}
+
+	void runFrame()
+	{
+		for(unsigned line = 0; line < 160; line++)
+		{
+			changeBetweenLines();
+			io.VCOUNT = line;
+			lcd.lineMix = &lcd.pix[240 * line];
+			if(renderThread)
+				renderThread->queueLine(lcd, io);
+			else
+				lcd.renderLine(lcd.lineMix, lcd, io);
+		}
+		if(renderThread)
+			renderThread->waitForIdle();
+	}
+
+	void setRenderThread(bool on)
+	{
+		if(on == (bool)renderThread)
+			return;
+		if(on)
+			renderThread = std::make_unique<GBARenderThread>(lcd);
+		else
+		{
+			renderThread->copyRenderState(lcd);
+			renderThread.reset();
+		}
+	}
+
+	u64 hash() const
+	{
+		// FNV-1a
+		u64 h = 0xcbf29ce484222325;
+		auto p = (const u8*)lcd.pix;
+		for(size_t i = 0; i < sizeof(lcd.pix); i++)
+			h = (h ^ p[i]) * 0x100000001b3;
+		return h;
+	}
+};
+
+int main(int argc, char **argv)
+{
+	if(argc < 3 || (strcmp(argv[1], "inline") && strcmp(argv[1], "threaded")))
+	{
+		fprintf(stderr, "usage: %s <inline|threaded> <frames>\n", argv[0]);
+		return 1;
+	}
+	bool threaded = !strcmp(argv[1], "threaded");
+	unsigned frames = atoi(argv[2]);
+	for(unsigned seed = 1; seed <= 4; seed++)
+	{
+		auto scene = std::make_unique<Scene>(seed);
+		scene->setRenderThread(threaded);
+		// seeds 3 & 4 switch between inline & threaded rendering every ~50 frames
+		std::mt19937 toggleRng{seed * 77};
+		for(unsigned f = 0; f < frames; f++)
+		{
+			scene->runFrame();
+			printf("seed %u frame %u: %016llx\n", seed, f, (unsigned long long)scene->hash());
+			if(threaded && seed >= 3 && toggleRng() % 50 == 0)
+				scene->setRenderThread(!scene->renderThread);
+		}
+		scene->setRenderThread(false);
+	}
+	return 0;
+}
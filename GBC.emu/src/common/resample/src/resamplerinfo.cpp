@@ -24,6 +24,7 @@
 // #include "blackmansinc.h"
 #include "rectsinc.h"
 #include "linint.h"
+#include "simdpolyphase.h"
 
 static Resampler * createLinint(long inRate, long outRate, std::size_t ) {
 	return new Linint<ResamplerInfo::channels>(inRate, outRate);
@@ -36,6 +37,7 @@ ResamplerInfo const ResamplerInfo::resamplers_[] = {
 // 	{ "Blackman windowed sinc (~70 dB SNR)", ChainResampler::create<BlackmanSinc> },
 	{ "Very high quality (polyphase FIR)", ChainResampler::create<Kaiser50Sinc> },
 	{ "Highest quality (polyphase FIR)", ChainResampler::create<Kaiser70Sinc> },
+	{ "High quality (SIMD polyphase FIR)", SimdPolyphaseResampler<ResamplerInfo::channels>::create },
 };
 
 std::size_t const ResamplerInfo::num_ =
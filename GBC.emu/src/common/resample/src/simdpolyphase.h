@@ -0,0 +1,87 @@
+/*  This file is part of GBC.emu.
+
+	GBC.emu is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	GBC.emu is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with GBC.emu.  If not, see <http://www.gnu.org/licenses/> */
+
+#ifndef SIMDPOLYPHASE_H
+#define SIMDPOLYPHASE_H
+
+#include "../resampler.h"
+#include "array.h"
+#include "cic4.h"
+#include <imagine/util/audio/PolyphaseResampler.hh>
+#include <algorithm>
+
+// Decimates with a CIC filter until the rate is within ~10x of the output,
+// like ChainResampler, then finishes with imagine's SIMD polyphase FIR,
+// which handles the fractional part of the ratio in a single stage.
+
+template<unsigned channels>
+class SimdPolyphaseResampler : public Resampler {
+public:
+	static Resampler * create(long inRate, long outRate, std::size_t periodSize) {
+		return new SimdPolyphaseResampler(inRate, outRate, periodSize);
+	}
+
+	virtual void adjustRate(long inRate, long outRate) {
+		fir_.setRate(inRate, outRate * cicDiv_);
+		setRate(inRate, outRate);
+	}
+
+	virtual void exactRatio(unsigned long &mul, unsigned long &div) const {
+		mul = outRate();
+		div = inRate();
+	}
+
+	virtual std::size_t maxOut(std::size_t inlen) const {
+		return fir_.maxOut(inlen / cicDiv_ + 1);
+	}
+
+	virtual std::size_t resample(short *out, short const *in, std::size_t inlen) {
+		if (cicDiv_ > 1) {
+			std::size_t const decimated = cic_.resample(buffer_, in, inlen);
+			return fir_.resample(out, buffer_, decimated);
+		}
+		return fir_.resample(out, in, inlen);
+	}
+
+private:
+	enum { cic_limit = 5 };
+
+	unsigned const cicDiv_;
+	Cic4<channels> cic_;
+	Array<short> buffer_;
+	Audio::PolyphaseResampler fir_;
+
+	SimdPolyphaseResampler(long inRate, long outRate, std::size_t periodSize)
+	: Resampler(inRate, outRate)
+	, cicDiv_(cicDivFor(inRate, outRate))
+	, cic_(cicDiv_)
+	, buffer_(cicDiv_ > 1 ? (periodSize / cicDiv_ + 1) * channels : 0)
+	{
+		// the FIR sees the decimated rate by scaling the output rate instead,
+		// keeping the rates integral
+		fir_.init(inRate, outRate * cicDiv_, channels,
+		          Audio::PolyphaseResampler::defaultTaps,
+		          cicDiv_ > 1 ? 1.0 / Cic4<channels>::gain(cicDiv_) : 1.0);
+	}
+
+	static unsigned cicDivFor(long inRate, long outRate) {
+		double const ratio = static_cast<double>(inRate) / outRate;
+		if (ratio < cic_limit * 2)
+			return 1;
+		return std::min<unsigned>(ratio / cic_limit, Cic4<channels>::MAX_DIV);
+	}
+};
+
+#endif
@@ -191,6 +191,32 @@ bool GB::saveState(gambatte::PixelType const *videoBuf, std::ptrdiff_t pitch,
 	return false;
 }
 
+bool GB::saveState(gambatte::PixelType const *videoBuf, std::ptrdiff_t pitch,
+                   std::ostream &stream) {
+	if (p_->cpu.loaded()) {
+		SaveState state;
+		p_->cpu.setStatePtrs(state);
+		p_->cpu.saveState(state);
+		return StateSaver::saveState(state, videoBuf, pitch, stream);
+	}
+
+	return false;
+}
+
+bool GB::loadState(std::istream &stream) {
+	if (p_->cpu.loaded()) {
+		SaveState state;
+		p_->cpu.setStatePtrs(state);
+		setInitState(state, p_->cpu.isCgb(), p_->loadflags & GBA_CGB);
+		if (StateSaver::loadState(state, stream)) {
+			p_->cpu.loadState(state);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void GB::selectState(int n) {
 	n -= (n / 10) * 10;
 	p_->stateNo = n < 0 ? n + 10 : n;
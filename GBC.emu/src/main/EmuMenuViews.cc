@@ -4,7 +4,7 @@
 #include "internal.hh"
 #include <resample/resamplerinfo.h>
 
-static constexpr uint MAX_RESAMPLERS = 4;
+static constexpr uint MAX_RESAMPLERS = 5;
 
 class CustomAudioOptionView : public AudioOptionView
 {
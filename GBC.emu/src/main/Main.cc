@@ -16,12 +16,16 @@
 #define LOGTAG "main"
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
+#include <emuframework/EmuLibrary.hh>
 #include <gambatte.h>
 #include <resample/resampler.h>
 #include <resample/resamplerinfo.h>
 #include <main/Cheats.hh>
 #include <main/Palette.hh>
 #include "internal.hh"
+#include <algorithm>
+#include <istream>
+#include <ostream>
 
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2014\nRobert Broglia\nwww.explusalpha.com\n\n(c) 2011\nthe Gambatte Team\ngambatte.sourceforge.net";
 gambatte::GB gbEmu;
@@ -37,6 +41,7 @@ static constexpr auto pixFmt = IG::PIXEL_FMT_RGBA8888;
 #endif
 
 bool EmuSystem::hasCheats = true;
+bool EmuSystem::hasMemoryStates = true;
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter =
 	[](const char *name)
 	{
@@ -116,6 +121,74 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return {};
 }
 
+// stream buffer writing into a ByteBuffer, growing it as needed
+class ByteBufferStreamBuf : public std::streambuf
+{
+public:
+	ByteBufferStreamBuf(IG::ByteBuffer &buff): buff{buff}
+	{
+		buff.resize(buff.capacity());
+		setp((char*)buff.data(), (char*)buff.data() + buff.size());
+	}
+
+	bool finish()
+	{
+		return !failed && buff.resize(pptr() - pbase());
+	}
+
+protected:
+	IG::ByteBuffer &buff;
+	bool failed = false;
+
+	int_type overflow(int_type c) final
+	{
+		if(traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+		auto used = pptr() - pbase();
+		if(!buff.resize(std::max(size_t(used) * 2, size_t(64 * 1024))))
+		{
+			failed = true;
+			return traits_type::eof();
+		}
+		setp((char*)buff.data(), (char*)buff.data() + buff.size());
+		pbump(used);
+		*pptr() = traits_type::to_char_type(c);
+		pbump(1);
+		return c;
+	}
+};
+
+// stream buffer reading directly from a ByteBuffer's contents
+class ConstByteBufferStreamBuf : public std::streambuf
+{
+public:
+	ConstByteBufferStreamBuf(const IG::ByteBuffer &buff)
+	{
+		auto data = (char*)buff.data();
+		setg(data, data, data + buff.size());
+	}
+};
+
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	ByteBufferStreamBuf buffStream{buff};
+	std::ostream stream{&buffStream};
+	if(!gbEmu.saveState(nullptr, 160, stream) || !buffStream.finish())
+		return makeError("Error saving state");
+	else
+		return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	ConstByteBufferStreamBuf buffStream{buff};
+	std::istream stream{&buffStream};
+	if(!gbEmu.loadState(stream))
+		return makeError("Error loading state");
+	else
+		return {};
+}
+
 void EmuSystem::saveBackupMem()
 {
 	logMsg("saving battery");
@@ -163,6 +236,21 @@ EmuSystem::Error EmuSystem::loadGame(IO &io, OnLoadProgressDelegate)
 	return {};
 }
 
+void EmuSystem::readLibraryMetadata(IO &io, EmuLibraryEntry &entry)
+{
+	// the header's destination code only tells apart Japanese carts,
+	// others fall back to the region in the file name
+	std::array<uint8, 0x150> header;
+	if(io.read(header.data(), header.size()) != (ssize_t)header.size())
+		return;
+	bool isCGB = header[0x143] & 0x80;
+	entry.system = isCGB ? "Game Boy Color" : "Game Boy";
+	// the CGB flag takes the title's last byte
+	entry.title = EmuLibrary::titleFromHeader((const char*)&header[0x134], isCGB ? 15 : 16);
+	if(header[0x14A] == 0)
+		entry.region = EmuLibraryEntry::Region::JAPAN;
+}
+
 void EmuSystem::onPrepareVideo(EmuVideo &video)
 {
 	video.setFormat({{gbResX, gbResY}, pixFmt});
@@ -109,6 +109,7 @@ ifdef hasSCD
  cdrom/CDUtility.cpp \
  cdrom/CDAccess_Image.cpp \
  cdrom/CDAccess.cpp \
+ cdrom/cdromif.cpp \
  string/trim.cpp
 
  cxxExceptions := 1
@@ -28,6 +28,7 @@
  ***************************************************************************/
 
 #include "shared.h"
+#include <imagine/util/container/PerfectHashTable.hh>
 
 #define MAPPER_NONE   (0)
 #define MAPPER_SEGA   (1)
@@ -53,7 +54,7 @@ static struct
 } slot;
 
 /* SMS game database */
-static const rominfo_t game_list[GAME_DATABASE_CNT] =
+static constexpr rominfo_t game_list_entries[GAME_DATABASE_CNT] =
 {
   /* games requiring CODEMASTER mapper (NOTE: extended video modes don't work on Genesis VDP !) */
   {0x29822980, 0, SYSTEM_MS_GAMEPAD, MAPPER_CODIES,      REGION_EUROPE}, /* Cosmic Spacehead */
@@ -147,6 +148,18 @@ static const rominfo_t game_list[GAME_DATABASE_CNT] =
   {0x41C948BF, 0, SYSTEM_SPORTSPAD, MAPPER_SEGA,            REGION_USA}  /* Sports Pad Soccer */
 };
 
+struct rominfo_key_traits
+{
+  using Key = uint32;
+  static constexpr Key key(const rominfo_t &e) { return e.crc; }
+  static constexpr uint64_t hash(Key crc) { return crc; }
+  static constexpr bool equal(Key a, Key b) { return a == b; }
+};
+
+/* hashed at compile time so lookups don't scan the list */
+static constexpr auto game_list = IG::makePerfectHashTable<rominfo_key_traits>(game_list_entries);
+static_assert(game_list.isValid(), "error building SMS game database hash table");
+
 /* 1K trash buffer */
 static uint8 dummy[0x400];
 
@@ -173,16 +186,11 @@ void sms_cart_init(void)
   uint32 crc = crc32(0, cart.rom, cart.romsize);
 
   /* detect cartridge mapper */
-  int i;
-  for (i=0; i<GAME_DATABASE_CNT; i++)
+  if (auto game = game_list.find(crc))
   {
-    if (crc == game_list[i].crc)
-    {
-      cart.special = game_list[i].glasses_3d;
-      slot.mapper = game_list[i].mapper;
-      device = game_list[i].peripheral;
-      i = GAME_DATABASE_CNT;
-    }
+    cart.special = game->glasses_3d;
+    slot.mapper = game->mapper;
+    device = game->peripheral;
   }
 
   /* initialize Z80 write handler */
@@ -335,19 +343,15 @@ int sms_cart_region_detect(void)
   uint32 crc = crc32(0, cart.rom, cart.romsize);
 
   /* detect game region */
-  int i;
-  for (i=0; i<GAME_DATABASE_CNT; i++)
+  if (auto game = game_list.find(crc))
   {
-    if (crc == game_list[i].crc)
+    /* Turma da Mônica em: O Resgate & Wonder Boy III enable FM support on japanese hardware only */
+    if (config_ym2413_enabled && ((crc == 0x22CCA9BB) || (crc == 0x679E1676)))
     {
-      /* Turma da Mônica em: O Resgate & Wonder Boy III enable FM support on japanese hardware only */
-      if (config_ym2413_enabled && ((crc == 0x22CCA9BB) || (crc == 0x679E1676)))
-      {
-        return REGION_JAPAN_NTSC;
-      }
-
-      return game_list[i].region;
+      return REGION_JAPAN_NTSC;
     }
+
+    return game->region;
   }
 
   /* default region */
@@ -351,6 +351,7 @@ unsigned int io_68k_read(unsigned int offset)
     case 0x03:  /* Port C Data */
     {
       unsigned int mask = 0x80 | io_reg[offset + 3];
+      osd_input_Poll();
       unsigned int data = port[offset-1].data_r();
       return (io_reg[offset] & mask) | (data & ~mask);
     }
@@ -550,6 +551,8 @@ unsigned int io_z80_read(unsigned int offset)
 
 unsigned int io_z80_read(unsigned int offset)
 {
+  osd_input_Poll();
+
   /* Read port A & port B input data */
   unsigned int data = (port[0].data_r()) | (port[1].data_r() << 8);
 
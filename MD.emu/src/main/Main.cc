@@ -38,6 +38,7 @@
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2014\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nGenesis Plus Team\ncgfm2.emuviews.com";
 bool EmuSystem::hasCheats = true;
 bool EmuSystem::hasPALVideoSystem = true;
+bool EmuSystem::hasMemoryStates = true;
 t_config config{};
 uint config_ym2413_enabled = 1;
 int8 mdInputPortDev[2]{-1, -1};
@@ -172,6 +173,21 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 	return loadMDState(path);
 }
 
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	if(!buff.resize(maxSaveStateSize))
+		return makeError("Out of memory");
+	buff.resize(state_save(buff.data()));
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	if(!buff)
+		return makeFileReadError();
+	return state_load(buff.data());
+}
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(!gameIsRunning())
@@ -360,14 +376,14 @@ FS::PathString EmuSystem::willLoadGameFromPath(FS::PathString path)
 EmuSystem::Error EmuSystem::loadGame(IO &io, OnLoadProgressDelegate)
 {
 	#ifndef NO_SCD
-	CDAccess *cd{};
+	CDIF *cd{};
 	if(hasMDCDExtension(gameFileName().data()) ||
 		(string_hasDotExtension(gameFileName().data(), "bin") && FS::file_size(fullGamePath()) > 1024*1024*10)) // CD
 	{
 		FS::current_path(gamePath());
 		try
 		{
-			cd = CDAccess_Open(fullGamePath(), false);
+			cd = CDIF_Open(fullGamePath(), false);
 		}
 		catch(std::exception &e)
 		{
@@ -382,7 +398,7 @@ EmuSystem::Error EmuSystem::loadGame(IO &io, OnLoadProgressDelegate)
 	  else
 	  {
 	  	uint8 bootSector[2048];
-	  	cd->Read_Sector(bootSector, 0, 2048);
+	  	cd->ReadSector(bootSector, 0, 1);
 			region = detectISORegion(bootSector);
 	  }
 
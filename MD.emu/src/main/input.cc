@@ -123,6 +123,11 @@ void EmuSystem::handleInputAction(uint state, uint emuKey)
 	padData = IG::setOrClearBits(padData, (uint16)emuKey, state == Input::PUSHED);
 }
 
+void osd_input_Poll()
+{
+	EmuSystem::pollInput();
+}
+
 bool EmuSystem::handlePointerInputEvent(Input::Event e, IG::WindowRect gameRect)
 {
 	const int gunDevIdx = 4;
@@ -11,6 +11,8 @@ void ROMCheatUpdate();
 #include <fileio/fileio.h>
 
 static void osd_input_Update() { }
+// apply input received since the frame started, called before reading the I/O ports
+void osd_input_Poll();
 
 #define GG_ROM    "./ggenie.bin"
 #define AR_ROM    "./areplay.bin"
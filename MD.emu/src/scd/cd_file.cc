@@ -23,13 +23,15 @@
 
 bool MDFN_GetSettingB(const char *name) { return 0; }
 
-static CDAccess *cdImage = nullptr;
+// sectors are read through CDIF's read thread, which prefetches the ones
+// following each request & decodes compressed audio tracks ahead of playback
+static CDIF *cdImage = nullptr;
 
-int Load_ISO(CDAccess *cd)
+int Load_ISO(CDIF *cd)
 {
 	_scd_track *Tracks = sCD.TOC.Tracks;
 	CDUtility::TOC toc;
-	cd->Read_TOC(&toc);
+	cd->ReadTOC(&toc);
 	uint currLBA = 0;
 	sCD.cddaLBA = 0;
 	sCD.cddaDataLeftover = 0;
@@ -65,14 +67,32 @@ void Unload_ISO(void)
 	}
 }
 
-static void readLBA(void *dest, int lba)
+static bool readLBA(void *dest, int lba)
 {
-	cdImage->Read_Sector((uint8*)dest, lba, 2048);
+	uint8 sector[2352 + 96];
+	if(!cdImage->ReadRawSector(sector, lba))
+	{
+		// pass on a blank sector, as the old file read did for unreadable data
+		logErr("error reading data sector %d", lba);
+		memset(dest, 0, 2048);
+		return false;
+	}
+	// user data follows the sync & header, plus the sub-header in mode 2
+	memcpy(dest, &sector[sector[12 + 3] == 2 ? 24 : 16], 2048);
+	return true;
 }
 
-static void readCddaLBA(void *dest, int lba)
+static bool readCddaLBA(void *dest, int lba)
 {
-	cdImage->Read_Sector((uint8*)dest, lba, 2352);
+	uint8 sector[2352 + 96];
+	if(!cdImage->ReadRawSector(sector, lba))
+	{
+		logErr("error reading audio sector %d", lba);
+		memset(dest, 0, 2352);
+		return false;
+	}
+	memcpy(dest, sector, 2352);
+	return true;
 }
 
 int readCDDA(void *dest, uint size)
@@ -86,7 +106,7 @@ int readCDDA(void *dest, uint size)
 		{
 			//logMsg("reading %d frames of left-over CDDA", cddaDataLeftover);
 			int32 cddaSector[588];
-			cdImage->Read_Sector((uint8*)cddaSector, sCD.cddaLBA, 2352);
+			readCddaLBA(cddaSector, sCD.cddaLBA);
 			uint copySize = std::min((uint)sCD.cddaDataLeftover, sizeToWrite);
 			memcpy(cddaBuffPos, cddaSector + (588-sCD.cddaDataLeftover), copySize*4);
 			sCD.cddaDataLeftover -= copySize;
@@ -98,7 +118,7 @@ int readCDDA(void *dest, uint size)
 		while(sizeToWrite >= 588)
 		{
 			//logMsg("reading 588 frames");
-			cdImage->Read_Sector((uint8*)cddaBuffPos, sCD.cddaLBA, 2352);
+			readCddaLBA(cddaBuffPos, sCD.cddaLBA);
 			sCD.cddaLBA++;
 			cddaBuffPos += 588;
 			sizeToWrite -= 588;
@@ -107,7 +127,7 @@ int readCDDA(void *dest, uint size)
 		{
 			//logMsg("reading %d frames left", sizeToWrite);
 			int32 cddaSector[588];
-			cdImage->Read_Sector((uint8*)cddaSector, sCD.cddaLBA, 2352);
+			readCddaLBA(cddaSector, sCD.cddaLBA);
 			memcpy(cddaBuffPos, cddaSector, sizeToWrite*4);
 			sCD.cddaDataLeftover = 588 - sizeToWrite;
 		}
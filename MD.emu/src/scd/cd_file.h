@@ -1,6 +1,6 @@
 #pragma once
 
-#include <mednafen/cdrom/CDAccess.h>
+#include <mednafen/cdrom/cdromif.h>
 
 #define TYPE_ISO 1
 #define TYPE_BIN 2
@@ -8,7 +8,7 @@
 //#define TYPE_WAV 4
 
 
-int Load_ISO(CDAccess *cd);
+int Load_ISO(CDIF *cd);
 //int  Load_ISO(const char *iso_name, int is_bin);
 void Unload_ISO(void);
 int  FILE_Read_One_LBA_CDC(void);
@@ -201,7 +201,7 @@ void Reset_CD(void)
 }
 
 
-int Insert_CD(CDAccess *cd)
+int Insert_CD(CDIF *cd)
 {
 	int ret = 0;
 
@@ -6,7 +6,7 @@
 #include "cd_sys.h"
 #include "gfx_cd.h"
 #include <genplus-gx/m68k/musashi/InstructionCycleTableSCD.hh>
-#include <mednafen/cdrom/CDAccess.h>
+#include <mednafen/cdrom/cdromif.h>
 #include <imagine/util/builtins.h>
 
 struct SegaCD
@@ -120,5 +120,5 @@ void scd_updateCddaVol();
 int scd_saveState(uint8 *state);
 int scd_loadState(uint8 *state, uint exVersion);
 
-int Insert_CD(CDAccess *cd);
+int Insert_CD(CDIF *cd);
 void Stop_CD();
@@ -40,6 +40,7 @@ extern "C" {
 #include <string.h>
 #include <imagine/util/builtins.h>
 #include <imagine/util/algorithm.h>
+#include <imagine/util/container/PerfectHashTable.hh>
 #include <imagine/logger/logger.h>
 // throw_exception.hpp, Boost 1.50
 #define UUID_AA15E74A856F11E08B8D93F24824019B
@@ -53,11 +54,26 @@ struct RomDBInfo
 	uint romType;
 };
 
-static const RomDBInfo romDB[] =
+static constexpr RomDBInfo romDBEntries[] =
 {
 #include "EmbeddedRomDBData.h"
 };
 
+struct RomDBKeyTraits
+{
+	using Key = const uint *;
+	static constexpr Key key(const RomDBInfo &e) { return e.digest; }
+	// SHA1 words are already uniformly distributed
+	static constexpr uint64_t hash(Key digest) { return (uint64_t)digest[0] << 32 | digest[1]; }
+	static constexpr bool equal(Key a, Key b)
+	{
+		return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3] && a[4] == b[4];
+	}
+};
+
+static constexpr auto romDB = IG::makePerfectHashTable<RomDBKeyTraits>(romDBEntries);
+static_assert(romDB.isValid(), "error building ROM DB hash table");
+
 struct MediaType {
     constexpr MediaType(RomType rt) : romType(rt) {}
 
@@ -556,21 +572,12 @@ extern "C" MediaType* mediaDbLookupRom(const void *buffer, int size)
 		sha1.get_digest(digest);
 		logMsg("rom sha1 0x%X 0x%X 0x%X 0x%X 0x%X", digest[0], digest[1], digest[2], digest[3], digest[4]);
 
-		for(auto e : romDB)
+		if(auto e = romDB.find(digest);
+			e)
 		{
-			int match = 0;
-			iterateTimes(5, i)
-			{
-					if(digest[i] != e.digest[i])
-						break;
-					else match++;
-			}
-			if(match == 5)
-			{
-				logMsg("found match with type %s", romTypeToString(e.romType));
-				staticMediaType = e.romType;
-				return &staticMediaType;
-			}
+			logMsg("found match with type %s", romTypeToString(e->romType));
+			staticMediaType = e->romType;
+			return &staticMediaType;
 		}
 
 		logMsg("rom not in DB");
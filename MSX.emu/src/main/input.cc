@@ -199,23 +199,26 @@ uint EmuSystem::translateInputAction(uint input, bool &turbo)
 	return 0;
 }
 
-void EmuSystem::handleInputAction(uint state, uint emuKey)
+bool EmuSystem::handleUIInputAction(uint &state, uint &emuKey)
 {
-	uint event1 = emuKey & 0xFF;
-	if(event1 == EC_KEYCOUNT)
+	if((emuKey & 0xFF) == EC_KEYCOUNT)
 	{
 		if(state == Input::PUSHED)
 			EmuControls::toggleKeyboard();
+		return true;
 	}
-	else
+	return false;
+}
+
+void EmuSystem::handleInputAction(uint state, uint emuKey)
+{
+	uint event1 = emuKey & 0xFF;
+	assert(event1 < EC_KEYCOUNT);
+	eventMap[event1] = state == Input::PUSHED;
+	uint event2 = emuKey >> 8;
+	if(event2) // extra event for diagonals
 	{
-		assert(event1 < EC_KEYCOUNT);
-		eventMap[event1] = state == Input::PUSHED;
-		uint event2 = emuKey >> 8;
-		if(event2) // extra event for diagonals
-		{
-			eventMap[event2] = state == Input::PUSHED;
-		}
+		eventMap[event2] = state == Input::PUSHED;
 	}
 }
 
@@ -0,0 +1,8 @@
+# optimized build for headless benchmarking, run as: <exec>-bench --bench <game path> [options]
+include $(IMAGINE_PATH)/make/config.mk
+O_RELEASE := 1
+LTO_MODE ?= lto
+target = $(metadata_exec)-bench
+-include $(projectPath)/config.mk
+include $(IMAGINE_PATH)/make/linux-x86_64-gcc.mk
+include $(projectPath)/build.mk
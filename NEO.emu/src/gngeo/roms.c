@@ -23,6 +23,11 @@
 #include <zlib.h>
 #endif
 #include "unzip.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "video.h"
 #include "transpack.h"
@@ -915,9 +920,17 @@ static int allocate_region(ROM_REGION *r, Uint32 size, int region) {
 	return 0;
 }
 
+/* Regions of a version 2 .gno file point into its mapping */
+static Uint8 *gno_map;
+static size_t gno_map_size;
+
+static bool is_gno_mapped(const void *p) {
+	return gno_map && (const Uint8*)p >= gno_map && (const Uint8*)p < gno_map + gno_map_size;
+}
+
 static void free_region(ROM_REGION *r) {
 	DEBUG_LOG("Free Region %p %p %d", r, r->p, r->size);
-	if (r->p)
+	if (r->p && !is_gno_mapped(r->p))
 		free(r->p);
 	r->size = 0;
 	r->p = NULL;
@@ -1557,77 +1570,40 @@ int dr_load_game(char *name, char romerror[1024]) {
 
 #if defined(HAVE_LIBZ)//&& defined (HAVE_MMAP)
 
-static int dump_region(FILE *gno, const ROM_REGION *rom, Uint8 id, Uint8 type,
-		Uint32 block_size, uint verbose) {
+/* Version 2 .gno layout:
+ * header: "gnodmpv2", name[8], flags (Uint32), nb_sec (Uint8), 3 bytes padding
+ * nb_sec section entries: offset (Uint32), size (Uint32), id (Uint8), 3 bytes padding
+ * Each region is stored uncompressed at a GNO_ALIGN aligned offset so the file
+ * can be memory mapped and the regions used in place. */
+#define GNO_ALIGN 0x4000
+#define GNO_HEADER_SIZE 24
+#define GNO_SECTION_SIZE 12
+
+typedef struct GNO_SECTION {
+	const ROM_REGION *rom;
+	Uint8 id;
+} GNO_SECTION;
+
+static Uint32 gno_align(Uint32 offset) {
+	return (offset + GNO_ALIGN - 1) & ~(GNO_ALIGN - 1);
+}
+
+static void add_section(GNO_SECTION *sec, Uint8 *nb_sec, const ROM_REGION *rom, Uint8 id) {
 	if (rom->p == NULL)
-		return false;
-	fwrite(&rom->size, sizeof (Uint32), 1, gno);
-	fwrite(&id, sizeof (Uint8), 1, gno);
-	fwrite(&type, sizeof (Uint8), 1, gno);
-	if (type == 0) {
-		if(verbose) logMsg("Dump %d %08x", id, rom->size);
-		fwrite(rom->p, rom->size, 1, gno);
-	} else {
-		Uint32 nb_block = rom->size / block_size;
-		Uint32 *block_offset;
-		Uint32 cur_offset = 0;
-		long offset_pos;
-		Uint32 i;
-		const Uint8 *inbuf = rom->p;
-		Uint8 *outbuf;
-		uLongf outbuf_len;
-		uLongf outlen;
-		Uint32 outlen32;
-		Uint32 cmpsize = 0;
-		int rc;
-		if(verbose) logMsg("nb_block=%d", nb_block);
-		fwrite(&block_size, sizeof (Uint32), 1, gno);
-		if ((rom->size & (block_size - 1)) != 0) {
-			if(verbose) logMsg("Waring: Block_size and totsize not compatible %x %x\n",
-					rom->size, block_size);
-		}
-		block_offset = malloc(nb_block * sizeof (Uint32));
-		/* Zlib compress output buffer need to be at least the size
-		 of inbuf + 0.1% + 12 byte */
-		outbuf_len = compressBound(block_size);
-		outbuf = malloc(outbuf_len);
-		offset_pos = ftell(gno);
-		fseek(gno, nb_block * 4 + 4, SEEK_CUR); /* Skip all the offset table + the total compressed size */
-
-		for (i = 0; i < nb_block; i++) {
-			cur_offset = ftell(gno);
-			block_offset[i] = cur_offset;
-			outlen = outbuf_len;
-			rc = compress(outbuf, &outlen, inbuf, block_size);
-			if(verbose) logMsg("%d %ld", rc, outlen);
-			//cur_offset += outlen;
-			cmpsize += outlen;
-			if(verbose) logMsg("cmpsize=%d %ld", cmpsize, (long int)sizeof (uLongf));
-			inbuf += block_size;
-			outlen32 = (Uint32) outlen;
-			fwrite(&outlen32, sizeof (Uint32), 1, gno);
-			if(verbose) logMsg("bank %d outlen=%d offset=%d", i, outlen32, cur_offset);
-			fwrite(outbuf, outlen, 1, gno);
-		}
-		free(outbuf);
-		/* Now, write the offset table */
-		fseek(gno, offset_pos, SEEK_SET);
-		fwrite(block_offset, sizeof (Uint32), nb_block, gno);
-		free(block_offset);
-		fwrite(&cmpsize, sizeof (Uint32), 1, gno);
-		if(verbose) logMsg("cmpsize=%d", cmpsize);
-		fseek(gno, 0, SEEK_END);
-		offset_pos = ftell(gno);
-		if(verbose) logMsg("currpos=%li", offset_pos);
-	}
-	return true;
+		return;
+	sec[*nb_sec].rom = rom;
+	sec[*nb_sec].id = id;
+	(*nb_sec)++;
 }
 
 int dr_save_gno(GAME_ROMS *r, char *filename) {
 	FILE *gno;
-	char *fid = "gnodmpv1";
+	char *fid = "gnodmpv2";
 	char fname[9];
+	Uint8 pad[3] = {0};
+	GNO_SECTION sec[10];
 	Uint8 nb_sec = 0;
+	Uint32 offset;
 	int i;
 
 	gn_init_pbar(PBAR_ACTION_SAVEGNO, 4);
@@ -1641,30 +1617,24 @@ int dr_save_gno(GAME_ROMS *r, char *filename) {
 		printf("%02x ", memory.rom.cpu_m68k.p[i]);
 	printf("\n");*/
 
-	if (r->cpu_m68k.p)
-		nb_sec++;
-	if (r->cpu_z80.p)
-		nb_sec++;
-	if (r->adpcma.p)
-		nb_sec++;
-	if (r->adpcmb.p && (r->adpcmb.p != r->adpcma.p))
-		nb_sec++;
-	if (r->game_sfix.p)
-		nb_sec++;
-	if (r->tiles.p)
-		nb_sec += 2; /* Sprite + Sprite usage */
-	if (r->gfix_usage.p)
-		nb_sec++;
+	add_section(sec, &nb_sec, &r->cpu_m68k, REGION_MAIN_CPU_CARTRIDGE);
+	add_section(sec, &nb_sec, &r->cpu_z80, REGION_AUDIO_CPU_CARTRIDGE);
+	add_section(sec, &nb_sec, &r->adpcma, REGION_AUDIO_DATA_1);
+	if (r->adpcmb.p != r->adpcma.p)
+		add_section(sec, &nb_sec, &r->adpcmb, REGION_AUDIO_DATA_2);
+	add_section(sec, &nb_sec, &r->game_sfix, REGION_FIXED_LAYER_CARTRIDGE);
+	add_section(sec, &nb_sec, &r->spr_usage, REGION_SPR_USAGE);
+	add_section(sec, &nb_sec, &r->gfix_usage, REGION_GAME_FIX_USAGE);
 	/* Do we need Custom Bios? */
 	if ((r->info.flags & HAS_CUSTOM_CPU_BIOS)) {
 		logMsg("Has custom CPU BIOS");
-		nb_sec++;
+		add_section(sec, &nb_sec, &r->bios_m68k, REGION_MAIN_CPU_BIOS);
 	}
 	if ((r->info.flags & HAS_CUSTOM_SFIX_BIOS)) {
 		logMsg("Has custom SFIX BIOS");
-		nb_sec++;
+		add_section(sec, &nb_sec, &r->bios_sfix, REGION_FIXED_LAYER_BIOS);
 	}
-
+	add_section(sec, &nb_sec, &r->tiles, REGION_SPRITES);
 
 	/* Header information */
 	fwrite(fid, 8, 1, gno);
@@ -1672,125 +1642,153 @@ int dr_save_gno(GAME_ROMS *r, char *filename) {
 	fwrite(fname, 8, 1, gno);
 	fwrite(&r->info.flags, sizeof (Uint32), 1, gno);
 	fwrite(&nb_sec, sizeof (Uint8), 1, gno);
+	fwrite(pad, 3, 1, gno);
 
-	/* Now each section */
-	dump_region(gno, &r->cpu_m68k, REGION_MAIN_CPU_CARTRIDGE, 0, 0, 0);
-	dump_region(gno, &r->cpu_z80, REGION_AUDIO_CPU_CARTRIDGE, 0, 0, 0);
-	gn_update_pbar(1);
-	dump_region(gno, &r->adpcma, REGION_AUDIO_DATA_1, 0, 0, 0);
-	if (r->adpcma.p != r->adpcmb.p)
-		dump_region(gno, &r->adpcmb, REGION_AUDIO_DATA_2, 0, 0, 0);
-	gn_update_pbar(2);
-	dump_region(gno, &r->game_sfix, REGION_FIXED_LAYER_CARTRIDGE, 0, 0, 0);
-	dump_region(gno, &r->spr_usage, REGION_SPR_USAGE, 0, 0, 0);
-	dump_region(gno, &r->gfix_usage, REGION_GAME_FIX_USAGE, 0, 0, 0);
-	if ((r->info.flags & HAS_CUSTOM_CPU_BIOS)) {
-		dump_region(gno, &r->bios_m68k, REGION_MAIN_CPU_BIOS, 0, 0, 0);
+	/* Section table */
+	offset = gno_align(GNO_HEADER_SIZE + nb_sec * GNO_SECTION_SIZE);
+	for (i = 0; i < nb_sec; i++) {
+		fwrite(&offset, sizeof (Uint32), 1, gno);
+		fwrite(&sec[i].rom->size, sizeof (Uint32), 1, gno);
+		fwrite(&sec[i].id, sizeof (Uint8), 1, gno);
+		fwrite(pad, 3, 1, gno);
+		offset = gno_align(offset + sec[i].rom->size);
 	}
-	if ((r->info.flags & HAS_CUSTOM_SFIX_BIOS)) {
-		dump_region(gno, &r->bios_sfix, REGION_FIXED_LAYER_BIOS, 0, 0, 0);
+	gn_update_pbar(1);
+
+	/* Now each section */
+	offset = gno_align(GNO_HEADER_SIZE + nb_sec * GNO_SECTION_SIZE);
+	for (i = 0; i < nb_sec; i++) {
+		logMsg("Dump %d %08x at %08x", sec[i].id, sec[i].rom->size, offset);
+		fseek(gno, offset, SEEK_SET);
+		if (fwrite(sec[i].rom->p, sec[i].rom->size, 1, gno) != 1) {
+			logMsg("Error writing %s", filename);
+			fclose(gno);
+			remove(filename);
+			return false;
+		}
+		offset = gno_align(offset + sec[i].rom->size);
 	}
 	gn_update_pbar(3);
-	/* TODO, there is a bug in the loading routine, only one compressed (type 1)
-	 * region can be present at the end of the file */
-	dump_region(gno, &r->tiles, REGION_SPRITES, 1, 4096, 0);
-
 
-	fclose(gno);
+	if (fclose(gno) != 0) {
+		remove(filename);
+		return false;
+	}
 	return true;
 }
 
-int read_region(FILE *gno, GAME_ROMS *roms) {
-	Uint32 size;
-	Uint8 lid, type;
-	ROM_REGION *r = NULL;
-	size_t totread = 0;
-	Uint32 cache_size[] = {64, 32, 24, 16, 8, 6, 4, 2, 1, 0};
-	int i = 0;
-
-	/* Read region header */
-	totread = fread(&size, sizeof (Uint32), 1, gno);
-	totread += fread(&lid, sizeof (Uint8), 1, gno);
-	totread += fread(&type, sizeof (Uint8), 1, gno);
-
+static ROM_REGION *gno_region(GAME_ROMS *roms, Uint8 lid) {
 	switch (lid) {
 		case REGION_MAIN_CPU_CARTRIDGE:
-			r = &roms->cpu_m68k;
-			break;
+			return &roms->cpu_m68k;
 		case REGION_AUDIO_CPU_CARTRIDGE:
-			r = &roms->cpu_z80;
-			break;
+			return &roms->cpu_z80;
 		case REGION_AUDIO_DATA_1:
-			r = &roms->adpcma;
-			break;
+			return &roms->adpcma;
 		case REGION_AUDIO_DATA_2:
-			r = &roms->adpcmb;
-			break;
+			return &roms->adpcmb;
 		case REGION_FIXED_LAYER_CARTRIDGE:
-			r = &roms->game_sfix;
-			break;
+			return &roms->game_sfix;
 		case REGION_SPRITES:
-			r = &roms->tiles;
-			break;
+			return &roms->tiles;
 		case REGION_SPR_USAGE:
-			r = &roms->spr_usage;
-			break;
+			return &roms->spr_usage;
 		case REGION_GAME_FIX_USAGE:
-			r = &roms->gfix_usage;
-			break;
+			return &roms->gfix_usage;
 		case REGION_FIXED_LAYER_BIOS:
-			r = &roms->bios_sfix;
-			break;
-		case REGION_MAIN_CPU_BIOS://break;
-			logMsg("reading custom CPU BIOS");
-			r = &roms->bios_m68k;
-			break;
+			return &roms->bios_sfix;
+		case REGION_MAIN_CPU_BIOS:
+			return &roms->bios_m68k;
 		default:
-			return false;
+			return NULL;
 	}
+}
 
-	logMsg("Read region %d %08X type %d\n", lid, size, type);
-	if (type == 0) {
-		/* TODO: Support ADPCM streaming for platform with less that 64MB of Mem */
-		allocate_region(r, size, lid);
-		logMsg("Load %d %08x\n", lid, r->size);
-		totread += fread(r->p, r->size, 1, gno);
-	} else {
-		Uint32 nb_block, block_size;
-		Uint32 cmp_size;
-		totread += fread(&block_size, sizeof (Uint32), 1, gno);
-		nb_block = size / block_size;
-
-		logMsg("Region size=%08X\n", size);
-		r->size = size;
-
-
-		memory.vid.spr_cache.offset = malloc(sizeof (Uint32) * nb_block);
-		totread += fread(memory.vid.spr_cache.offset, sizeof (Uint32), nb_block, gno);
-		memory.vid.spr_cache.gno = gno;
-
-		totread += fread(&cmp_size, sizeof (Uint32), 1, gno);
+/* Point the regions of a version 2 .gno into a private mapping of it. Pages
+ * the emulator never writes stay backed by the file, so the kernel can drop
+ * untouched graphics & sound data instead of keeping a copy in memory. */
+static int open_gno_v2(FILE *gno, GAME_ROMS *r, Uint8 nb_sec, char *filename, char romerror[1024]) {
+	Uint8 table[256 * GNO_SECTION_SIZE];
+	size_t file_size;
+	int i;
 
-		fseek(gno, cmp_size, SEEK_CUR);
+	fseek(gno, GNO_HEADER_SIZE, SEEK_SET);
+	if (fread(table, GNO_SECTION_SIZE, nb_sec, gno) != nb_sec) {
+		sprintf(romerror, "Invalid GNO file");
+		return false;
+	}
+	fseek(gno, 0, SEEK_END);
+	file_size = ftell(gno);
+	for (i = 0; i < nb_sec; i++) {
+		Uint32 offset, size;
+		memcpy(&offset, &table[i * GNO_SECTION_SIZE], sizeof (Uint32));
+		memcpy(&size, &table[i * GNO_SECTION_SIZE + 4], sizeof (Uint32));
+		if (!gno_region(r, table[i * GNO_SECTION_SIZE + 8]) || (size_t)offset + size > file_size) {
+			sprintf(romerror, "Invalid GNO file");
+			return false;
+		}
+	}
+#ifdef HAVE_MMAP
+	gno_map = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(gno), 0);
+	if (gno_map == MAP_FAILED) {
+		gno_map = NULL;
+		sprintf(romerror, "Can't map %s", filename);
+		return false;
+	}
+	gno_map_size = file_size;
+#endif
 
-		/* TODO: Find the best cache size dynamically! */
-		for (i = 0; cache_size[i] != 0; i++) {
-			if (init_sprite_cache(cache_size[i]*1024 * 1024, block_size) == 0) {
-				logMsg("Cache size=%dMB\n", cache_size[i]);
-				break;
-			}
+	for (i = 0; i < nb_sec; i++) {
+		Uint32 offset, size;
+		Uint8 lid = table[i * GNO_SECTION_SIZE + 8];
+		ROM_REGION *reg = gno_region(r, lid);
+		memcpy(&offset, &table[i * GNO_SECTION_SIZE], sizeof (Uint32));
+		memcpy(&size, &table[i * GNO_SECTION_SIZE + 4], sizeof (Uint32));
+		logMsg("Map region %d %08X at %08X", lid, size, offset);
+#ifdef HAVE_MMAP
+		reg->p = gno_map + offset;
+		reg->size = size;
+#else
+		allocate_region(reg, size, lid);
+		fseek(gno, offset, SEEK_SET);
+		if (fread(reg->p, size, 1, gno) != 1) {
+			sprintf(romerror, "Error reading %s", filename);
+			return false;
 		}
+#endif
 	}
 	return true;
 }
 
+static int dr_gno_fid_version(const char *fid) {
+	if (strncmp(fid, "gnodmpv2", 8) == 0)
+		return 2;
+	if (strncmp(fid, "gnodmpv1", 8) == 0)
+		return 1;
+	return 0;
+}
+
+int dr_gno_version(char *filename) {
+	FILE *gno;
+	char fid[8];
+	int version = 0;
+
+	gno = fopen(filename, "rb");
+	if (!gno)
+		return 0;
+	if (fread(fid, 8, 1, gno) == 1)
+		version = dr_gno_fid_version(fid);
+	fclose(gno);
+	return version;
+}
+
 int dr_open_gno(char *filename, char romerror[1024]) {
 	FILE *gno;
 	char fid[9]; // = "gnodmpv1";
 	char name[9] = {0,};
 	GAME_ROMS *r = &memory.rom;
 	Uint8 nb_sec;
-	int i;
+	int version;
 	char *a;
 	size_t totread = 0;
 
@@ -1808,7 +1806,8 @@ int dr_open_gno(char *filename, char romerror[1024]) {
 	}
 
 	totread += fread(fid, 8, 1, gno);
-	if (strncmp(fid, "gnodmpv1", 8) != 0) {
+	version = dr_gno_fid_version(fid);
+	if (!version) {
 		fclose(gno);
 		sprintf(romerror, "Invalid GNO file");
 		return false;
@@ -1821,12 +1820,17 @@ int dr_open_gno(char *filename, char romerror[1024]) {
 	totread += fread(&r->info.flags, sizeof (Uint32), 1, gno);
 	totread += fread(&nb_sec, sizeof (Uint8), 1, gno);
 
-	gn_init_pbar(PBAR_ACTION_LOADGNO, nb_sec);
-	for (i = 0; i < nb_sec; i++) {
-		gn_update_pbar(i);
-		read_region(gno, r);
+	/* Version 1 files are recreated from the ROM set by the caller */
+	if (version != 2) {
+		fclose(gno);
+		sprintf(romerror, "Unsupported GNO version %d", version);
+		return false;
 	}
-	gn_terminate_pbar();
+	if (!open_gno_v2(gno, r, nb_sec, filename, romerror)) {
+		fclose(gno);
+		return false;
+	}
+	fclose(gno);
 
 	if (r->adpcmb.p == NULL) {
 		r->adpcmb.p = r->adpcma.p;
@@ -1866,7 +1870,7 @@ char *dr_gno_romname(char *filename) {
 		return NULL;
 
 	totread += fread(fid, 8, 1, gno);
-	if (strncmp(fid, "gnodmpv1", 8) != 0) {
+	if (!dr_gno_fid_version(fid)) {
 		fclose(gno);
 		logMsg("Invalid GNO file");
 		return NULL;
@@ -1920,8 +1924,16 @@ void dr_free_roms(GAME_ROMS *r) {
 	free_region(&r->bios_sfix);
 
 	free(memory.ng_lo);
-	free(memory.fix_game_usage);
+	if (!is_gno_mapped(memory.fix_game_usage))
+		free(memory.fix_game_usage);
 	free_region(&r->spr_usage);
+#ifdef HAVE_MMAP
+	if (gno_map) {
+		munmap(gno_map, gno_map_size);
+		gno_map = NULL;
+		gno_map_size = 0;
+	}
+#endif
 
 	//free(r->info.name);
 	//free(r->info.longname);
@@ -79,6 +79,7 @@ int dr_save_gno(GAME_ROMS *r,char *filename);
 int dr_load_game(char *zip, char romerror[1024]);
 ROM_DEF *dr_check_zip(const char *filename);
 char *dr_gno_romname(char *filename);
+int dr_gno_version(char *filename);
 int dr_open_gno(char *filename, char romerror[1024]);
 
 #endif
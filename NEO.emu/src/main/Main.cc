@@ -292,7 +292,14 @@ EmuSystem::Error EmuSystem::loadGame(IO &, OnLoadProgressDelegate onLoadProgress
 	logMsg("rom set %s, %s", drv->name, drv->longname);
 	FS::PathString gnoFilename{};
 	string_printf(gnoFilename, "%s/%s.gno", EmuSystem::savePath(), drv->name);
-	if(optionCreateAndUseCache && FS::exists(gnoFilename))
+	bool useGno = optionCreateAndUseCache && FS::exists(gnoFilename);
+	if(useGno && dr_gno_version(gnoFilename.data()) < 2)
+	{
+		// older versions can't be memory mapped, replace it
+		logMsg("%s is an old version", gnoFilename.data());
+		useGno = false;
+	}
+	if(useGno)
 	{
 		logMsg("loading .gno file");
 		char errorStr[1024];
@@ -309,9 +316,9 @@ EmuSystem::Error EmuSystem::loadGame(IO &, OnLoadProgressDelegate onLoadProgress
 			return makeError("%s", errorStr);
 		}
 
-		if(optionCreateAndUseCache && !FS::exists(gnoFilename))
+		if(optionCreateAndUseCache)
 		{
-			logMsg("%s doesn't exist, creating", gnoFilename.data());
+			logMsg("creating %s", gnoFilename.data());
 			#ifdef USE_GENERATOR68K
 			bool swappedBIOS = swapCPUMemForDump();
 			#endif
@@ -174,6 +174,10 @@ void FCEUD_LoadStateFrom(void);
 //you may also need to maintain your own internal state
 void FCEUD_SetInput(bool fourscore, bool microphone, ESI port0, ESI port1, ESIFC fcexp);
 
+//called when the game strobes the joypads, so the driver can update the data
+//joyports point to with input that arrived since the frame started
+void FCEUD_PollInput(void);
+
 
 void FCEUD_MovieRecordTo(void);
 void FCEUD_MovieReplayFrom(void);
@@ -41,6 +41,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <imagine/util/container/PerfectHashTable.hh>
 
 extern SFORMAT FCEUVSUNI_STATEINFO[];
 
@@ -238,24 +239,30 @@ static void SetInput(void) {
 
 struct BADINF {
 	uint64 md5partial;
-	const char *name;
+	char name[32]; // stored inline so the table needs no relocations
 	uint32 type;
 };
 
-static struct BADINF BadROMImages[] =
+struct BADINFKeyTraits {
+	using Key = uint64;
+	static constexpr Key key(const BADINF &e) { return e.md5partial; }
+	static constexpr uint64_t hash(Key md5partial) { return md5partial; }
+	static constexpr bool equal(Key a, Key b) { return a == b; }
+};
+
+static constexpr BADINF BadROMImageList[] =
 {
 	#include "ines-bad.h"
 };
 
+static constexpr auto BadROMImages = IG::makePerfectHashTable<BADINFKeyTraits>(BadROMImageList);
+static_assert(BadROMImages.isValid(), "error building bad ROM hash table");
+
 void CheckBad(uint64 md5partial) {
-	int32 x = 0;
-	while (BadROMImages[x].name) {
-		if (BadROMImages[x].md5partial == md5partial) {
-			FCEU_PrintError("The copy game you have loaded, \"%s\", is bad, and will not work properly in FCEUX.", BadROMImages[x].name);
-			return;
-		}
-		x++;
-	}
+	auto bad = BadROMImages.find(md5partial);
+	// skip the list's terminating entry
+	if (bad && bad->name[0])
+		FCEU_PrintError("The copy game you have loaded, \"%s\", is bad, and will not work properly in FCEUX.", bad->name);
 }
 
 
@@ -266,6 +273,22 @@ struct CHINF {
 	const char* params;
 };
 
+struct CHINFKeyTraits {
+	using Key = uint32;
+	static constexpr Key key(const CHINF &e) { return e.crc32; }
+	static constexpr uint64_t hash(Key crc32) { return crc32; }
+	static constexpr bool equal(Key a, Key b) { return a == b; }
+};
+
+// the first entry for a CRC is used if it's listed more than once
+static constexpr CHINF CHInfoList[] =
+{
+	#include "ines-correct.h"
+};
+
+static constexpr auto CHInfo = IG::makePerfectHashTable<CHINFKeyTraits>(CHInfoList);
+static_assert(CHInfo.isValid(), "error building header correction hash table");
+
 static const TMasterRomInfo sMasterRomInfo[] = {
 	{ 0x62b51b108a01d2beLL, "bonus=0" }, //4-in-1 (FK23C8021)[p1][!].nes
 	{ 0x8bb48490d8d22711LL, "bonus=0" }, //4-in-1 (FK23C8033)[p1][!].nes
@@ -325,10 +348,6 @@ static void CheckHInfo(void) {
 		0						/* Abandon all hope if the game has 0 in the lower 64-bits of its MD5 hash */
 	};
 
-	static struct CHINF moo[] =
-	{
-		#include "ines-correct.h"
-	};
 	int32 tofix = 0, x, mask;
 	uint64 partialmd5 = 0;
 
@@ -353,45 +372,41 @@ static void CheckHInfo(void) {
 		break;
 	}
 
-	x = 0;
-	do {
-		if (moo[x].crc32 == iNESGameCRC32) {
-			if (moo[x].mapper >= 0) {
-				if (moo[x].mapper & 0x800 && VROM_size) {
-					VROM_size = 0;
-					free(VROM);
-					VROM = NULL;
-					tofix |= 8;
-				}
-				if (moo[x].mapper & 0x1000)
-					mask = 0xFFF;
-				else
-					mask = 0xFF;
-				if (MapperNo != (moo[x].mapper & mask)) {
-					tofix |= 1;
-					MapperNo = moo[x].mapper & mask;
-				}
+	// the list's terminating entry has no mapper or mirroring to apply
+	if (auto moo = CHInfo.find(iNESGameCRC32)) {
+		if (moo->mapper >= 0) {
+			if (moo->mapper & 0x800 && VROM_size) {
+				VROM_size = 0;
+				free(VROM);
+				VROM = NULL;
+				tofix |= 8;
 			}
-			if (moo[x].mirror >= 0) {
-				if (moo[x].mirror == 8) {
-					if (Mirroring == 2) {	/* Anything but hard-wired(four screen). */
-						tofix |= 2;
-						Mirroring = 0;
-					}
-				} else if (Mirroring != moo[x].mirror) {
-					if (Mirroring != (moo[x].mirror & ~4))
-						if ((moo[x].mirror & ~4) <= 2)	/* Don't complain if one-screen mirroring
-														needs to be set(the iNES header can't
-														hold this information).
-														*/
-							tofix |= 2;
-					Mirroring = moo[x].mirror;
+			if (moo->mapper & 0x1000)
+				mask = 0xFFF;
+			else
+				mask = 0xFF;
+			if (MapperNo != (moo->mapper & mask)) {
+				tofix |= 1;
+				MapperNo = moo->mapper & mask;
+			}
+		}
+		if (moo->mirror >= 0) {
+			if (moo->mirror == 8) {
+				if (Mirroring == 2) {	/* Anything but hard-wired(four screen). */
+					tofix |= 2;
+					Mirroring = 0;
 				}
+			} else if (Mirroring != moo->mirror) {
+				if (Mirroring != (moo->mirror & ~4))
+					if ((moo->mirror & ~4) <= 2)	/* Don't complain if one-screen mirroring
+													needs to be set(the iNES header can't
+													hold this information).
+													*/
+						tofix |= 2;
+				Mirroring = moo->mirror;
 			}
-			break;
 		}
-		x++;
-	} while (moo[x].mirror >= 0 || moo[x].mapper >= 0);
+	}
 
 	x = 0;
 	while (savie[x] != 0) {
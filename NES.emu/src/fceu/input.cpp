@@ -175,6 +175,15 @@ static DECLFW(B4016)
 
 		//mbg 6/7/08 - I guess he means that the input drivers could track the strobing themselves
 		//I dont see why it is unreasonable here.
+		//pick up input that arrived mid-frame, except when the frame's input
+		//must match what was logged at its start
+		if(FCEUMOV_Mode(MOVIEMODE_INACTIVE) && !FCEUnetplay && GameInfo->type!=GIT_VSUNI)
+		{
+			FCEUD_PollInput();
+			for(int i=0;i<2;i++)
+				if(joyports[i].type==SI_GAMEPAD)
+					joyports[i].driver->Update(i,joyports[i].ptr,joyports[i].attrib);
+		}
 		for(int i=0;i<2;i++)
 			joyports[i].driver->Strobe(i);
 		if(portFC.driver)
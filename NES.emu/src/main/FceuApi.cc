@@ -112,6 +112,8 @@ void FCEUD_ToggleStatusIcon() { }
 
 void FCEUD_MovieRecordTo() { }
 
+void FCEUD_PollInput() { EmuSystem::pollInput(); }
+
 void FCEUD_SaveStateAs() { }
 
 void FCEUD_LoadStateFrom() { }
@@ -31,6 +31,7 @@ const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2014\nRobe
 bool EmuSystem::hasCheats = true;
 bool EmuSystem::hasPALVideoSystem = true;
 bool EmuSystem::hasResetModes = true;
+bool EmuSystem::hasMemoryStates = true;
 uint fceuCheats = 0;
 ESI nesInputPortDev[2]{SI_UNSET, SI_UNSET};
 uint autoDetectedRegion = 0;
@@ -138,6 +139,29 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return {};
 }
 
+// reused between calls to avoid re-allocating on every in-memory state
+static std::vector<u8> memStateVec{};
+
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	EMUFILE_MEMORY ms{&memStateVec};
+	ms.truncate(0);
+	if(!FCEUSS_SaveMS(&ms, 0))
+		return makeFileWriteError();
+	if(!buff.assign(memStateVec.data(), ms.size()))
+		return makeError("Out of memory");
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	memStateVec.assign(buff.data(), buff.data() + buff.size());
+	EMUFILE_MEMORY ms{&memStateVec};
+	if(!FCEUSS_LoadFP(&ms, SSLOADPARAM_NOBACKUP))
+		return makeFileReadError();
+	return {};
+}
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(gameIsRunning())
@@ -347,7 +371,7 @@ void EmuSystem::runFrame(EmuVideo &video, bool renderGfx, bool processGfx, bool
 			auto pix = img.pixmap();
 			IG::Pixmap ppuPix{{{256, 256}, IG::PIXEL_FMT_I8}, buf};
 			auto ppuPixRegion = ppuPix.subPixmap({0, 8}, {256, 224});
-			pix.writeTransformed([](uint8 p){ return nativeCol[p]; }, ppuPixRegion);
+			pix.writePaletted(ppuPixRegion, nativeCol);
 			img.endFrame();
 			if(renderGfx)
 				EmuApp::updateAndDrawEmuVideo();
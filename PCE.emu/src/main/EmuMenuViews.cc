@@ -72,6 +72,31 @@ class CustomSystemOptionView : public SystemOptionView
 		}
 	};
 
+	// takes effect the next time a CD is loaded
+	TextMenuItem cdReadAheadItem[4]
+	{
+		{"8 Sectors", [](){ optionCDReadAhead = 8; }},
+		{"16 Sectors", [](){ optionCDReadAhead = 16; }},
+		{"32 Sectors", [](){ optionCDReadAhead = 32; }},
+		{"64 Sectors", [](){ optionCDReadAhead = 64; }},
+	};
+
+	MultiChoiceMenuItem cdReadAhead
+	{
+		"CD Read-ahead",
+		[]() -> uint
+		{
+			switch(optionCDReadAhead)
+			{
+				case 8: return 0;
+				default: return 1;
+				case 32: return 2;
+				case 64: return 3;
+			}
+		}(),
+		cdReadAheadItem
+	};
+
 public:
 	CustomSystemOptionView(ViewAttachParams attach): SystemOptionView{attach, true}
 	{
@@ -79,6 +104,7 @@ public:
 		item.emplace_back(&arcadeCard);
 		printBiosMenuEntryStr(sysCardPathStr);
 		item.emplace_back(&sysCardPath);
+		item.emplace_back(&cdReadAhead);
 	}
 };
 
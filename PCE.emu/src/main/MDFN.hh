@@ -11,4 +11,5 @@ static MDFNGI *emuSys = &EmulatedPCE_Fast;
 
 enum {
 	CFGKEY_SYSCARD_PATH = 275, CFGKEY_ARCADE_CARD = 276,
+	CFGKEY_CD_READ_AHEAD = 277,
 };
@@ -27,6 +27,7 @@
 #include <mednafen/MemoryStream.h>
 
 const char *EmuSystem::creditsViewStr = CREDITS_INFO_STRING "(c) 2011-2014\nRobert Broglia\nwww.explusalpha.com\n\nPortions (c) the\nMednafen Team\nmednafen.sourceforge.net";
+bool EmuSystem::hasMemoryStates = true;
 FS::PathString sysCardPath{};
 static std::vector<CDIF *> CDInterfaces;
 using Pixel = uint16;
@@ -177,7 +178,7 @@ EmuSystem::Error EmuSystem::loadGame(IO &io, OnLoadProgressDelegate)
 		FS::current_path(gamePath());
 		try
 		{
-			CDInterfaces.push_back(CDIF_Open(fullGamePath(), false));
+			CDInterfaces.push_back(CDIF_Open(fullGamePath(), false, optionCDReadAhead));
 			writeCDMD5();
 			emuSys->LoadCD(&CDInterfaces);
 			PCECD_Drive_SetDisc(false, CDInterfaces[0]);
@@ -423,6 +424,45 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return {};
 }
 
+// reused by every memory state call so run-ahead & rewind don't re-allocate it each frame
+static MemoryStream memStateStream{};
+
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	try
+	{
+		auto &st = memStateStream;
+		st.truncate(0);
+		st.seek(0, SEEK_SET);
+		MDFNSS_SaveSM(&st);
+		if(!buff.assign(st.map(), st.size()))
+			return makeError("Out of memory");
+	}
+	catch(std::exception &e)
+	{
+		return makeError("%s", e.what());
+	}
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	try
+	{
+		auto &st = memStateStream;
+		st.truncate(0);
+		st.seek(0, SEEK_SET);
+		st.write(buff.data(), buff.size());
+		st.seek(0, SEEK_SET);
+		MDFNSS_LoadSM(&st);
+	}
+	catch(std::exception &e)
+	{
+		return makeError("%s", e.what());
+	}
+	return {};
+}
+
 void EmuApp::onCustomizeNavView(EmuApp::NavView &view)
 {
 	const Gfx::LGradientStopDesc navViewGrad[] =
@@ -10,6 +10,7 @@ extern const uint gamepadKeys;
 }
 
 extern Byte1Option optionArcadeCard;
+extern Byte1Option optionCDReadAhead;
 extern FS::PathString sysCardPath;
 extern std::array<uint16, 5> inputBuff;
 extern bool useSixButtonPad;
@@ -19,6 +19,7 @@
 
 const char *EmuSystem::configFilename = "PceEmu.config";
 Byte1Option optionArcadeCard{CFGKEY_ARCADE_CARD, 1};
+Byte1Option optionCDReadAhead{CFGKEY_CD_READ_AHEAD, CDIF_Read_Ahead_Default, false, optionIsValidWithMinMax<1, CDIF_Read_Ahead_Maximum>};
 static PathOption optionSysCardPath{CFGKEY_SYSCARD_PATH, sysCardPath, ""};
 
 const AspectRatioInfo EmuSystem::aspectRatioInfo[] =
@@ -35,6 +36,7 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 	{
 		default: return 0;
 		bcase CFGKEY_ARCADE_CARD: optionArcadeCard.readFromIO(io, readSize);
+		bcase CFGKEY_CD_READ_AHEAD: optionCDReadAhead.readFromIO(io, readSize);
 		bcase CFGKEY_SYSCARD_PATH: optionSysCardPath.readFromIO(io, readSize);
 		logMsg("syscard path %s", sysCardPath.data());
 	}
@@ -44,5 +46,6 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 void EmuSystem::writeConfig(IO &io)
 {
 	optionArcadeCard.writeWithKeyIfNotDefault(io);
+	optionCDReadAhead.writeWithKeyIfNotDefault(io);
 	optionSysCardPath.writeToIO(io);
 }
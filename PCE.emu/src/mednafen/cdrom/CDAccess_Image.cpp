@@ -1000,6 +1000,15 @@ void CDAccess_Image::ImageOpenBinary(const std::string& path, bool isIso)
 	total_sectors += track.sectors;
 }
 
+// FileIO memory maps image files when it can, sectors are then copied straight out of the mapping
+static void ReadTrackData(const CDRFILE_TRACK_INFO *ct, uint8 *buf, uint32 size, long pos)
+{
+ if(ct->MappedData && (uint64)pos + size <= ct->MappedSize)
+  memcpy(buf, ct->MappedData + pos, size);
+ else
+  ct->fp->readAtPos(buf, size, pos);
+}
+
 void CDAccess_Image::Cleanup(void)
 {
  for(int32 track = 0; track < 100; track++)
@@ -1034,6 +1043,15 @@ CDAccess_Image::CDAccess_Image(const std::string& path, bool image_memcache) : N
 		}
 		else
 			ImageOpen(path, image_memcache);
+
+		for(auto &track : Tracks)
+		{
+			if(track.fp && !track.AReader)
+			{
+				track.MappedData = (const uint8*)track.fp->mmapConst();
+				track.MappedSize = track.fp->size();
+			}
+		}
 	 }
 	 catch(...)
 	 {
@@ -1166,7 +1184,7 @@ bool CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 		switch(ct->DIFormat)
 		{
  case DI_FORMAT_AUDIO:
-	ct->fp->readAtPos(buf, 2352, SeekPos);
+	ReadTrackData(ct, buf, 2352, SeekPos);
 	SeekPos += 2352;
 
 	if(ct->RawAudioMSBFirst)
@@ -1174,7 +1192,7 @@ bool CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 	break;
 
  case DI_FORMAT_MODE1:
-	ct->fp->readAtPos(buf + 12 + 3 + 1, 2048, SeekPos);
+	ReadTrackData(ct, buf + 12 + 3 + 1, 2048, SeekPos);
 	SeekPos += 2048;
 	encode_mode1_sector(lba + 150, buf);
 	break;
@@ -1182,12 +1200,12 @@ bool CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
  case DI_FORMAT_MODE1_RAW:
  case DI_FORMAT_MODE2_RAW:
  case DI_FORMAT_CDI_RAW:
-	ct->fp->readAtPos(buf, 2352, SeekPos);
+	ReadTrackData(ct, buf, 2352, SeekPos);
 	SeekPos += 2352;
 	break;
 
  case DI_FORMAT_MODE2:
-	ct->fp->readAtPos(buf + 16, 2336, SeekPos);
+	ReadTrackData(ct, buf + 16, 2336, SeekPos);
 	SeekPos += 2336;
 	encode_mode2_sector(lba + 150, buf);
 	break;
@@ -1196,13 +1214,13 @@ bool CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
  // FIXME: M2F1, M2F2, does sub-header come before or after user data(standards say before, but I wonder
  // about cdrdao...).
  case DI_FORMAT_MODE2_FORM1:
-	ct->fp->readAtPos(buf + 24, 2048, SeekPos);
+	ReadTrackData(ct, buf + 24, 2048, SeekPos);
 	SeekPos += 2048;
 	//encode_mode2_form1_sector(lba + 150, buf);
 	break;
 
  case DI_FORMAT_MODE2_FORM2:
-	ct->fp->readAtPos(buf + 24, 2324, SeekPos);
+	ReadTrackData(ct, buf + 24, 2324, SeekPos);
 	SeekPos += 2324;
 	//encode_mode2_form2_sector(lba + 150, buf);
 	break;
@@ -1210,7 +1228,7 @@ bool CDAccess_Image::Read_Raw_Sector(uint8 *buf, int32 lba)
 		}
 
 		if(ct->SubchannelMode)
-			ct->fp->readAtPos(buf + 2352, 96, SeekPos);
+			ReadTrackData(ct, buf + 2352, 96, SeekPos);
 	 }
 	} // end if audible part of audio track read.
 	return true;
@@ -1280,7 +1298,7 @@ bool CDAccess_Image::Read_Sector(uint8 *buf, int32 lba, uint32 size)
 			MDFN_printf("skipping cdda sector read\n");
 			return false;
 		}
-		ct->fp->readAtPos(buf, 2352, SeekPos);
+		ReadTrackData(ct, buf, 2352, SeekPos);
 
 		if(ct->RawAudioMSBFirst)
 		 Endian_A16_Swap(buf, 588 * 2);
@@ -1292,7 +1310,7 @@ bool CDAccess_Image::Read_Sector(uint8 *buf, int32 lba, uint32 size)
 			MDFN_printf("skipping data sector read\n");
 			return false;
 		}
-		ct->fp->readAtPos(buf, 2048, SeekPos);
+		ReadTrackData(ct, buf, 2048, SeekPos);
 		break;
 
 	case DI_FORMAT_MODE1_RAW:
@@ -1302,7 +1320,7 @@ bool CDAccess_Image::Read_Sector(uint8 *buf, int32 lba, uint32 size)
 			return false;
 		}
 		SeekPos += 12 + 3 + 1;
-		ct->fp->readAtPos(buf, 2048, SeekPos);
+		ReadTrackData(ct, buf, 2048, SeekPos);
 		break;
 			}
 
@@ -24,6 +24,8 @@ struct CDRFILE_TRACK_INFO
 
 	int32 sectors = 0;	// Not including pregap sectors!
 	std::shared_ptr<FileIO> fp;
+	const uint8 *MappedData{};	// fp's memory mapping, if it has one
+	size_t MappedSize = 0;
 	bool FirstFileInstance = 0;
 	bool RawAudioMSBFirst = 0;
 	long FileOffset = 0;
@@ -91,7 +91,7 @@ class CDIF_MT : public CDIF
 {
  public:
 
- CDIF_MT(std::unique_ptr<CDAccess> cda);
+ CDIF_MT(std::unique_ptr<CDAccess> cda, int read_ahead);
  virtual ~CDIF_MT();
 
  virtual void HintReadSector(int32 lba);
@@ -114,7 +114,7 @@ class CDIF_MT : public CDIF
  CDIF_Queue EmuThreadQueue;
 
 
- enum { SBSize = 256 };
+ enum { SBSize = 512 };
  CDIF_Sector_Buffer SectorBuffers[SBSize];
 
  uint32 SBWritePos;
@@ -129,6 +129,7 @@ class CDIF_MT : public CDIF
  int32 ra_lba;
  int32 ra_count;
  int32 last_read_lba;
+ int max_ra;
 };
 
 
@@ -308,9 +309,9 @@ int CDIF_MT::ReadThreadStart()
 
     case CDIF_MSG_READ_SECTOR:
 			 {
-                          static const int max_ra = 16;
 			  static const int initial_ra = 1;
-			  static const int speedmult_ra = 2;
+			  // catch up faster when reading further ahead
+			  const int speedmult_ra = std::max(2, max_ra / 8);
 			  int32 new_lba = msg.args[0];
 
 			  assert((unsigned int)max_ra < (SBSize / 4));
@@ -347,22 +348,29 @@ int CDIF_MT::ReadThreadStart()
 
   if(ra_count)
   {
-   uint8 tmpbuf[2352 + 96];
+   CDIF_Sector_Buffer *sb = &SectorBuffers[SBWritePos];
    bool error_condition = false;
 
+   //
+   // Read straight into the oldest buffer, it's invalidated first so the emu thread won't look at it in the meantime.
+   //
+   MDFND_LockMutex(SBMutex);
+   sb->valid = FALSE;
+   MDFND_UnlockMutex(SBMutex);
+
    //try
    {
-    if(!disc_cdaccess->Read_Raw_Sector(tmpbuf, ra_lba))
+    if(!disc_cdaccess->Read_Raw_Sector(sb->data, ra_lba))
     {
     	MDFN_PrintError(_("Sector %u read error"), ra_lba);
-    	memset(tmpbuf, 0, sizeof(tmpbuf));
+    	memset(sb->data, 0, sizeof(sb->data));
     	error_condition = true;
     }
    }
    /*catch(std::exception &e)
    {
     MDFN_PrintError(_("Sector %u read error: %s"), ra_lba, e.what());
-    memset(tmpbuf, 0, sizeof(tmpbuf));
+    memset(sb->data, 0, sizeof(sb->data));
     error_condition = true;
    }*/
 
@@ -370,10 +378,9 @@ int CDIF_MT::ReadThreadStart()
    //
    MDFND_LockMutex(SBMutex);
 
-   SectorBuffers[SBWritePos].lba = ra_lba;
-   memcpy(SectorBuffers[SBWritePos].data, tmpbuf, 2352 + 96);
-   SectorBuffers[SBWritePos].valid = TRUE;
-   SectorBuffers[SBWritePos].error = error_condition;
+   sb->lba = ra_lba;
+   sb->valid = TRUE;
+   sb->error = error_condition;
    SBWritePos = (SBWritePos + 1) % SBSize;
 
    MDFND_SignalCond(SBCond);
@@ -390,8 +397,11 @@ int CDIF_MT::ReadThreadStart()
  return(1);
 }
 
-CDIF_MT::CDIF_MT(std::unique_ptr<CDAccess> cda) : disc_cdaccess(std::move(cda)), CDReadThread(NULL), SBMutex(NULL), SBCond(NULL)
+CDIF_MT::CDIF_MT(std::unique_ptr<CDAccess> cda, int read_ahead) : disc_cdaccess(std::move(cda)), CDReadThread(NULL), SBMutex(NULL), SBCond(NULL),
+ max_ra(std::max(1, std::min<int>(read_ahead, CDIF_Read_Ahead_Maximum)))
 {
+ static_assert(CDIF_Read_Ahead_Maximum < (SBSize / 4), "read-ahead too large for sector buffers");
+
  try
  {
   CDIF_Message msg;
@@ -508,13 +518,17 @@ bool CDIF_MT::ReadRawSector(uint8 *buf, int32 lba)
 
  do
  {
+  // Search from the most recently read sector back, that's where a sequential read will be.
   for(int i = 0; i < SBSize; i++)
   {
-   if(SectorBuffers[i].valid && SectorBuffers[i].lba == lba)
+   const CDIF_Sector_Buffer &sb = SectorBuffers[(SBWritePos + SBSize - 1 - i) % SBSize];
+
+   if(sb.valid && sb.lba == lba)
    {
-    error_condition = SectorBuffers[i].error;
-    memcpy(buf, SectorBuffers[i].data, 2352 + 96);
+    error_condition = sb.error;
+    memcpy(buf, sb.data, 2352 + 96);
     found = TRUE;
+    break;
    }
   }
 
@@ -857,12 +871,12 @@ Stream *CDIF::MakeStream(int32 lba, uint32 sector_count)
 }
 
 
-CDIF *CDIF_Open(const std::string& path, bool image_memcache)
+CDIF *CDIF_Open(const std::string& path, bool image_memcache, int read_ahead)
 {
  std::unique_ptr<CDAccess> cda(CDAccess_Open(path, image_memcache));
 
  //if(!image_memcache)
-  return new CDIF_MT(std::move(cda));
+  return new CDIF_MT(std::move(cda), read_ahead);
  /*else
   return new CDIF_ST(std::move(cda));*/
 }
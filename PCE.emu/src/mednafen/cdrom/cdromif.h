@@ -61,6 +61,8 @@ class CDIF
  CDUtility::TOC disc_toc;
 };
 
-CDIF *CDIF_Open(const std::string& path, bool image_memcache);
+// read_ahead is the maximum number of sectors the read thread buffers past the last one requested
+enum { CDIF_Read_Ahead_Default = 16, CDIF_Read_Ahead_Maximum = 64 };
+CDIF *CDIF_Open(const std::string& path, bool image_memcache, int read_ahead = CDIF_Read_Ahead_Default);
 
 #endif
@@ -42,9 +42,16 @@ ifeq ($(ARCH), arm)
   yabause/sh2_dynarec/sh2_dynarec.c
  endif
 else ifeq ($(ARCH), x86_64)
- # TODO: x86_64 dynarec has 64/32-bit pointer conversion issues
- #CPPFLAGS += -DCPU_X64=1 -DUSE_DYNAREC=1 -DSH2_DYNAREC=1
- #SRC += yabause/sh2_dynarec/linkage_x64.s yabause/sh2_dynarec/sh2_dynarec.c
+ ifeq ($(ENV), linux)
+  CPPFLAGS += -DCPU_X64=1 \
+  -DUSE_DYNAREC=1 \
+  -DSH2_DYNAREC=1 \
+  -DQ68_USE_JIT=1
+  SRC += yabause/sh2_dynarec/linkage_x64.s \
+  yabause/sh2_dynarec/sh2_dynarec.c \
+  yabause/q68/q68-jit.c \
+  yabause/q68/q68-jit-x86.S
+ endif
 else ifeq ($(ARCH), x86)
  CPPFLAGS += -DCPU_X86=1 \
  -DUSE_DYNAREC=1 \
@@ -87,13 +94,20 @@ yabause/yabause.c \
 yabause/scsp.c \
 yabause/japmodem.c
 
+# the sound thread needs the event queue in thr-linux.c, elsewhere
+# scsp.c falls back to running single-threaded
+ifneq ($(filter linux android, $(ENV)),)
+ SRC += yabause/thr-linux.c
+else
+ SRC += yabause/thr-dummy.c
+endif
+
 #SRC += yabause/c68k/c68kexec.c yabause/c68k/c68k.c yabause/m68kc68k.c
 #CPPFLAGS += -DHAVE_C68K=1
 SRC += yabause/q68/q68.c \
 yabause/q68/q68-core.c \
 yabause/m68kq68.c
 CPPFLAGS += -DHAVE_Q68=1
-# TODO: -DQ68_USE_JIT=1
 
 include $(EMUFRAMEWORK_PATH)/package/emuframework.mk
 
@@ -48,6 +48,23 @@ class CustomSystemOptionView : public SystemOptionView
 		sh2CoreItem
 	};
 
+	TextMenuItem renderThreadsItem[maxRenderThreads + 1]
+	{
+		{"Auto", [](){ optionRenderThreads = 0; }},
+		{"1", [](){ optionRenderThreads = 1; }},
+		{"2", [](){ optionRenderThreads = 2; }},
+		{"3", [](){ optionRenderThreads = 3; }},
+		{"4", [](){ optionRenderThreads = 4; }},
+	};
+
+	// used when the next game loads
+	MultiChoiceMenuItem renderThreads
+	{
+		"Video Render Threads",
+		std::min((uint)optionRenderThreads, maxRenderThreads),
+		renderThreadsItem
+	};
+
 public:
 	CustomSystemOptionView(ViewAttachParams attach): SystemOptionView{attach, true}
 	{
@@ -66,16 +83,41 @@ public:
 			}
 			item.emplace_back(&sh2Core);
 		}
+		item.emplace_back(&renderThreads);
 		printBiosMenuEntryStr(biosPathStr);
 		item.emplace_back(&biosPath);
 	}
 };
 
+class CustomAudioOptionView : public AudioOptionView
+{
+	BoolMenuItem soundThread
+	{
+		"Emulate Sound In Separate Thread",
+		(bool)optionSoundThread,
+		[this](BoolMenuItem &item, View &, Input::Event e)
+		{
+			// used when the next game loads
+			optionSoundThread = item.flipBoolValue(*this);
+			yinit.usethreads = optionSoundThread;
+		}
+	};
+
+public:
+	CustomAudioOptionView(ViewAttachParams attach): AudioOptionView{attach, true}
+	{
+		loadStockItems();
+		if(soundThreadIsSupported)
+			item.emplace_back(&soundThread);
+	}
+};
+
 View *EmuApp::makeCustomView(ViewAttachParams attach, ViewID id)
 {
 	switch(id)
 	{
 		case ViewID::SYSTEM_OPTIONS: return new CustomSystemOptionView(attach);
+		case ViewID::AUDIO_OPTIONS: return new CustomAudioOptionView(attach);
 		default: return nullptr;
 	}
 }
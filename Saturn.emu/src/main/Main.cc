@@ -3,6 +3,7 @@
 #include <emuframework/EmuApp.hh>
 #include <emuframework/EmuAppInlines.hh>
 #include "internal.hh"
+#include <thread>
 
 extern "C"
 {
@@ -36,6 +37,13 @@ bool hasBIOSExtension(const char *name)
 	return string_hasDotExtension(name, "bin");
 }
 
+uint renderThreads()
+{
+	if(optionRenderThreads)
+		return optionRenderThreads;
+	return std::min(std::thread::hardware_concurrency(), maxRenderThreads);
+}
+
 CLINK void DisplayMessage(const char* str) {}
 CLINK int OSDInit(int coreid) { return 0; }
 CLINK void OSDPushMessage(int msgtype, int ttl, const char * message, ...) {}
@@ -288,6 +296,7 @@ void EmuSystem::closeSystem()
 EmuSystem::Error EmuSystem::loadGame(IO &, OnLoadProgressDelegate)
 {
 	string_printf(bupPath, "%s/bkram.bin", savePath());
+	VIDSoftSetNumThreads(renderThreads());
 	if(YabauseInit(&yinit) != 0)
 	{
 		logErr("YabauseInit failed");
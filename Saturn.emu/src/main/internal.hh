@@ -9,12 +9,19 @@ extern "C"
 	#include <yabause/peripheral.h>
 }
 
+// threaded SCSP emulation needs the event queue only in thr-linux.c
+static constexpr bool soundThreadIsSupported = Config::envIsLinux || Config::envIsAndroid;
+// VIDSoft's band thread limit, option value 0 uses one per CPU core
+static constexpr uint maxRenderThreads = 4;
+
 namespace EmuControls
 {
 static const uint gamepadKeys = 23;
 }
 
 extern Byte1Option optionSH2Core;
+extern Byte1Option optionSoundThread;
+extern Byte1Option optionRenderThreads;
 extern FS::PathString biosPath;
 extern SH2Interface_struct *SH2CoreList[];
 extern uint SH2Cores;
@@ -23,3 +30,4 @@ extern const int defaultSH2CoreID;
 extern PerPad_struct *pad[2];
 
 bool hasBIOSExtension(const char *name);
+uint renderThreads();
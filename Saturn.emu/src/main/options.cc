@@ -8,7 +8,8 @@ extern "C"
 
 enum
 {
-	CFGKEY_BIOS_PATH = 279, CFGKEY_SH2_CORE = 280
+	CFGKEY_BIOS_PATH = 279, CFGKEY_SH2_CORE = 280,
+	CFGKEY_SOUND_THREAD = 281, CFGKEY_RENDER_THREADS = 282
 };
 
 SH2Interface_struct *SH2CoreList[]
@@ -38,6 +39,8 @@ static bool OptionSH2CoreIsValid(uint8 val)
 const char *EmuSystem::configFilename = "SaturnEmu.config";
 static PathOption optionBiosPath{CFGKEY_BIOS_PATH, biosPath, ""};
 Byte1Option optionSH2Core{CFGKEY_SH2_CORE, (uchar)defaultSH2CoreID, false, OptionSH2CoreIsValid};
+Byte1Option optionSoundThread{CFGKEY_SOUND_THREAD, 0};
+Byte1Option optionRenderThreads{CFGKEY_RENDER_THREADS, 0, false, optionIsValidWithMax<maxRenderThreads>};
 const AspectRatioInfo EmuSystem::aspectRatioInfo[] =
 {
 		{"4:3 (Original)", 4, 3},
@@ -60,9 +63,24 @@ void EmuSystem::initOptions()
 EmuSystem::Error EmuSystem::onOptionsLoaded()
 {
 	yinit.sh2coretype = optionSH2Core;
+	yinit.usethreads = soundThreadIsSupported && optionSoundThread;
 	return {};
 }
 
+bool EmuSystem::setBenchOption(const char *name, const char *value)
+{
+	if(string_equal(name, "renderThreads"))
+	{
+		char *end;
+		auto threads = strtoul(value, &end, 10);
+		if(end == value || *end || threads > maxRenderThreads)
+			return false;
+		optionRenderThreads = threads;
+		return true;
+	}
+	return false;
+}
+
 bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 {
 	switch(key)
@@ -70,6 +88,8 @@ bool EmuSystem::readConfig(IO &io, uint key, uint readSize)
 		default: return 0;
 		bcase CFGKEY_BIOS_PATH: optionBiosPath.readFromIO(io, readSize);
 		bcase CFGKEY_SH2_CORE: optionSH2Core.readFromIO(io, readSize);
+		bcase CFGKEY_SOUND_THREAD: optionSoundThread.readFromIO(io, readSize);
+		bcase CFGKEY_RENDER_THREADS: optionRenderThreads.readFromIO(io, readSize);
 	}
 	return 1;
 }
@@ -78,4 +98,6 @@ void EmuSystem::writeConfig(IO &io)
 {
 	optionBiosPath.writeToIO(io);
 	optionSH2Core.writeWithKeyIfNotDefault(io);
+	optionSoundThread.writeWithKeyIfNotDefault(io);
+	optionRenderThreads.writeWithKeyIfNotDefault(io);
 }
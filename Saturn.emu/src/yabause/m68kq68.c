@@ -23,6 +23,11 @@
 
 #include "q68/q68.h"
 
+#ifdef Q68_USE_JIT
+# include <string.h>
+# include <sys/mman.h>
+#endif
+
 /*************************************************************************/
 
 /**
@@ -30,10 +35,21 @@
  * functions to convert read/write calls from the native format to the
  * FASTCALL format used by Yabause.
  */
-#ifdef CPU_X86
+#if defined(CPU_X86) || (defined(CPU_X64) && defined(Q68_USE_JIT))
 # define NEED_TRAMPOLINE
 #endif
 
+/**
+ * TRAMPOLINE_ATTR:  Attributes for the trampoline functions.  Translated
+ * code doesn't keep the stack aligned as the ABI requires when it calls
+ * them, so they realign it before calling into Yabause.
+ */
+#ifdef Q68_USE_JIT
+# define TRAMPOLINE_ATTR  __attribute__((force_align_arg_pointer))
+#else
+# define TRAMPOLINE_ATTR  /*nothing*/
+#endif
+
 /**
  * PROFILE_68K: Perform simple profiling of the 68000 emulation, reporting
  * the average time per 68000 clock cycle.  (Realtime execution would be
@@ -85,10 +101,16 @@ static uint32_t dummy_read(uint32_t address);
 static void dummy_write(uint32_t address, uint32_t data);
 
 #ifdef NEED_TRAMPOLINE
-static uint32_t readb_trampoline(uint32_t address);
-static uint32_t readw_trampoline(uint32_t address);
-static void writeb_trampoline(uint32_t address, uint32_t data);
-static void writew_trampoline(uint32_t address, uint32_t data);
+static TRAMPOLINE_ATTR uint32_t readb_trampoline(uint32_t address);
+static TRAMPOLINE_ATTR uint32_t readw_trampoline(uint32_t address);
+static TRAMPOLINE_ATTR void writeb_trampoline(uint32_t address, uint32_t data);
+static TRAMPOLINE_ATTR void writew_trampoline(uint32_t address, uint32_t data);
+#endif
+
+#ifdef Q68_USE_JIT
+static void *jit_malloc(size_t size);
+static void *jit_realloc(void *ptr, size_t size);
+static void jit_free(void *ptr);
 #endif
 
 /*-----------------------------------------------------------------------*/
@@ -160,7 +182,11 @@ static M68K_WRITE *real_writeb, *real_writew;
  */
 static int m68kq68_init(void)
 {
+#ifdef Q68_USE_JIT
+    if (!(state = q68_create_ex(jit_malloc, jit_realloc, jit_free))) {
+#else
     if (!(state = q68_create())) {
+#endif
         return -1;
     }
     q68_set_irq(state, 0);
@@ -502,24 +528,85 @@ static void dummy_write(uint32_t address, uint32_t data)
  *     Value read (only for read_trampoline)
  */
 
-static uint32_t readb_trampoline(uint32_t address) {
+static TRAMPOLINE_ATTR uint32_t readb_trampoline(uint32_t address) {
     return (*real_readb)(address);
 }
 
-static uint32_t readw_trampoline(uint32_t address) {
+static TRAMPOLINE_ATTR uint32_t readw_trampoline(uint32_t address) {
     return (*real_readw)(address);
 }
 
-static void writeb_trampoline(uint32_t address, uint32_t data) {
+static TRAMPOLINE_ATTR void writeb_trampoline(uint32_t address, uint32_t data) {
     return (*real_writeb)(address, data);
 }
 
-static void writew_trampoline(uint32_t address, uint32_t data) {
+static TRAMPOLINE_ATTR void writew_trampoline(uint32_t address, uint32_t data) {
     return (*real_writew)(address, data);
 }
 
 #endif  // NEED_TRAMPOLINE
 
+/*************************************************************************/
+
+#ifdef Q68_USE_JIT
+
+/* Size of the header storing each block's mapped size (kept at 16 bytes
+ * so the data following it stays aligned) */
+#define JIT_ALLOC_HEADER  16
+
+/**
+ * jit_malloc, jit_realloc, jit_free:  Memory allocation functions passed
+ * to q68_create_ex().  Q68 uses these for its native code buffers, which
+ * are executed in place, so unlike memory from malloc() the blocks must be
+ * mapped executable.  Each block is preceded by a header holding its
+ * mapped size.
+ *
+ * [Parameters]
+ *      ptr: Block to resize or free (jit_realloc(), jit_free() only)
+ *     size: Requested size in bytes (jit_malloc(), jit_realloc() only)
+ * [Return value]
+ *     Allocated block (NULL on failure) (jit_malloc(), jit_realloc() only)
+ */
+
+static void *jit_malloc(size_t size)
+{
+    const size_t mapped_size = size + JIT_ALLOC_HEADER;
+    uint8_t *block = mmap(NULL, mapped_size,
+                          PROT_READ | PROT_WRITE | PROT_EXEC,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED) {
+        return NULL;
+    }
+    *(size_t *)block = mapped_size;
+    return block + JIT_ALLOC_HEADER;
+}
+
+static void *jit_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return jit_malloc(size);
+    }
+    const size_t old_size =
+        *(size_t *)((uint8_t *)ptr - JIT_ALLOC_HEADER) - JIT_ALLOC_HEADER;
+    void *new_ptr = jit_malloc(size);
+    if (!new_ptr) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, old_size < size ? old_size : size);
+    jit_free(ptr);
+    return new_ptr;
+}
+
+static void jit_free(void *ptr)
+{
+    if (ptr) {
+        uint8_t *block = (uint8_t *)ptr - JIT_ALLOC_HEADER;
+        munmap(block, *(size_t *)block);
+    }
+}
+
+#endif  // Q68_USE_JIT
+
 /*************************************************************************/
 /*************************************************************************/
 
@@ -455,12 +455,12 @@ void MappedMemoryInit()
                                 &SoundRamWriteByte,
                                 &SoundRamWriteWord,
                                 &SoundRamWriteLong);
-   FillMemoryArea(0x5B0, 0x5BF, &scsp_r_b,
-                                &scsp_r_w,
-                                &scsp_r_d,
-                                &scsp_w_b,
-                                &scsp_w_w,
-                                &scsp_w_d);
+   FillMemoryArea(0x5B0, 0x5BF, &ScspReadByte,
+                                &ScspReadWord,
+                                &ScspReadLong,
+                                &ScspWriteByte,
+                                &ScspWriteWord,
+                                &ScspWriteLong);
    FillMemoryArea(0x5C0, 0x5C7, &Vdp1RamReadByte,
                                 &Vdp1RamReadWord,
                                 &Vdp1RamReadLong,
@@ -1566,11 +1566,11 @@ static int opshft(Q68State *state, uint32_t opcode)
                 }
                 data <<= 1;
             } else {
-                data = (int32_t)data >> (count-1);
+                data >>= count-1;
                 if (data & 1) {
                     state->SR |= SR_X | SR_C;
                 }
-                data = (int32_t)data >> 1;
+                data >>= 1;
             }
             break;
           case 2: {  // ROXL/ROXR
@@ -1595,19 +1595,23 @@ static int opshft(Q68State *state, uint32_t opcode)
             break;
           }
           default: {  // (case 3) ROL/ROR
+            /* C is the last bit rotated out, even for a count that's a
+             * multiple of the operand size */
             count %= nbits;
             if (is_left) {
-                data = (data << count) | (data >> (nbits - count));
-                if ((data >> (nbits-1)) & 1) {
+                if (count > 0) {
+                    data = (data << count) | (data >> (nbits - count));
+                }
+                if (data & 1) {
                     state->SR |= SR_C;
                 }
-                data <<= 1;
             } else {
-                data = (data >> count) | (data << (nbits - count));
-                if (data & 1) {
+                if (count > 0) {
+                    data = (data >> count) | (data << (nbits - count));
+                }
+                if ((data >> (nbits-1)) & 1) {
                     state->SR |= SR_C;
                 }
-                data = (int32_t)data >> 1;
             }
             break;
           }
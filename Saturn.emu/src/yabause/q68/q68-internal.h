@@ -55,16 +55,18 @@
  * may continue to be executed even after the cycle limit has been reached.
  * This allows the translated code to execute more quickly, but will
  * slightly alter the timing of responses to external events such as
- * interrupts.
+ * interrupts.  Saturn sound drivers are timed against the SCSP, so this
+ * is left off and translated code stops at exactly the same cycle as the
+ * interpreter would.
  */
-#define Q68_JIT_LOOSE_TIMING
+// #define Q68_JIT_LOOSE_TIMING
 
 /**
  * Q68_OPTIMIZE_IDLE:  When defined, optimizes certain idle loops to
  * improve performance in JIT mode.  Enabling this option slightly alters
- * execution timing.
+ * execution timing.  Disabled for the same reason as Q68_JIT_LOOSE_TIMING.
  */
-#define Q68_OPTIMIZE_IDLE
+// #define Q68_OPTIMIZE_IDLE
 
 /**
  * Q68_JIT_VERBOSE:  When defined, outputs some status messages considered
@@ -193,6 +195,12 @@ struct Q68State_ {
 
     /**** JIT-related data ****/
 
+    /* C routines called from native code, which is copied around and so
+     * can't reference them directly */
+    void (*jit_clear_write_func)(Q68State *state, uint32_t address,
+                                 uint32_t size);
+    void (*jit_trace_func)(void);
+
     /* Currently executing JIT block (NULL = none) */
     Q68JitEntry *jit_running;
 
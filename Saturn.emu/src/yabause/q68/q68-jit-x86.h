@@ -23,6 +23,20 @@
 
 /*************************************************************************/
 
+/**
+ * JIT_CALLBACK:  Attribute for C functions called from translated code.
+ * The native code pushes a varying number of values before such calls,
+ * so the stack isn't guaranteed to have the 16-byte alignment the x64 ABI
+ * requires and the function must realign it itself.
+ */
+#ifdef CPU_X64
+# define JIT_CALLBACK  __attribute__((force_align_arg_pointer))
+#else
+# define JIT_CALLBACK  /*nothing*/
+#endif
+
+/*************************************************************************/
+
 /**
  * JIT_CALL:  Run translated code from the given (native) address for the
  * given number of cycles.
@@ -380,6 +380,10 @@ static OpcodeFunc * const opcode_4E4x_table[8] = {
 # error Dynamic translation is not supported on this platform
 #endif
 
+#ifndef JIT_CALLBACK
+# define JIT_CALLBACK  /*nothing*/
+#endif
+
 /*************************************************************************/
 /********************** External interface routines **********************/
 /*************************************************************************/
@@ -422,6 +426,14 @@ int q68_jit_init(Q68State *state)
     /* Default to no cache flush function */
     state->jit_flush   = NULL;
 
+    /* Set up the routines called from native code */
+    state->jit_clear_write_func = q68_jit_clear_write;
+#ifdef Q68_TRACE
+    state->jit_trace_func = q68_trace;
+#else
+    state->jit_trace_func = NULL;
+#endif
+
 #ifdef Q68_DISABLE_ADDRESS_ERROR
     /* Hack to avoid compiler warnings about unused functions */
     if (0) {
@@ -867,7 +879,8 @@ void q68_jit_clear_page(Q68State *state, uint32_t address)
  * [Return value]
  *     None
  */
-void q68_jit_clear_write(Q68State *state, uint32_t address, uint32_t size)
+JIT_CALLBACK void q68_jit_clear_write(Q68State *state, uint32_t address,
+                                      uint32_t size)
 {
     int index;
 
@@ -1077,6 +1090,13 @@ static void clear_entry(Q68State *state, Q68JitEntry *entry)
         }
     }
 
+    /* If the block stopped partway through on the cycle limit (e.g. this
+     * is an external write between q68_run() calls), make sure we don't
+     * try to resume it; q68_run() will start again from state->PC */
+    if (state->jit_running == entry) {
+        state->jit_running = NULL;
+    }
+
     /* Free the native code */
     state->jit_total_data -= entry->native_size;
     state->free_func(entry->native_code);
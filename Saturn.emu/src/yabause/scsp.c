@@ -91,6 +91,7 @@
 #include "memory.h"
 #include "m68kcore.h"
 #include "scu.h"
+#include "threads.h"
 #include "yabause.h"
 #include "scsp.h"
 
@@ -3006,6 +3007,174 @@ static u8 IsM68KRunning;
 static s32 FASTCALL (*m68kexecptr)(s32 cycles);  // M68K->Exec or M68KExecBP
 static s32 savedcycles;  // Cycles left over from the last M68KExec() call
 
+//////////////////////////////////////////////////////////////////////////////
+// Sound thread
+
+// When yabsys.UseThreads is set, M68KExec() and the per-frame sample
+// generation in ScspExec() are queued to the SCSP thread so they run while
+// the SH2s emulate the next scanline. Everything else that touches SCSP,
+// sound RAM or M68K state from the emulation thread first waits for the
+// queue to drain (ScspThreadSync()), so the sound thread always works on
+// the same state it would in single-threaded mode. The one difference is
+// that a main CPU interrupt raised by the M68K is held until the next sync
+// rather than reaching the SCU mid-scanline, like scsp2.c's threaded mode.
+
+#define SCSP_JOB_M68K_EXEC  0   // Run the M68K for job->cycles
+#define SCSP_JOB_GENERATE   1   // Generate job->len samples into job->bufL/R
+#define SCSP_JOB_QUIT       2   // Stop the thread
+
+#define SCSP_JOB_QUEUE_SIZE 8
+
+typedef struct
+{
+  int type;
+  s32 cycles;
+  s32 *bufL;
+  s32 *bufR;
+  u32 len;
+} scsp_job_t;
+
+static YabEventQueue *scsp_job_queue;   // Jobs for the SCSP thread
+static YabEventQueue *scsp_done_queue;  // Jobs finished by the SCSP thread
+static scsp_job_t scsp_jobs[SCSP_JOB_QUEUE_SIZE];
+static u32 scsp_job_next;               // Next entry of scsp_jobs to use
+static u32 scsp_jobs_pending;           // Jobs queued but not yet finished
+static u32 scsp_samples_pending;        // Samples queued for generation
+static u8 scsp_in_thread;               // Set while the thread runs a job
+static u8 scsp_main_interrupt_pending;  // Raised by the M68K, not yet sent
+
+static void M68KDoExec (s32 cycles);
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+ScspThread (UNUSED void *arg)
+{
+  for (;;)
+    {
+      scsp_job_t *job = (scsp_job_t *)YabWaitEventQueue (scsp_job_queue);
+
+      if (job->type == SCSP_JOB_QUIT)
+        break;
+
+      scsp_in_thread = 1;
+      switch (job->type)
+        {
+        case SCSP_JOB_M68K_EXEC:
+          M68KDoExec (job->cycles);
+          break;
+
+        case SCSP_JOB_GENERATE:
+          memset (job->bufL, 0, sizeof(u32) * job->len);
+          memset (job->bufR, 0, sizeof(u32) * job->len);
+          scsp_update (job->bufL, job->bufR, job->len);
+          scsp_update_monitor ();
+          break;
+        }
+      scsp_in_thread = 0;
+
+      YabAddEventQueue (scsp_done_queue, job);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+ScspThreadWaitJob (void)
+{
+  YabWaitEventQueue (scsp_done_queue);
+  scsp_jobs_pending--;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Wait for all queued jobs to finish and pass on their results
+static INLINE void
+ScspThreadSync (void)
+{
+  if (LIKELY(!scsp_jobs_pending))
+    return;
+
+  while (scsp_jobs_pending)
+    ScspThreadWaitJob ();
+
+  scspsoundoutleft += scsp_samples_pending;
+  scsp_samples_pending = 0;
+
+  if (scsp_main_interrupt_pending)
+    {
+      scsp_main_interrupt_pending = 0;
+      ScuSendSoundRequest ();
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static scsp_job_t *
+ScspThreadNewJob (int type)
+{
+  scsp_job_t *job;
+
+  // Entries are reused in order, so make sure the oldest one is finished
+  if (scsp_jobs_pending == SCSP_JOB_QUEUE_SIZE)
+    ScspThreadWaitJob ();
+
+  job = &scsp_jobs[scsp_job_next];
+  scsp_job_next = (scsp_job_next + 1) % SCSP_JOB_QUEUE_SIZE;
+  job->type = type;
+  return job;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+ScspThreadQueueJob (scsp_job_t *job)
+{
+  scsp_jobs_pending++;
+  YabAddEventQueue (scsp_job_queue, job);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+ScspThreadStop (void)
+{
+  if (!scsp_job_queue)
+    return;
+
+  ScspThreadSync ();
+  ScspThreadQueueJob (ScspThreadNewJob (SCSP_JOB_QUIT));
+  YabThreadWait (YAB_THREAD_SCSP);
+  scsp_jobs_pending = 0;
+
+  YabThreadDestroyQueue (scsp_job_queue);
+  YabThreadDestroyQueue (scsp_done_queue);
+  scsp_job_queue = NULL;
+  scsp_done_queue = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void
+ScspThreadStart (void)
+{
+  scsp_job_next = 0;
+  scsp_jobs_pending = 0;
+  scsp_samples_pending = 0;
+  scsp_main_interrupt_pending = 0;
+
+  if ((scsp_job_queue = YabThreadCreateQueue (SCSP_JOB_QUEUE_SIZE)) == NULL ||
+      (scsp_done_queue = YabThreadCreateQueue (SCSP_JOB_QUEUE_SIZE)) == NULL ||
+      YabThreadStart (YAB_THREAD_SCSP, ScspThread, NULL) != 0)
+    {
+      SCSPLOG ("WARNING: couldn't start SCSP thread, running single-threaded\n");
+      YabThreadDestroyQueue (scsp_job_queue);
+      YabThreadDestroyQueue (scsp_done_queue);
+      scsp_job_queue = NULL;
+      scsp_done_queue = NULL;
+    }
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 static u32 FASTCALL
@@ -3065,8 +3234,12 @@ c68k_interrupt_handler (u32 level)
 static void
 scu_interrupt_handler (void)
 {
-  // send interrupt to scu
-  ScuSendSoundRequest ();
+  // send interrupt to scu, from the emulation thread since the SCU isn't
+  // thread safe
+  if (scsp_in_thread)
+    scsp_main_interrupt_pending = 1;
+  else
+    ScuSendSoundRequest ();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -3074,6 +3247,8 @@ scu_interrupt_handler (void)
 u8 FASTCALL
 SoundRamReadByte (u32 addr)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   // If mem4b is set, mirror ram every 256k
@@ -3090,6 +3265,8 @@ SoundRamReadByte (u32 addr)
 void FASTCALL
 SoundRamWriteByte (u32 addr, u8 val)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   // If mem4b is set, mirror ram every 256k
@@ -3107,6 +3284,8 @@ SoundRamWriteByte (u32 addr, u8 val)
 u16 FASTCALL
 SoundRamReadWord (u32 addr)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   if (scsp.mem4b == 0)
@@ -3122,6 +3301,8 @@ SoundRamReadWord (u32 addr)
 void FASTCALL
 SoundRamWriteWord (u32 addr, u16 val)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   // If mem4b is set, mirror ram every 256k
@@ -3139,6 +3320,8 @@ SoundRamWriteWord (u32 addr, u16 val)
 u32 FASTCALL
 SoundRamReadLong (u32 addr)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   // If mem4b is set, mirror ram every 256k
@@ -3155,6 +3338,8 @@ SoundRamReadLong (u32 addr)
 void FASTCALL
 SoundRamWriteLong (u32 addr, u32 val)
 {
+  ScspThreadSync ();
+
   addr &= 0xFFFFF;
 
   // If mem4b is set, mirror ram every 256k
@@ -3169,6 +3354,63 @@ SoundRamWriteLong (u32 addr, u32 val)
 
 //////////////////////////////////////////////////////////////////////////////
 
+// SCSP register access from the SH2 side, the M68K calls scsp_r_*/scsp_w_*
+// directly
+
+u8 FASTCALL
+ScspReadByte (u32 addr)
+{
+  ScspThreadSync ();
+  return scsp_r_b (addr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u16 FASTCALL
+ScspReadWord (u32 addr)
+{
+  ScspThreadSync ();
+  return scsp_r_w (addr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u32 FASTCALL
+ScspReadLong (u32 addr)
+{
+  ScspThreadSync ();
+  return scsp_r_d (addr);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FASTCALL
+ScspWriteByte (u32 addr, u8 val)
+{
+  ScspThreadSync ();
+  scsp_w_b (addr, val);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FASTCALL
+ScspWriteWord (u32 addr, u16 val)
+{
+  ScspThreadSync ();
+  scsp_w_w (addr, val);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void FASTCALL
+ScspWriteLong (u32 addr, u32 val)
+{
+  ScspThreadSync ();
+  scsp_w_d (addr, val);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 int
 ScspInit (int coreid)
 {
@@ -3220,6 +3462,9 @@ ScspInit (int coreid)
   scspsoundoutleft = 0;
   scspframeaccurate = 0;
 
+  if (yabsys.UseThreads)
+    ScspThreadStart ();
+
   return ScspChangeSoundCore (coreid);
 }
 
@@ -3289,6 +3534,8 @@ ScspSetFrameAccurate (int on)
 void
 ScspDeInit (void)
 {
+  ScspThreadStop ();
+
   if (scspchannel[0].data32)
     free(scspchannel[0].data32);
   scspchannel[0].data32 = NULL;
@@ -3313,6 +3560,7 @@ ScspDeInit (void)
 void
 M68KStart (void)
 {
+  ScspThreadSync ();
   M68K->Reset ();
   savedcycles = 0;
   IsM68KRunning = 1;
@@ -3323,6 +3571,7 @@ M68KStart (void)
 void
 M68KStop (void)
 {
+  ScspThreadSync ();
   IsM68KRunning = 0;
 }
 
@@ -3331,6 +3580,7 @@ M68KStop (void)
 void
 ScspReset (void)
 {
+  ScspThreadSync ();
   scsp_reset();
 }
 
@@ -3339,6 +3589,8 @@ ScspReset (void)
 int
 ScspChangeVideoFormat (int type)
 {
+  ScspThreadSync ();
+
   scspsoundlen = 44100 / (type ? 50 : 60);
   scsplines = type ? 313 : 263;
   scspsoundbufsize = scspsoundlen * scspsoundbufs;
@@ -3362,6 +3614,26 @@ static s32 FASTCALL M68KExecBP (s32 cycles);
 
 void
 M68KExec (s32 cycles)
+{
+  if (scsp_job_queue)
+    {
+      scsp_job_t *job;
+
+      if (!IsM68KRunning)
+        return;
+
+      job = ScspThreadNewJob (SCSP_JOB_M68K_EXEC);
+      job->cycles = cycles;
+      ScspThreadQueueJob (job);
+    }
+  else
+    M68KDoExec (cycles);
+}
+
+//----------------------------------------------------------------------------
+
+static void
+M68KDoExec (s32 cycles)
 {
   s32 newcycles = savedcycles - cycles;
   if (LIKELY(IsM68KRunning))
@@ -3411,15 +3683,18 @@ M68KExecBP (s32 cycles)
 void
 M68KStep (void)
 {
+  ScspThreadSync ();
   M68K->Exec(1);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-// Wait for background execution to finish (used on PSP)
+// Wait for background execution to finish (used on PSP and by the SCSP
+// thread)
 void
 M68KSync (void)
 {
+  ScspThreadSync ();
   M68K->Sync();
 }
 
@@ -3461,6 +3736,8 @@ ScspConvert32uto16s (s32 *srcL, s32 *srcR, s16 *dst, u32 len)
 void
 ScspReceiveCDDA (const u8 *sector)
 {	
+   ScspThreadSync ();
+
    // If buffer is half empty or less, boost timing for a bit until we've buffered a few sectors
    if (cdda_out_left < (sizeof(cddabuf.data) / 2))
    {
@@ -3497,6 +3774,9 @@ void
 ScspExec ()
 {
   u32 audiosize;
+  int generating = 0;
+
+  ScspThreadSync ();
 
   ScspInternalVars->scsptiming2 +=
     ((scspsoundlen << 16) + scsplines / 2) / scsplines;
@@ -3528,11 +3808,25 @@ ScspExec ()
 
           bufL = (s32 *)&scspchannel[0].data32[scspsoundgenpos];
           bufR = (s32 *)&scspchannel[1].data32[scspsoundgenpos];
-          memset (bufL, 0, sizeof(u32) * scspsoundlen);
-          memset (bufR, 0, sizeof(u32) * scspsoundlen);
-          scsp_update (bufL, bufR, scspsoundlen);
+          if (scsp_job_queue)
+            {
+              // Samples are sent to the host driver after the next sync
+              scsp_job_t *job = ScspThreadNewJob (SCSP_JOB_GENERATE);
+              job->bufL = bufL;
+              job->bufR = bufR;
+              job->len = scspsoundlen;
+              ScspThreadQueueJob (job);
+              scsp_samples_pending += scspsoundlen;
+              generating = 1;
+            }
+          else
+            {
+              memset (bufL, 0, sizeof(u32) * scspsoundlen);
+              memset (bufR, 0, sizeof(u32) * scspsoundlen);
+              scsp_update (bufL, bufR, scspsoundlen);
+              scspsoundoutleft += scspsoundlen;
+            }
           scspsoundgenpos += scspsoundlen;
-          scspsoundoutleft += scspsoundlen;
         }
     }
 
@@ -3541,7 +3835,8 @@ ScspExec ()
       while (scspsoundoutleft > 0 &&
              (audiosize = SNDCore->GetAudioSpace ()) > 0)
         {
-          s32 outstart = (s32)scspsoundgenpos - (s32)scspsoundoutleft;
+          s32 outstart = (s32)scspsoundgenpos - (s32)scsp_samples_pending -
+                         (s32)scspsoundoutleft;
 
           if (outstart < 0)
             outstart += scspsoundbufsize;
@@ -3585,7 +3880,9 @@ ScspExec ()
         }
     }  // if (scspframeaccurate)
 
-  scsp_update_monitor ();
+  // the generate job updates the monitor after it's done
+  if (!generating)
+    scsp_update_monitor ();
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -3593,6 +3890,7 @@ ScspExec ()
 void
 M68KWriteNotify (u32 address, u32 size)
 {
+  ScspThreadSync ();
   M68K->WriteNotify (address, size);
 }
 
@@ -3603,6 +3901,8 @@ M68KGetRegisters (m68kregs_struct *regs)
 {
   int i;
 
+  ScspThreadSync ();
+
   if (regs != NULL)
     {
       for (i = 0; i < 8; i++)
@@ -3623,6 +3923,8 @@ M68KSetRegisters (m68kregs_struct *regs)
 {
   int i;
 
+  ScspThreadSync ();
+
   if (regs != NULL)
     {
       for (i = 0; i < 8; i++)
@@ -3681,6 +3983,8 @@ M68KAddCodeBreakpoint (u32 addr)
 {
   int i;
 
+  ScspThreadSync ();
+
   if (ScspInternalVars->numcodebreakpoints < MAX_BREAKPOINTS)
     {
       // Make sure it isn't already on the list
@@ -3730,6 +4034,8 @@ int
 M68KDelCodeBreakpoint (u32 addr)
 {
   int i;
+
+  ScspThreadSync ();
   if (ScspInternalVars->numcodebreakpoints > 0)
     {
       for (i = 0; i < ScspInternalVars->numcodebreakpoints; i++)
@@ -3780,6 +4086,10 @@ SoundSaveState (FILE *fp)
   u8 nextphase;
   IOCheck_struct check;
 
+  // the thread's jobs always finish before the state is written so a state
+  // saved with it running matches one saved without
+  ScspThreadSync ();
+
   offset = StateWriteHeader (fp, "SCSP", 2);
 
   // Save 68k registers first
@@ -3899,6 +4209,8 @@ SoundLoadState (FILE *fp, int version, int size)
   u8 nextphase;
   IOCheck_struct check;
 
+  ScspThreadSync ();
+
   // Read 68k registers first
   yread (&check, (void *)&IsM68KRunning, 1, 1, fp);
 
@@ -4124,6 +4436,8 @@ ScspSlotDebugStats (u8 slotnum, char *outstring)
 {
   u32 slotoffset = slotnum * 0x20;
 
+  ScspThreadSync ();
+
   AddString (outstring, "Sound Source = ");
   switch (scsp.slot[slotnum].ssctl)
     {
@@ -4251,6 +4565,7 @@ ScspSlotDebugStats (u8 slotnum, char *outstring)
 void
 ScspCommonControlRegisterDebugStats (char *outstring)
 {
+   ScspThreadSync ();
    AddString (outstring, "Memory: %s\r\n", scsp.mem4b ? "4 Mbit" : "2 Mbit");
    AddString (outstring, "Master volume: %ld\r\n", (unsigned long)scsp.mvol);
    AddString (outstring, "Ring buffer length: %ld\r\n", (unsigned long)scsp.rbl);
@@ -4301,6 +4616,8 @@ ScspSlotDebugSaveRegisters (u8 slotnum, const char *filename)
   int i;
   IOCheck_struct check;
 
+  ScspThreadSync ();
+
   if ((fp = fopen (filename, "wb")) == NULL)
     return -1;
 
@@ -4406,6 +4723,8 @@ ScspSlotDebugAudioSaveWav (u8 slotnum, const char *filename)
   long length;
   IOCheck_struct check;
 
+  ScspThreadSync ();
+
   if (scsp.slot[slotnum].lea == 0)
     return 0;
 
@@ -86,6 +86,12 @@ u32 FASTCALL SoundRamReadLong(u32 addr);
 void FASTCALL SoundRamWriteByte(u32 addr, u8 val);
 void FASTCALL SoundRamWriteWord(u32 addr, u16 val);
 void FASTCALL SoundRamWriteLong(u32 addr, u32 val);
+u8 FASTCALL ScspReadByte(u32 addr);
+u16 FASTCALL ScspReadWord(u32 addr);
+u32 FASTCALL ScspReadLong(u32 addr);
+void FASTCALL ScspWriteByte(u32 addr, u8 val);
+void FASTCALL ScspWriteWord(u32 addr, u16 val);
+void FASTCALL ScspWriteLong(u32 addr, u32 val);
 
 int ScspInit(int coreid);
 int ScspChangeSoundCore(int coreid);
@@ -72,6 +72,43 @@ const pointer jump_vaddr_reg[2][8] = {
   }
 };
 
+// The program may be loaded out of rel32 range of the translation cache
+// (eg as a position independent executable), so calls & jumps from
+// generated code to these go through trampolines at the end of the cache
+const pointer jump_table_symbols[] = {
+  (pointer)dyna_linker,
+  (pointer)verify_code,
+  (pointer)cc_interrupt,
+  (pointer)slave_entry,
+  (pointer)div1,
+  (pointer)macl,
+  (pointer)macw,
+  (pointer)master_handle_bios,
+  (pointer)slave_handle_bios,
+  (pointer)MappedMemoryReadByte,
+  (pointer)MappedMemoryReadWord,
+  (pointer)MappedMemoryReadLong,
+  (pointer)WriteInvalidateLong,
+  (pointer)WriteInvalidateWord,
+  (pointer)WriteInvalidateByte,
+  (pointer)WriteInvalidateByteSwapped,
+  (pointer)jump_vaddr_eax_master,
+  (pointer)jump_vaddr_ecx_master,
+  (pointer)jump_vaddr_edx_master,
+  (pointer)jump_vaddr_ebx_master,
+  (pointer)jump_vaddr_ebp_master,
+  (pointer)jump_vaddr_edi_master,
+  (pointer)jump_vaddr_eax_slave,
+  (pointer)jump_vaddr_ecx_slave,
+  (pointer)jump_vaddr_edx_slave,
+  (pointer)jump_vaddr_ebx_slave,
+  (pointer)jump_vaddr_ebp_slave,
+  (pointer)jump_vaddr_edi_slave
+};
+
+// 16 bytes each, jmp *0(%rip) followed by the address
+#define JUMP_TABLE_SIZE (sizeof(jump_table_symbols)*2)
+
 // We need these for cmovcc instructions on x86
 u32 const_zero=0;
 u32 const_one=1;
@@ -93,8 +130,9 @@ void set_jump_target(pointer addr,pointer target)
   }
   else
   {
-    assert(*ptr==0xc7); /* mov immediate (store address) */
-    u32 *ptr2=(u32 *)(ptr+6);
+    /* mov immediate (store address), relative to HOST_BASEREG */
+    assert(ptr[0]==0x41&&ptr[1]==0xc7&&ptr[2]==0x87);
+    u32 *ptr2=(u32 *)(ptr+7);
     *ptr2=target;
   }
 }
@@ -116,36 +154,20 @@ pointer get_pointer(void *stub)
 pointer get_clean_addr(pointer addr)
 {
   u8 *ptr=(u8 *)addr;
-  if(ptr[0]==0xB8) {
-    assert(ptr[21]==0xE8); // call instruction
-    if(ptr[26]==0xE9) return *(s32 *)(ptr+27)+addr+31; // follow jmp
-    else return(addr+26);
-  }
-  /* 64-bit source pointer */
-  assert(ptr[26]==0xE8); // call instruction
-  if(ptr[31]==0xE9) return *(s32 *)(ptr+32)+addr+36; // follow jmp
-  else return(addr+31);
+  assert(ptr[31]==0xE8); // call instruction
+  if(ptr[36]==0xE9) return *(s32 *)(ptr+37)+addr+41; // follow jmp
+  else return(addr+36);
 }
 
 int verify_dirty(pointer addr)
 {
   u8 *ptr=(u8 *)addr;
-  if(ptr[0]==0xB8) {
-    u32 source=*(u32 *)(ptr+1);
-    u32 copy=*(u32 *)(ptr+6);
-    u32 len=*(u32 *)(ptr+11);
-    //printf("source=%x source-rdram=%x\n",source,source-(int)rdram);
-    assert(ptr[21]==0xE8); // call instruction
-    //printf("verify_dirty: %x %x %x\n",source,copy,len);
-    return !memcmp((void *)source,(void *)copy,len);
-  }
   assert(ptr[0]==0x48&&ptr[1]==0xB8);
-  /* 64-bit source pointer */
   u64 source=*(u64 *)(ptr+2);
-  u32 copy=*(u32 *)(ptr+11);
-  u32 len=*(u32 *)(ptr+16);
+  u64 copy=*(u64 *)(ptr+12);
+  u32 len=*(u32 *)(ptr+21);
   //printf("source=%x source-rdram=%x\n",source,source-(int)rdram);
-  assert(ptr[26]==0xE8); // call instruction
+  assert(ptr[31]==0xE8); // call instruction
   //printf("verify_dirty: %x %x %x\n",source,copy,len);
   return !memcmp((void *)source,(void *)copy,len);
 }
@@ -155,44 +177,27 @@ int verify_dirty(pointer addr)
 int isclean(pointer addr)
 {
   u8 *ptr=(u8 *)addr;
-  if(ptr[0]==0xB8) {
-    if(ptr[0]!=0xB8) return 1; // mov imm,%eax
-    if(ptr[5]!=0xBB) return 1; // mov imm,%ebx
-    if(ptr[10]!=0xB9) return 1; // mov imm,%ecx
-    if(ptr[15]!=0x41) return 1; // rex prefix
-    if(ptr[16]!=0xBC) return 1; // mov imm,%r12d
-    if(ptr[21]!=0xE8) return 1; // call instruction
-  }else{
-    if(ptr[0]!=0x48) return 1; // rex prefix
-    if(ptr[1]!=0xB8) return 1; // mov imm,%rax
-    if(ptr[10]!=0xBB) return 1; // mov imm,%ebx
-    if(ptr[15]!=0xB9) return 1; // mov imm,%ecx
-    if(ptr[20]!=0x41) return 1; // rex prefix
-    if(ptr[21]!=0xBC) return 1; // mov imm,%r12d
-    if(ptr[26]!=0xE8) return 1; // call instruction
-  }
+  if(ptr[0]!=0x48) return 1; // rex prefix
+  if(ptr[1]!=0xB8) return 1; // mov imm,%rax
+  if(ptr[10]!=0x48) return 1; // rex prefix
+  if(ptr[11]!=0xBB) return 1; // mov imm,%rbx
+  if(ptr[20]!=0xB9) return 1; // mov imm,%ecx
+  if(ptr[25]!=0x41) return 1; // rex prefix
+  if(ptr[26]!=0xBC) return 1; // mov imm,%r12d
+  if(ptr[31]!=0xE8) return 1; // call instruction
   return 0;
 }
 
-void get_bounds(pointer addr,u32 *start,u32 *end)
+void get_bounds(pointer addr,pointer *start,pointer *end)
 {
   u8 *ptr=(u8 *)addr;
-  if(ptr[0]==0xB8) {
-    u32 source=*(u32 *)(ptr+1);
-    //u32 copy=*(u32 *)(ptr+6);
-    u32 len=*(u32 *)(ptr+11);
-    assert(ptr[21]==0xE8); // call instruction
-    *start=source;
-    *end=source+len;
-  }else{
-    assert(ptr[0]==0x48&&ptr[1]==0xB8);
-    u64 source=*(u64 *)(ptr+2);
-    //32 copy=*(u32 *)(ptr+11);
-    u32 len=*(u32 *)(ptr+16);
-    assert(ptr[26]==0xE8); // call instruction
-    *start=source;
-    *end=source+len;
-  }
+  assert(ptr[0]==0x48&&ptr[1]==0xB8);
+  u64 source=*(u64 *)(ptr+2);
+  //u64 copy=*(u64 *)(ptr+12);
+  u32 len=*(u32 *)(ptr+21);
+  assert(ptr[31]==0xE8); // call instruction
+  *start=source;
+  *end=source+len;
 }
 
 /* Register allocation */
@@ -559,6 +564,31 @@ void output_w64(u64 word)
   out+=8;
 }
 
+// Globals are addressed relative to HOST_BASEREG, anything out of its
+// reach through HOST_ADDRREG, which emit_hostaddr() loads beforehand.
+// Either way the instruction needs REX.B.
+int can_base_addr(pointer addr)
+{
+  s64 offset=addr-(pointer)memory_map;
+  return offset==(s32)offset;
+}
+void output_modrm_hostaddr(pointer addr,u8 ext)
+{
+  if(can_base_addr(addr)) {
+    output_modrm(2,HOST_BASEREG&7,ext);
+    output_w32(addr-(pointer)memory_map);
+  }
+  else output_modrm(0,HOST_ADDRREG&7,ext);
+}
+// Tables indexed by a register must be within reach of HOST_BASEREG
+void output_sib_hostaddr(pointer addr,u8 scale,u8 index,u8 ext)
+{
+  assert(can_base_addr(addr));
+  output_modrm(2,4,ext);
+  output_sib(scale,index,HOST_BASEREG&7);
+  output_w32(addr-(pointer)memory_map);
+}
+
 void emit_mov(int rs,int rt)
 {
   assem_debug("mov %%%s,%%%s\n",regname[rs],regname[rt]);
@@ -684,21 +714,23 @@ void emit_zeroreg(int rt)
 
 void emit_loadreg(int r, int hr)
 {
-  int addr=(slave?(int)slave_reg:(int)master_reg)+(r<<2);
-  if(r==CCREG) addr=slave?(int)&slave_cc:(int)&master_cc;
+  pointer addr=(slave?(pointer)slave_reg:(pointer)master_reg)+(r<<2);
+  if(r==CCREG) addr=slave?(pointer)&slave_cc:(pointer)&master_cc;
   assem_debug("mov %x+%d,%%%s\n",addr,r,regname[hr]);
+  emit_hostaddr(addr);
+  output_rex(0,hr>>3,0,1);
   output_byte(0x8B);
-  output_modrm(0,5,hr);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,hr&7);
 }
 void emit_storereg(int r, int hr)
 {
-  int addr=(slave?(int)slave_reg:(int)master_reg)+(r<<2);
-  if(r==CCREG) addr=slave?(int)&slave_cc:(int)&master_cc;
+  pointer addr=(slave?(pointer)slave_reg:(pointer)master_reg)+(r<<2);
+  if(r==CCREG) addr=slave?(pointer)&slave_cc:(pointer)&master_cc;
   assem_debug("mov %%%s,%x+%d\n",regname[hr],addr,r);
+  emit_hostaddr(addr);
+  output_rex(0,hr>>3,0,1);
   output_byte(0x89);
-  output_modrm(0,5,hr);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,hr&7);
 }
 
 void emit_test(int rs, int rt)
@@ -828,6 +860,11 @@ void emit_movimm64(u64 imm,unsigned int rt)
   output_w64(imm);
 }
 
+void emit_hostaddr(pointer addr)
+{
+  if(!can_base_addr(addr)) emit_movimm64(addr,HOST_ADDRREG);
+}
+
 void emit_addimm(int rs,int imm,int rt)
 {
   if(rs==rt) {
@@ -1274,10 +1311,11 @@ void emit_cmovne(u32 *addr,int rt)
   if(addr==&const_zero) assem_debug(" [zero]\n");
   else if(addr==&const_one) assem_debug(" [one]\n");
   else assem_debug("\n");
+  emit_hostaddr((pointer)addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x0F);
   output_byte(0x45);
-  output_modrm(0,5,rt);
-  output_w32((int)addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr((pointer)addr,rt&7);
 }
 void emit_cmovl(u32 *addr,int rt)
 {
@@ -1285,10 +1323,11 @@ void emit_cmovl(u32 *addr,int rt)
   if(addr==&const_zero) assem_debug(" [zero]\n");
   else if(addr==&const_one) assem_debug(" [one]\n");
   else assem_debug("\n");
+  emit_hostaddr((pointer)addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x0F);
   output_byte(0x4C);
-  output_modrm(0,5,rt);
-  output_w32((int)addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr((pointer)addr,rt&7);
 }
 void emit_cmovs(u32 *addr,int rt)
 {
@@ -1296,10 +1335,11 @@ void emit_cmovs(u32 *addr,int rt)
   if(addr==&const_zero) assem_debug(" [zero]\n");
   else if(addr==&const_one) assem_debug(" [one]\n");
   else assem_debug("\n");
+  emit_hostaddr((pointer)addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x0F);
   output_byte(0x48);
-  output_modrm(0,5,rt);
-  output_w32((int)addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr((pointer)addr,rt&7);
 }
 void emit_cmovne_reg(int rs,int rt)
 {
@@ -1699,73 +1739,97 @@ void emit_rotcrsr(int t, int sr)
   emit_adc(sr,sr);
 }
 
-void emit_call(int a)
+// Targets outside the translation cache go through the jump table
+pointer genjmp(pointer addr)
+{
+  int n;
+  if(addr<0x80000000) return addr;
+  for (n=0;n<sizeof(jump_table_symbols)/sizeof(pointer);n++)
+  {
+    if(addr==jump_table_symbols[n])
+      return BASE_ADDR+(1<<TARGET_SIZE_2)-JUMP_TABLE_SIZE+n*16;
+  }
+  assert(0); // missing from jump_table_symbols
+  return addr;
+}
+
+void emit_call(pointer a)
 {
+  a=genjmp(a);
   assem_debug("call %x (%x+%x)\n",a,(int)out+5,a-(int)out-5);
   output_byte(0xe8);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jmp(int a)
+void emit_jmp(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jmp %x (%x+%x)\n",a,(int)out+5,a-(int)out-5);
   output_byte(0xe9);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jne(int a)
+void emit_jne(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jne %x\n",a);
   output_byte(0x0f);
   output_byte(0x85);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jeq(int a)
+void emit_jeq(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jeq %x\n",a);
   output_byte(0x0f);
   output_byte(0x84);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_js(int a)
+void emit_js(pointer a)
 {
+  a=genjmp(a);
   assem_debug("js %x\n",a);
   output_byte(0x0f);
   output_byte(0x88);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jns(int a)
+void emit_jns(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jns %x\n",a);
   output_byte(0x0f);
   output_byte(0x89);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jl(int a)
+void emit_jl(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jl %x\n",a);
   output_byte(0x0f);
   output_byte(0x8c);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jge(int a)
+void emit_jge(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jge %x\n",a);
   output_byte(0x0f);
   output_byte(0x8d);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jno(int a)
+void emit_jno(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jno %x\n",a);
   output_byte(0x0f);
   output_byte(0x81);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
-void emit_jc(int a)
+void emit_jc(pointer a)
 {
+  a=genjmp(a);
   assem_debug("jc %x\n",a);
   output_byte(0x0f);
   output_byte(0x82);
-  output_w32(a-(int)out-4);
+  output_w32(a-(pointer)out-4);
 }
 
 void emit_pushimm(int imm)
@@ -1810,13 +1874,13 @@ void emit_jmpreg(unsigned int r)
   output_byte(0xFF);
   output_modrm(3,r,4);
 }
-void emit_jmpmem_indexed(u32 addr,unsigned int r)
+void emit_jmpmem_indexed(pointer addr,unsigned int r)
 {
   assem_debug("jmp *%x(%%%s)\n",addr,regname[r]);
   assert(r<8);
+  output_rex(0,0,0,1);
   output_byte(0xFF);
-  output_modrm(2,r,4);
-  output_w32(addr);
+  output_sib_hostaddr(addr,0,r,4);
 }
 void emit_cmpstr(int s1, int s2, int sr, int temp)
 {
@@ -1857,27 +1921,13 @@ void emit_negc(int rs, int rt, int sr)
   }
 }
 
-void emit_readword(u64 addr, int rt)
+void emit_readword(pointer addr, int rt)
 {
-  if(addr-(u64)out+0x7FFFFFFA>0xFFFFFFFE) {
-    //TODO: special eax case
-    emit_movimm64(addr,rt);
-    assem_debug("mov (%%%s),%%%s\n",regname[rt],regname[rt]);
-    output_byte(0x8B);
-    if(rt!=EBP) {
-      output_modrm(0,rt,rt);
-    } else {
-      output_modrm(1,rt,rt);
-      output_byte(0);
-    }
-  }
-  else
-  {
-    assem_debug("mov %x,%%%s\n",addr,regname[rt]);
-    output_byte(0x8B);
-    output_modrm(0,5,rt);
-    output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
-  }
+  assem_debug("mov %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
+  output_byte(0x8B);
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_readword_indexed(int addr, int rs, int rt)
 {
@@ -1935,62 +1985,42 @@ void emit_readword_indexed_map(int addr, int rs, int map, int rt)
     }
   }
 }
-void emit_movmem_indexedx4(int addr, int rs, int rt)
+void emit_movmem_indexedx1(pointer addr, int rs, int rt)
 {
-  assem_debug("mov (%x,%%%s,4),%%%s\n",addr,regname[rs],regname[rt]);
+  assem_debug("mov (%x,%%%s,1),%%%s\n",addr,regname[rs],regname[rt]);
+  output_rex(0,0,0,1);
   output_byte(0x8B);
-  output_modrm(0,4,rt);
-  output_sib(2,rs,5);
-  output_w32(addr);
+  output_sib_hostaddr(addr,0,rs,rt);
 }
-void emit_movmem_indexedx4_addr32(int addr, int rs, int rt)
+void emit_movmem_indexedx4(pointer addr, int rs, int rt)
 {
-  assem_debug("addr32 mov (%x,%%%s,4),%%%s\n",addr,regname[rs],regname[rt]);
-  output_byte(0x67);
+  assem_debug("mov (%x,%%%s,4),%%%s\n",addr,regname[rs],regname[rt]);
+  output_rex(0,0,0,1);
   output_byte(0x8B);
-  output_modrm(0,4,rt);
-  output_sib(2,rs,5);
-  output_w32(addr);
+  output_sib_hostaddr(addr,2,rs,rt);
 }
-void emit_movmem_indexedx8(int addr, int rs, int rt)
+void emit_movmem_indexedx8(pointer addr, int rs, int rt)
 {
   assem_debug("mov (%x,%%%s,8),%%%s\n",addr,regname[rs],regname[rt]);
+  output_rex(0,0,0,1);
   output_byte(0x8B);
-  output_modrm(0,4,rt);
-  output_sib(3,rs,5);
-  output_w32(addr);
+  output_sib_hostaddr(addr,3,rs,rt);
 }
-void emit_movmem_indexedx8_64(int addr, int rs, int rt)
+void emit_movmem_indexedx8_64(pointer addr, int rs, int rt)
 {
   assem_debug("mov (%x,%%%s,8),%%%s\n",addr,regname[rs],regname[rt]);
-  output_rex(1,0,0,rt>>3);
+  output_rex(1,rt>>3,0,1);
   output_byte(0x8B);
-  output_modrm(0,4,rt);
-  output_sib(3,rs,5);
-  output_w32(addr);
+  output_sib_hostaddr(addr,3,rs,rt&7);
 }
-void emit_movsbl(u64 addr, int rt)
+void emit_movsbl(pointer addr, int rt)
 {
-  if(addr-(u64)out+0x7FFFFFF9>0xFFFFFFFE) {
-    emit_movimm64(addr,rt);
-    assem_debug("movsbl (%%%s),%%%s\n",regname[rt],regname[rt]);
-    output_byte(0x0F);
-    output_byte(0xBE);
-    if(rt!=EBP) {
-      output_modrm(0,rt,rt);
-    } else {
-      output_modrm(1,rt,rt);
-      output_byte(0);
-    }
-  }
-  else
-  {
-    assem_debug("movsbl %x,%%%s\n",addr,regname[rt]);
-    output_byte(0x0F);
-    output_byte(0xBE);
-    output_modrm(0,5,rt);
-    output_w32(addr-(int)out-4); // rip-relative
-  }
+  assem_debug("movsbl %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
+  output_byte(0x0F);
+  output_byte(0xBE);
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_movsbl_indexed(int addr, int rs, int rt)
 {
@@ -2042,28 +2072,14 @@ void emit_movsbl_indexed_map(int addr, int rs, int map, int rt)
     }
   }
 }
-void emit_movswl(u64 addr, int rt)
+void emit_movswl(pointer addr, int rt)
 {
-  if(addr-(u64)out+0x7FFFFFF9>0xFFFFFFFE) {
-    emit_movimm64(addr,rt);
-    assem_debug("movswl (%%%s),%%%s\n",regname[rt],regname[rt]);
-    output_byte(0x0F);
-    output_byte(0xBF);
-    if(rt!=EBP) {
-      output_modrm(0,rt,rt);
-    } else {
-      output_modrm(1,rt,rt);
-      output_byte(0);
-    }
-  }
-  else
-  {
-    assem_debug("movswl %x,%%%s\n",addr,regname[rt]);
-    output_byte(0x0F);
-    output_byte(0xBF);
-    output_modrm(0,5,rt);
-    output_w32(addr-(int)out-4); // rip-relative
-  }
+  assem_debug("movswl %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
+  output_byte(0x0F);
+  output_byte(0xBF);
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_movswl_indexed(int addr, int rs, int rt)
 {
@@ -2115,13 +2131,14 @@ void emit_movswl_indexed_map(int addr, int rs, int map, int rt)
     }
   }
 }
-void emit_movzbl(int addr, int rt)
+void emit_movzbl(pointer addr, int rt)
 {
   assem_debug("movzbl %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x0F);
   output_byte(0xB6);
-  output_modrm(0,5,rt);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_movzbl_indexed(int addr, int rs, int rt)
 {
@@ -2171,13 +2188,14 @@ void emit_movzbl_indexed_map(int addr, int rs, int map, int rt)
     }
   }
 }
-void emit_movzwl(int addr, int rt)
+void emit_movzwl(pointer addr, int rt)
 {
   assem_debug("movzwl %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x0F);
   output_byte(0xB7);
-  output_modrm(0,5,rt);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_movzwl_indexed(int addr, int rs, int rt)
 {
@@ -2201,26 +2219,13 @@ void emit_movzwl_map(int addr, int map, int rt)
     output_w32(addr);
   }
 }
-void emit_movq(u64 addr, int rt)
+void emit_movq(pointer addr, int rt)
 {
-  if(addr-(u64)out+0x7FFFFFFA>0xFFFFFFFF) {
-    assert(addr-(u64)out+0x7FFFFFFA<0x100000000);
-    //TODO: special eax case
-    emit_movimm64(addr,rt);
-    //FIXME
-    assem_debug("mov (%%%s),%%%s\n",regname[rt],regname[rt]);
-    output_byte(0x8B);
-    output_modrm(0,rt,rt);
-    output_byte(0xCC);//remove
-  }
-  else
-  {
-    assem_debug("movq %llx,%%%s\n",addr,regname[rt]);
-    output_rex(1,0,0,rt>>8);
-    output_byte(0x8B);
-    output_modrm(0,5,rt);
-    output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
-  }
+  assem_debug("movq %llx,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(1,rt>>3,0,1);
+  output_byte(0x8B);
+  output_modrm_hostaddr(addr,rt&7);
 }
 
 void emit_xchg(int rs, int rt)
@@ -2235,12 +2240,13 @@ void emit_xchg(int rs, int rt)
     output_modrm(3,rs,rt);
   }
 }
-void emit_writeword(int rt, int addr)
+void emit_writeword(int rt, pointer addr)
 {
   assem_debug("movl %%%s,%x\n",regname[rt],addr);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x89);
-  output_modrm(0,5,rt);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_writeword_indexed(int rt, int addr, int rs)
 {
@@ -2294,13 +2300,14 @@ void emit_writeword_indexed_map(int rt, int addr, int rs, int map, int temp)
     }
   }
 }
-void emit_writehword(int rt, int addr)
+void emit_writehword(int rt, pointer addr)
 {
   assem_debug("movw %%%s,%x\n",regname[rt]+1,addr);
+  emit_hostaddr(addr);
   output_byte(0x66);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x89);
-  output_modrm(0,5,rt);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_writehword_indexed(int rt, int addr, int rs)
 {
@@ -2352,13 +2359,13 @@ void emit_writehword_indexed_map(int rt, int addr, int rs, int map, int temp)
     }
   }
 }
-void emit_writebyte(int rt, int addr)
+void emit_writebyte(int rt, pointer addr)
 {
   assem_debug("movb %%%cl,%x\n",regname[rt][1],addr);
-  if(rt>=4) output_rex(0,rt>>3,0,0);
+  emit_hostaddr(addr);
+  output_rex(0,rt>>3,0,1);
   output_byte(0x88);
-  output_modrm(0,5,rt);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt&7);
 }
 void emit_writebyte_indexed(int rt, int addr, int rs)
 {
@@ -2411,12 +2418,13 @@ void emit_writebyte_indexed_map(int rt, int addr, int rs, int map, int temp)
     }
   }
 }
-void emit_writeword_imm(int imm, int addr)
+void emit_writeword_imm(int imm, pointer addr)
 {
   assem_debug("movl $%x,%x\n",imm,addr);
+  emit_hostaddr(addr);
+  output_rex(0,0,0,1);
   output_byte(0xC7);
-  output_modrm(0,5,0);
-  output_w32(addr-(int)out-8); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,0);
   output_w32(imm);
 }
 void emit_writeword_imm_esp(int imm, int addr)
@@ -2429,22 +2437,23 @@ void emit_writeword_imm_esp(int imm, int addr)
   if(addr) output_byte(addr);
   output_w32(imm);
 }
-void emit_writedword_imm32(int imm, int addr)
+void emit_writedword_imm32(int imm, pointer addr)
 {
   assem_debug("movq $%x,%x\n",imm,addr);
-  output_rex(1,0,0,0);
+  emit_hostaddr(addr);
+  output_rex(1,0,0,1);
   output_byte(0xC7);
-  output_modrm(0,5,0);
-  output_w32(addr-(int)out-8); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,0);
   output_w32(imm); // Note: This 32-bit value will be sign extended
 }
-void emit_writebyte_imm(int imm, int addr)
+void emit_writebyte_imm(int imm, pointer addr)
 {
   assem_debug("movb $%x,%x\n",imm,addr);
   assert(imm>=-128&&imm<128);
+  emit_hostaddr(addr);
+  output_rex(0,0,0,1);
   output_byte(0xC6);
-  output_modrm(0,5,0);
-  output_w32(addr-(int)out-5); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,0);
   output_byte(imm);
 }
 
@@ -2640,54 +2649,57 @@ void emit_cmpmem_imm_byte(pointer addr,int imm)
 {
   assert(imm<128&&imm>=-127);
   assem_debug("cmpb $%d,%x\n",imm,addr);
+  emit_hostaddr(addr);
+  output_rex(0,0,0,1);
   output_byte(0x80);
-  output_modrm(0,5,7);
-  output_w32(addr-(int)out-5); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,7);
   output_byte(imm);
 }
 
 // special case for checking invalid_code
-void emit_cmpmem_indexedsr12_imm(int addr,int r,int imm)
+void emit_cmpmem_indexedsr12_imm(pointer addr,int r,int imm)
 {
   assert(imm<128&&imm>=-127);
   assert(r>=0&&r<8);
   emit_shrimm(r,12,r);
   assem_debug("cmp $%d,%x+%%%s\n",imm,addr,regname[r]);
+  output_rex(0,0,0,1);
   output_byte(0x80);
-  output_modrm(2,r,7);
-  output_w32(addr);
+  output_sib_hostaddr(addr,0,r,7);
   output_byte(imm);
 }
 
 // special case for checking hash_table
-void emit_cmpmem_indexed(int addr,int rs,int rt)
+void emit_cmpmem_indexed(pointer addr,int rs,int rt)
 {
   assert(rs>=0&&rs<8);
   assert(rt>=0&&rt<8);
   assem_debug("cmp %x+%%%s,%%%s\n",addr,regname[rs],regname[rt]);
+  output_rex(0,0,0,1);
   output_byte(0x39);
-  output_modrm(2,rs,rt);
-  output_w32(addr);
+  output_sib_hostaddr(addr,0,rs,rt);
 }
 
 // special case for checking memory_map in verify_mapping
-void emit_cmpmem(int addr,int rt)
+void emit_cmpmem(pointer addr,int rt)
 {
   assert(rt>=0&&rt<8);
   assem_debug("cmp %x,%%%s\n",addr,regname[rt]);
+  emit_hostaddr(addr);
+  output_rex(0,0,0,1);
   output_byte(0x39);
-  output_modrm(0,5,rt);
-  output_w32((int)addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,rt);
 }
 
 // Used to preload hash table entries
 void emit_prefetch(void *addr)
 {
   assem_debug("prefetch %x\n",(int)addr);
+  emit_hostaddr((pointer)addr);
+  output_rex(0,0,0,1);
   output_byte(0x0F);
   output_byte(0x18);
-  output_modrm(0,5,1);
-  output_w32((int)addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr((pointer)addr,1);
 }
 
 /*void emit_submem(int r,int addr)
@@ -2881,20 +2893,20 @@ void emit_fldcw_stack()
   output_modrm(0,4,5);
   output_sib(0,4,4);
 }
-void emit_fldcw_indexed(int addr,int r)
+void emit_fldcw_indexed(pointer addr,int r)
 {
   assem_debug("fldcw %x(%%%s)\n",addr,regname[r]);
+  output_rex(0,0,0,1);
   output_byte(0xd9);
-  output_modrm(0,4,5);
-  output_sib(1,r,5);
-  output_w32(addr);
+  output_sib_hostaddr(addr,1,r,5);
 }
-void emit_fldcw(int addr)
+void emit_fldcw(pointer addr)
 {
   assem_debug("fldcw %x\n",addr);
+  emit_hostaddr(addr);
+  output_rex(0,0,0,1);
   output_byte(0xd9);
-  output_modrm(0,5,5);
-  output_w32(addr-(int)out-4); // Note: rip-relative in 64-bit mode
+  output_modrm_hostaddr(addr,5);
 }
 void emit_movss_load(unsigned int addr,unsigned int ssereg)
 {
@@ -3018,12 +3030,12 @@ void emit_extjump(pointer addr, int target)
   //assert(addr>=0x7000000&&addr<0x7FFFFFF);
 //DEBUG >
 #ifdef DEBUG_CYCLE_COUNT
-  emit_readword((int)&last_count,ECX);
+  emit_readword((pointer)&last_count,ECX);
   emit_add(HOST_CCREG,ECX,HOST_CCREG);
-  emit_readword((int)&next_interupt,ECX);
-  emit_writeword(HOST_CCREG,(int)&Count);
+  emit_readword((pointer)&next_interupt,ECX);
+  emit_writeword(HOST_CCREG,(pointer)&Count);
   emit_sub(HOST_CCREG,ECX,HOST_CCREG);
-  emit_writeword(ECX,(int)&last_count);
+  emit_writeword(ECX,(pointer)&last_count);
 #endif
 //DEBUG <
   emit_jmp((pointer)dyna_linker);
@@ -3074,11 +3086,11 @@ void do_readstub(int n)
     temp=!addr;
   }*/
   if(type==LOADB_STUB)
-    emit_call((int)MappedMemoryReadByte);
+    emit_call((pointer)MappedMemoryReadByte);
   if(type==LOADW_STUB)
-    emit_call((int)MappedMemoryReadWord);
+    emit_call((pointer)MappedMemoryReadWord);
   if(type==LOADL_STUB)
-    emit_call((int)MappedMemoryReadLong);
+    emit_call((pointer)MappedMemoryReadLong);
   if(type==LOADS_STUB)
   {
     // RTE instruction, pop PC and SR from stack
@@ -3087,7 +3099,7 @@ void do_readstub(int n)
     if(rs==EAX||rs==ECX||rs==EDX||rs==ESI||rs==EDI)
       emit_mov(rs,12);
       //emit_writeword_indexed(rs,0,ESP);
-    emit_call((int)MappedMemoryReadLong);
+    emit_call((pointer)MappedMemoryReadLong);
     if(rs==EAX||rs==ECX||rs==EDX||rs==ESI)
       emit_mov(12,rs);
       //emit_readword_indexed(0,ESP,rs);
@@ -3109,7 +3121,7 @@ void do_readstub(int n)
       }else
         emit_addimm(rs,4,EDI);
     }
-    emit_call((int)MappedMemoryReadLong);
+    emit_call((pointer)MappedMemoryReadLong);
     assert(rt>=0);
     if(rt!=EAX) emit_mov(EAX,rt);
     if(pc==EAX||pc==ECX||pc==EDX||pc==ESI||pc==EDI)
@@ -3144,11 +3156,11 @@ void inline_readstub(int type, int i, u32 addr, signed char regmap[], int target
   save_regs(reglist);
   emit_movimm(addr,EDI);
   if(type==LOADB_STUB)
-    emit_call((int)MappedMemoryReadByte);
+    emit_call((pointer)MappedMemoryReadByte);
   if(type==LOADW_STUB)
-    emit_call((int)MappedMemoryReadWord);
+    emit_call((pointer)MappedMemoryReadWord);
   if(type==LOADL_STUB)
-    emit_call((int)MappedMemoryReadLong);
+    emit_call((pointer)MappedMemoryReadLong);
   assert(type!=LOADS_STUB);
   if(type==LOADB_STUB)
   {
@@ -3221,11 +3233,11 @@ void do_writestub(int n)
     temp=!addr;
   }*/
   if(type==STOREB_STUB)
-    emit_call((int)WriteInvalidateByteSwapped);
+    emit_call((pointer)WriteInvalidateByteSwapped);
   if(type==STOREW_STUB)
-    emit_call((int)WriteInvalidateWord);
+    emit_call((pointer)WriteInvalidateWord);
   if(type==STOREL_STUB)
-    emit_call((int)WriteInvalidateLong);
+    emit_call((pointer)WriteInvalidateLong);
   
   restore_regs(reglist);
   emit_jmp(stubs[n][2]); // return address
@@ -3243,11 +3255,11 @@ void inline_writestub(int type, int i, u32 addr, signed char regmap[], int targe
   if(rt!=ESI) emit_mov(rt,ESI);
   emit_movimm(addr,EDI); // FIXME - should be able to move the existing value
   if(type==STOREB_STUB)
-    emit_call((int)WriteInvalidateByte);
+    emit_call((pointer)WriteInvalidateByte);
   if(type==STOREW_STUB)
-    emit_call((int)WriteInvalidateWord);
+    emit_call((pointer)WriteInvalidateWord);
   if(type==STOREL_STUB)
-    emit_call((int)WriteInvalidateLong);
+    emit_call((pointer)WriteInvalidateLong);
   restore_regs(reglist);
 }
 
@@ -3298,7 +3310,7 @@ void do_rmwstub(int n)
     output_byte(12+16);
     emit_writeword(ECX,(int)&MSH2->cycles);
   }*/
-  emit_call((int)MappedMemoryReadByte);
+  emit_call((pointer)MappedMemoryReadByte);
   emit_mov(EAX,ESI);
   if(rs==EAX||rs==ECX||rs==EDX||rs==ESI||rs==EDI)
     emit_mov(12,EDI);
@@ -3316,8 +3328,8 @@ void do_rmwstub(int n)
     //emit_writeword_indexed(EDX,0,ESP);
     emit_orimm(ESI,0x80,ESI);
   }
-  //emit_call((int)MappedMemoryWriteByte);
-  emit_call((int)WriteInvalidateByte);
+  //emit_call((pointer)MappedMemoryWriteByte);
+  emit_call((pointer)WriteInvalidateByte);
   
   restore_regs(reglist);
 
@@ -3354,14 +3366,11 @@ int do_dirty_stub(int i)
 {
   assem_debug("do_dirty_stub %x\n",start+i*2);
   u32 alignedlen=((((u32)source)+slen*2+2)&~2)-(u32)alignedsource;
-  if((u64)source<=0xFFFFFFFF)
-    emit_movimm(((u32)source)&~3,EAX); //alignedsource
-  else
-    emit_movimm64(((u64)source)&~3,EAX); //alignedsource
-  emit_movimm((u32)copy,EBX);
+  emit_movimm64(((u64)source)&~3,EAX); //alignedsource
+  emit_movimm64((u64)copy,EBX);
   emit_movimm((((u32)source+slen*2+2)&~3)-((u32)source&~3),ECX);
   emit_movimm(start+i*2+slave,12);
-  emit_call((int)&verify_code);
+  emit_call((pointer)verify_code);
   int entry=(int)out;
   load_regs_entry(i);
   if(entry==(int)out) entry=instr_addr[i];
@@ -3375,7 +3384,7 @@ int do_map_r(int s,int ar,int map,int cache,int x,int a,int shift,int c,u32 addr
 {
   if(c) {
     /*if((signed int)addr>=(signed int)0xC0000000) {
-      emit_movq((int)(memory_map+(addr>>12)),map);
+      emit_movq((pointer)(memory_map+(addr>>12)),map);
     }
     else*/
       return -1; // No mapping
@@ -3387,7 +3396,7 @@ int do_map_r(int s,int ar,int map,int cache,int x,int a,int shift,int c,u32 addr
     if(x) emit_xorimm(s,x,ar);
     //if(shift>=0) emit_lea8(s,shift);
     //if(~a) emit_andimm(s,a,ar);
-    emit_movmem_indexedx8_64((int)memory_map,map,map);
+    emit_movmem_indexedx8_64((pointer)memory_map,map,map);
   }
   return map;
 }
@@ -3411,7 +3420,7 @@ int do_map_w(int s,int ar,int map,int cache,int x,int c,u32 addr)
 {
   if(c) {
     if(can_direct_write(addr)) {
-      emit_movq((int)(memory_map+(addr>>12)),map);
+      emit_movq((pointer)(memory_map+(addr>>12)),map);
     }
     else
       return -1; // No mapping
@@ -3422,7 +3431,7 @@ int do_map_w(int s,int ar,int map,int cache,int x,int c,u32 addr)
     emit_shrimm(map,12,map);
     // Schedule this while we wait on the load
     if(x) emit_xorimm(s,x,ar);
-    emit_movmem_indexedx8_64((int)memory_map,map,map);
+    emit_movmem_indexedx8_64((pointer)memory_map,map,map);
   }
   emit_shlimm64(map,2,map);
   return map;
@@ -3466,20 +3475,20 @@ void do_miniht_load(int ht,int rh) {
 }
 
 void do_miniht_jump(int rs,int rh,int ht) {
-  emit_cmpmem_indexed(slave?(u32)mini_ht_slave:(u32)mini_ht_master,rh,rs);
+  emit_cmpmem_indexed(slave?(pointer)mini_ht_slave:(pointer)mini_ht_master,rh,rs);
   emit_jne(jump_vaddr_reg[slave][rs]);
-  emit_readword_indexed(slave?(u32)mini_ht_slave+4:(u32)mini_ht_master+4,rh,rh);
+  emit_movmem_indexedx1(slave?(pointer)mini_ht_slave+4:(pointer)mini_ht_master+4,rh,rh);
   emit_jmpreg(rh);
 }
 
 void do_miniht_insert(int return_address,int rt,int temp) {
   emit_movimm(return_address,rt); // PC into link register
   //emit_writeword_imm(return_address,(int)&mini_ht[(return_address&0xFF)>>8][0]);
-  if(slave) emit_writeword(rt,(int)&mini_ht_slave[(return_address&0xFF)>>3][0]);
-  else emit_writeword(rt,(int)&mini_ht_master[(return_address&0xFF)>>3][0]);
+  if(slave) emit_writeword(rt,(pointer)&mini_ht_slave[(return_address&0xFF)>>3][0]);
+  else emit_writeword(rt,(pointer)&mini_ht_master[(return_address&0xFF)>>3][0]);
   add_to_linker((int)out,return_address,1);
-  if(slave) emit_writeword_imm(0,(int)&mini_ht_slave[(return_address&0xFF)>>3][1]);
-  else emit_writeword_imm(0,(int)&mini_ht_master[(return_address&0xFF)>>3][1]);
+  if(slave) emit_writeword_imm(0,(pointer)&mini_ht_slave[(return_address&0xFF)>>3][1]);
+  else emit_writeword_imm(0,(pointer)&mini_ht_master[(return_address&0xFF)>>3][1]);
 }
 
 void wb_valid(signed char pre[],signed char entry[],u32 dirty_pre,u32 dirty,u64 u)
@@ -3506,5 +3515,17 @@ void wb_valid(signed char pre[],signed char entry[],u32 dirty_pre,u32 dirty,u64
 void literal_pool(int n) {}
 void literal_pool_jumpover(int n) {}
 
-// CPU-architecture-specific initialization, not needed for x86
-void arch_init() {}
+// CPU-architecture-specific initialization
+void arch_init() {
+  // Trampolines for calls & jumps out of rel32 range
+  u8 *ptr=(u8 *)BASE_ADDR+(1<<TARGET_SIZE_2)-JUMP_TABLE_SIZE;
+  int n;
+  for (n=0;n<sizeof(jump_table_symbols)/sizeof(pointer);n++)
+  {
+    ptr[0]=0xFF; // jmp *0(%rip)
+    ptr[1]=0x25;
+    *(u32 *)(ptr+2)=0;
+    *(u64 *)(ptr+6)=jump_table_symbols[n];
+    ptr+=16;
+  }
+}
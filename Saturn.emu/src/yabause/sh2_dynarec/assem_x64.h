@@ -14,7 +14,6 @@
 
 #define BASE_ADDR 0x70000000 // Code generator target address
 #define TARGET_SIZE_2 25 // 2^25 = 32 megabytes
-#define JUMP_TABLE_SIZE 0 // Not needed for x86
 
 /* x86-64 calling convention:
    func(rdi, rsi, rdx, rcx, r8, r9) {return rax;}
@@ -32,4 +31,11 @@
 #define ESI 6
 #define EDI 7
 
+/* The program can be loaded anywhere, so generated code addresses
+   globals relative to %r15, which the linkage points at memory_map.
+   Anything further away is addressed through %r11. */
+
+#define HOST_BASEREG 15
+#define HOST_ADDRREG 11
+
 extern u64 memory_map[1048576]; // 64-bit
@@ -148,7 +148,7 @@ int isclean(pointer addr)
   return 0;
 }
 
-void get_bounds(pointer addr,u32 *start,u32 *end)
+void get_bounds(pointer addr,pointer *start,pointer *end)
 {
   u8 *ptr=(u8 *)addr;
   assert(ptr[5]==0xB8);
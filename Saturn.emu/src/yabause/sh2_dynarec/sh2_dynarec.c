@@ -109,7 +109,7 @@ struct ll_entry
   pointer instr_addr[MAXBLOCK];
   u32 link_addr[MAXBLOCK][3];
   int linkcount;
-  u32 stubs[MAXBLOCK*3][8];
+  pointer stubs[MAXBLOCK*3][8];
   int stubcount;
   pointer ccstub_return[MAXBLOCK];
   u32 literals[1024][2];
@@ -221,7 +221,7 @@ struct ll_entry
 // asm linkage
 int sh2_recompile_block(int addr);
 void *get_addr_ht(u32 vaddr);
-void get_bounds(pointer addr,u32 *start,u32 *end);
+void get_bounds(pointer addr,pointer *start,pointer *end);
 void invalidate_addr(u32 addr);
 void remove_hash(int vaddr);
 void dyna_linker();
@@ -287,7 +287,7 @@ void *get_addr(u32 vaddr)
       // Don't restore blocks which are about to expire from the cache
       if((((u32)head->addr-(u32)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2)))
       if(verify_dirty(head->addr)) {
-        u32 start,end;
+        pointer start,end;
         int *ht_bin;
         //printf("restore candidate: %x (%d) d=%d\n",vaddr,page,(cached_code[vaddr>>15]>>((vaddr>>12)&7))&1);
         //invalid_code[vaddr>>12]=0;
@@ -302,18 +302,18 @@ void *get_addr(u32 vaddr)
         #endif
         restore_candidate[page>>3]|=1<<(page&7);
         get_bounds((pointer)head->addr,&start,&end);
-        if(start-(u32)HighWram<0x100000) {
-          u32 vstart=start-(u32)HighWram+0x6000000;
-          u32 vend=end-(u32)HighWram+0x6000000;
+        if(start-(pointer)HighWram<0x100000) {
+          u32 vstart=start-(pointer)HighWram+0x6000000;
+          u32 vend=end-(pointer)HighWram+0x6000000;
           int i;
           //printf("write protect: start=%x, end=%x\n",vstart,vend);
           for(i=0;i<vend-vstart;i+=4) {
             cached_code_words[((vstart<4194304?vstart:((vstart|0x400000)&0x7fffff))+i)>>5]|=1<<(((vstart+i)>>2)&7);
           }
         }
-        if(start-(u32)LowWram<0x100000) {
-          u32 vstart=start-(u32)LowWram+0x200000;
-          u32 vend=end-(u32)LowWram+0x200000;
+        if(start-(pointer)LowWram<0x100000) {
+          u32 vstart=start-(pointer)LowWram+0x200000;
+          u32 vend=end-(pointer)LowWram+0x200000;
           int i;
           //printf("write protect: start=%x, end=%x\n",vstart,vend);
           for(i=0;i<vend-vstart;i+=4) {
@@ -909,21 +909,21 @@ void invalidate_blocks(u32 firstblock,u32 lastblock)
     head=jump_dirty[page];
     //printf("page=%d vpage=%d\n",page,vpage);
     while(head!=NULL) {
-      u32 start,end;
+      pointer start,end;
       if((head->vaddr>>12)==block) { // Ignore vaddr hash collision
         get_bounds((pointer)head->addr,&start,&end);
         //printf("start: %x end: %x\n",start,end);
-        if(start>=(u32)LowWram&&end<(u32)LowWram+1048576) {
-          if(((start-(u32)LowWram)>>12)<=page&&((end-1-(u32)LowWram)>>12)>=page) {
-            if((((start-(u32)LowWram)>>12)+512)<first) first=((start-(u32)LowWram)>>12)&1023;
-            if((((end-1-(u32)LowWram)>>12)+512)>last) last=((end-1-(u32)LowWram)>>12)&1023;
+        if(start>=(pointer)LowWram&&end<(pointer)LowWram+1048576) {
+          if(((start-(pointer)LowWram)>>12)<=page&&((end-1-(pointer)LowWram)>>12)>=page) {
+            if((((start-(pointer)LowWram)>>12)+512)<first) first=((start-(pointer)LowWram)>>12)&1023;
+            if((((end-1-(pointer)LowWram)>>12)+512)>last) last=((end-1-(pointer)LowWram)>>12)&1023;
           }
         }
         // FIXME: Aliasing/mirroring is wrong here
-        if(start>=(u32)HighWram&&end<(u32)HighWram+1048576) {
-          if(((start-(u32)HighWram)>>12)<=page-1024&&((end-1-(u32)HighWram)>>12)>=page-1024) {
-            if((((start-(u32)HighWram)>>12)&255)<first-1024) first=(((start-(u32)HighWram)>>12)&255)+1024;
-            if((((end-1-(u32)HighWram)>>12)&255)>last-1024) last=(((end-1-(u32)HighWram)>>12)&255)+1024;
+        if(start>=(pointer)HighWram&&end<(pointer)HighWram+1048576) {
+          if(((start-(pointer)HighWram)>>12)<=page-1024&&((end-1-(pointer)HighWram)>>12)>=page-1024) {
+            if((((start-(pointer)HighWram)>>12)&255)<first-1024) first=(((start-(pointer)HighWram)>>12)&255)+1024;
+            if((((end-1-(pointer)HighWram)>>12)&255)>last-1024) last=(((end-1-(pointer)HighWram)>>12)&255)+1024;
           }
         }
       }
@@ -1047,24 +1047,25 @@ void clean_blocks(u32 page)
     if((cached_code[head->vaddr>>15]>>((head->vaddr>>12)&7))&1) {;
       // Don't restore blocks which are about to expire from the cache
       if((((u32)head->addr-(u32)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2))) {
-        u32 start,end,vstart=0,vend;
-        if(verify_dirty((int)head->addr)) {
+        pointer start,end;
+        u32 vstart=0,vend;
+        if(verify_dirty((pointer)head->addr)) {
           //printf("Possibly Restore %x (%x)\n",head->vaddr, (int)head->addr);
           u32 i;
           u32 inv=0;
           get_bounds((pointer)head->addr,&start,&end);
-          if(start-(u32)HighWram<0x100000) {
-            vstart=start-(u32)HighWram+0x6000000;
-            vend=end-(u32)HighWram+0x6000000;
-            for(i=(start-(u32)HighWram+0x6000000)>>12;i<=(end-1-(u32)HighWram+0x6000000)>>12;i++) {
+          if(start-(pointer)HighWram<0x100000) {
+            vstart=start-(pointer)HighWram+0x6000000;
+            vend=end-(pointer)HighWram+0x6000000;
+            for(i=(start-(pointer)HighWram+0x6000000)>>12;i<=(end-1-(pointer)HighWram+0x6000000)>>12;i++) {
               // Check that all the pages are write-protected
               if(!((cached_code[i>>3]>>(i&7))&1)) inv=1;
             }
           }
-          if(start-(u32)LowWram<0x100000) {
-            vstart=start-(u32)LowWram+0x200000;
-            vend=end-(u32)LowWram+0x200000;
-            for(i=(start-(u32)LowWram+0x200000)>>12;i<=(end-1-(u32)LowWram+0x200000)>>12;i++) {
+          if(start-(pointer)LowWram<0x100000) {
+            vstart=start-(pointer)LowWram+0x200000;
+            vend=end-(pointer)LowWram+0x200000;
+            for(i=(start-(pointer)LowWram+0x200000)>>12;i<=(end-1-(pointer)LowWram+0x200000)>>12;i++) {
               // Check that all the pages are write-protected
               if(!((cached_code[i>>3]>>(i&7))&1)) inv=1;
             }
@@ -1789,7 +1790,7 @@ void delayslot_alloc(struct regstat *current,int i)
   }
 }
 
-void add_stub(int type,int addr,int retaddr,int a,int b,int c,int d,int e)
+void add_stub(int type,pointer addr,pointer retaddr,int a,int b,pointer c,int d,int e)
 {
   stubs[stubcount][0]=type;
   stubs[stubcount][1]=addr;
@@ -2290,7 +2291,7 @@ void load_assemble(int i,struct regstat *i_regs)
         }
       }
       if(jaddr)
-        add_stub(LOADB_STUB,jaddr,(int)out,i,addr,(int)i_regs,ccadj[i],reglist);
+        add_stub(LOADB_STUB,jaddr,(int)out,i,addr,(pointer)i_regs,ccadj[i],reglist);
     }
     else
       inline_readstub(LOADB_STUB,i,constaddr,i_regs->regmap,rt1[i],ccadj[i],reglist);
@@ -2315,7 +2316,7 @@ void load_assemble(int i,struct regstat *i_regs)
         }
       }
       if(jaddr)
-        add_stub(LOADW_STUB,jaddr,(int)out,i,addr,(int)i_regs,ccadj[i],reglist);
+        add_stub(LOADW_STUB,jaddr,(int)out,i,addr,(pointer)i_regs,ccadj[i],reglist);
     }
     else
       inline_readstub(LOADW_STUB,i,constaddr,i_regs->regmap,rt1[i],ccadj[i],reglist);
@@ -2332,7 +2333,7 @@ void load_assemble(int i,struct regstat *i_regs)
         emit_rorimm(t,16,t);
       }
       if(jaddr)
-        add_stub(LOADL_STUB,jaddr,(int)out,i,addr,(int)i_regs,ccadj[i],reglist);
+        add_stub(LOADL_STUB,jaddr,(int)out,i,addr,(pointer)i_regs,ccadj[i],reglist);
     }
     else
       inline_readstub(LOADL_STUB,i,constaddr,i_regs->regmap,rt1[i],ccadj[i],reglist);
@@ -2482,7 +2483,7 @@ void store_assemble(int i,struct regstat *i_regs)
     type=STOREL_STUB;
   }
   if(jaddr) {
-    add_stub(type,jaddr,(int)out,i,addr,(int)i_regs,ccadj[i],reglist);
+    add_stub(type,jaddr,(int)out,i,addr,(pointer)i_regs,ccadj[i],reglist);
   } else if(c&&!memtarget) {
     inline_writestub(type,i,constaddr,i_regs->regmap,rs1[i],ccadj[i],reglist);
   }
@@ -2583,7 +2584,7 @@ void rmw_assemble(int i,struct regstat *i_regs)
     if(opcode2[i]==15) emit_rmw_orimm(addr,map,imm[i]); // OR.B
   }
   if(jaddr)
-    add_stub(type,jaddr,(int)out,i,addr,(int)i_regs,ccadj[i],reglist);
+    add_stub(type,jaddr,(int)out,i,addr,(pointer)i_regs,ccadj[i],reglist);
 }
 
 void pcrel_assemble(int i,struct regstat *i_regs)
@@ -2829,7 +2830,7 @@ void complex_assemble(int i,struct regstat *i_regs)
     output_modrm(1,4,ECX);
     output_sib(0,4,4);
     output_byte(4);
-    emit_writeword(ECX,slave?(int)&SSH2->cycles:(int)&MSH2->cycles);
+    emit_writeword(ECX,slave?(pointer)&SSH2->cycles:(pointer)&MSH2->cycles);
 //  }*/
     emit_call((pointer)macl);
   }
@@ -2855,7 +2856,7 @@ void complex_assemble(int i,struct regstat *i_regs)
     output_modrm(1,4,ECX);
     output_sib(0,4,4);
     output_byte(4);
-    emit_writeword(ECX,slave?(int)&SSH2->cycles:(int)&MSH2->cycles);
+    emit_writeword(ECX,slave?(pointer)&SSH2->cycles:(pointer)&MSH2->cycles);
 //  }*/
     emit_call((pointer)macw);
   }
@@ -3634,7 +3635,7 @@ void do_ccstub(int n)
   {
     // Save PC as return address
     emit_movimm(stubs[n][5],0);
-    emit_writeword(0,slave?(int)&slave_pc:(int)&master_pc);
+    emit_writeword(0,slave?(pointer)&slave_pc:(pointer)&master_pc);
   }
   else
   {
@@ -3651,7 +3652,7 @@ void do_ccstub(int n)
       else if(opcode[i]==0&&opcode2[i]==11&&opcode3[i]==2) {  // RTE
         r=get_reg(branch_regs[i].regmap,RTEMP);
       }
-      emit_writeword(r,slave?(int)&slave_pc:(int)&master_pc);
+      emit_writeword(r,slave?(pointer)&slave_pc:(pointer)&master_pc);
     }
     else {printf("Unknown branch type in do_ccstub\n");exit(1);}
   }
@@ -3672,7 +3673,7 @@ void do_ccstub(int n)
       load_needed_regs(branch_regs[i].regmap,regs[(ba[i]-start)>>1].regmap_entry);
     else if(itype[i]==RJUMP) {
       if(get_reg(branch_regs[i].regmap,RTEMP)>=0)
-        emit_readword(slave?(int)&slave_pc:(int)&master_pc,get_reg(branch_regs[i].regmap,RTEMP));
+        emit_readword(slave?(pointer)&slave_pc:(pointer)&master_pc,get_reg(branch_regs[i].regmap,RTEMP));
       else
         emit_loadreg(rs1[i],get_reg(branch_regs[i].regmap,rs1[i]));
     }
@@ -3953,7 +3954,7 @@ void rjump_assemble(int i,struct regstat *i_regs)
     emit_addimm(sp,4,sp);
     emit_rorimm(sr,16,sr);
     assert(jaddr);
-    add_stub(LOADS_STUB,jaddr,(int)out,i,sp,(int)(&branch_regs[i]),ccadj[i],reglist);
+    add_stub(LOADS_STUB,jaddr,(int)out,i,sp,(pointer)(&branch_regs[i]),ccadj[i],reglist);
     store_regs_bt(branch_regs[i].regmap,branch_regs[i].dirty,-1);
     emit_addimm_and_set_flags(CLOCK_DIVIDER*(ccadj[i]+cycles[i]+cycles[i+1]),HOST_CCREG);
     add_stub(CC_STUB,(int)out,jump_vaddr_reg[slave][temp],0,i,-1,TAKEN,0);
@@ -4437,7 +4438,7 @@ void system_assemble(int i,struct regstat *i_regs)
     emit_writeword_indexed_map(sr,0,st,map,map);
     emit_rorimm(sr,16,sr);
     if(jaddr) {
-      add_stub(STOREL_STUB,jaddr,(int)out,i,st,(int)i_regs,ccadj[i],reglist);
+      add_stub(STOREL_STUB,jaddr,(int)out,i,st,(pointer)i_regs,ccadj[i],reglist);
     }
     emit_addimm(st,-4,st);
     store_regs_bt(i_regs->regmap,i_regs->dirty,-1);
@@ -4449,7 +4450,7 @@ void system_assemble(int i,struct regstat *i_regs)
     emit_rorimm(sr,16,sr);
     emit_writeword_indexed_map(sr,0,st,map,map);
     if(jaddr) {
-      add_stub(STOREL_STUB,jaddr,(int)out,i,st,(int)i_regs,ccadj[i],reglist);
+      add_stub(STOREL_STUB,jaddr,(int)out,i,st,(pointer)i_regs,ccadj[i],reglist);
     }
     // Load PC
     map=do_map_r(b,b,map,cache,0,-1,-1,0,0);
@@ -4457,7 +4458,7 @@ void system_assemble(int i,struct regstat *i_regs)
     emit_readword_indexed_map(0,b,map,t);
     emit_rorimm(t,16,t);
     if(jaddr)
-      add_stub(LOADL_STUB,jaddr,(int)out,i,t,(int)i_regs,ccadj[i],reglist);
+      add_stub(LOADL_STUB,jaddr,(int)out,i,t,(pointer)i_regs,ccadj[i],reglist);
     if(i_regs->regmap[HOST_CCREG]!=CCREG) {
       emit_loadreg(CCREG,HOST_CCREG);
     }
@@ -4474,7 +4475,7 @@ void bios_assemble(int i,struct regstat *i_regs)
   assert(ccreg==HOST_CCREG);
   assert(!is_delayslot);
   emit_movimm(start+i*2,0);
-  //emit_writeword(0,slave?(int)&slave_pc:(int)&master_pc);
+  //emit_writeword(0,slave?(pointer)&slave_pc:(pointer)&master_pc);
   emit_addimm(HOST_CCREG,CLOCK_DIVIDER*ccadj[i],HOST_CCREG);
   if(slave)
     emit_call((pointer)slave_handle_bios); // Probably doesn't work
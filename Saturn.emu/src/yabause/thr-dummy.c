@@ -35,4 +35,12 @@ void YabThreadRemoteSleep(unsigned int id) {}
 
 void YabThreadWake(unsigned int id) {}
 
+YabEventQueue *YabThreadCreateQueue(int qsize) { return NULL; }
+
+void YabThreadDestroyQueue(YabEventQueue *queue) {}
+
+void YabAddEventQueue(YabEventQueue *queue, void *evcode) {}
+
+void *YabWaitEventQueue(YabEventQueue *queue) { return NULL; }
+
 //////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include <errno.h>
 #include <pthread.h>
 #include <signal.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 //////////////////////////////////////////////////////////////////////////////
@@ -104,3 +105,90 @@ void YabThreadWake(unsigned int id)
 }
 
 //////////////////////////////////////////////////////////////////////////////
+
+struct YabEventQueue_struct
+{
+   void **buffer;
+   int capacity;
+   int size;
+   int in;
+   int out;
+   pthread_mutex_t mutex;
+   pthread_cond_t cond_full;   // Signalled when an event is removed
+   pthread_cond_t cond_empty;  // Signalled when an event is added
+};
+
+YabEventQueue *YabThreadCreateQueue(int qsize)
+{
+   YabEventQueue *queue;
+
+   if ((queue = (YabEventQueue *)calloc(1, sizeof(YabEventQueue))) == NULL)
+      return NULL;
+
+   if ((queue->buffer = (void **)calloc(qsize, sizeof(void *))) == NULL)
+   {
+      free(queue);
+      return NULL;
+   }
+
+   queue->capacity = qsize;
+   pthread_mutex_init(&queue->mutex, NULL);
+   pthread_cond_init(&queue->cond_full, NULL);
+   pthread_cond_init(&queue->cond_empty, NULL);
+
+   return queue;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void YabThreadDestroyQueue(YabEventQueue *queue)
+{
+   if (!queue)
+      return;
+
+   pthread_cond_destroy(&queue->cond_empty);
+   pthread_cond_destroy(&queue->cond_full);
+   pthread_mutex_destroy(&queue->mutex);
+   free(queue->buffer);
+   free(queue);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void YabAddEventQueue(YabEventQueue *queue, void *evcode)
+{
+   pthread_mutex_lock(&queue->mutex);
+
+   while (queue->size == queue->capacity)
+      pthread_cond_wait(&queue->cond_full, &queue->mutex);
+
+   queue->buffer[queue->in] = evcode;
+   queue->in = (queue->in + 1) % queue->capacity;
+   queue->size++;
+
+   pthread_cond_signal(&queue->cond_empty);
+   pthread_mutex_unlock(&queue->mutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void *YabWaitEventQueue(YabEventQueue *queue)
+{
+   void *evcode;
+
+   pthread_mutex_lock(&queue->mutex);
+
+   while (queue->size == 0)
+      pthread_cond_wait(&queue->cond_empty, &queue->mutex);
+
+   evcode = queue->buffer[queue->out];
+   queue->out = (queue->out + 1) % queue->capacity;
+   queue->size--;
+
+   pthread_cond_signal(&queue->cond_full);
+   pthread_mutex_unlock(&queue->mutex);
+
+   return evcode;
+}
+
+//////////////////////////////////////////////////////////////////////////////
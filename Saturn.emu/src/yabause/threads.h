@@ -65,6 +65,28 @@ void YabThreadRemoteSleep(unsigned int id);
 // YabThreadWake:  Wake up the given thread if it is asleep.
 void YabThreadWake(unsigned int id);
 
+///////////////////////////////////////////////////////////////////////////
+// Event queues (bounded FIFOs of pointers for passing work between threads)
+///////////////////////////////////////////////////////////////////////////
+
+typedef struct YabEventQueue_struct YabEventQueue;
+
+// YabThreadCreateQueue:  Create a queue holding up to qsize events.
+// Returns NULL on error.
+YabEventQueue *YabThreadCreateQueue(int qsize);
+
+// YabThreadDestroyQueue:  Free a queue created by YabThreadCreateQueue().
+// No thread may be waiting on the queue.
+void YabThreadDestroyQueue(YabEventQueue *queue);
+
+// YabAddEventQueue:  Append an event to the queue, waiting for another
+// thread to remove one first if the queue is full.
+void YabAddEventQueue(YabEventQueue *queue, void *evcode);
+
+// YabWaitEventQueue:  Remove and return the oldest event in the queue,
+// waiting for another thread to add one if the queue is empty.
+void *YabWaitEventQueue(YabEventQueue *queue);
+
 ///////////////////////////////////////////////////////////////////////////
 
 #endif  // THREADS_H
@@ -429,6 +429,10 @@ void Vdp2ReadRotationTableFP(int which, vdp2rotationparameterfp_struct *paramete
          parameter->coeftbladdr = (((Vdp2Regs->KTAOF >> 8) & 0x7) * 0x10000 + touint(parameter->KAst)) * parameter->coefdatasize;
          parameter->coefmode = (Vdp2Regs->KTCTL >> 10) & 0x3;
       }
+
+      // only 4 byte coefficients hold line color data, which otherwise would
+      // be read from whatever was on the stack
+      parameter->linescreen = 0;
    }
 
    VDP2LOG("Xst: %f, Yst: %f, Zst: %f, deltaXst: %f deltaYst: %f deltaX: %f\n"
@@ -38,6 +38,7 @@
 
 #include <stdlib.h>
 #include <limits.h>
+#include <pthread.h>
 
 #if defined(__APPLE__)
 // malloc pointers always 16-byte aligned
@@ -151,17 +152,40 @@ static int vdp1pixelsize;
 static int vdp1spritetype;
 int vdp2width;
 int vdp2height;
-static int nbg0priority=0;
-static int nbg1priority=0;
-static int nbg2priority=0;
-static int nbg3priority=0;
-static int rbg0priority=0;
+// screen priorities, each band draws from its own copy
+typedef struct
+{
+   int nbg[4];
+   int rbg0;
+} screenpriority_struct;
+
+static screenpriority_struct screenpriority;
 #ifdef USE_OPENGL
 static int outputwidth;
 static int outputheight;
 #endif
 static int resxratio;
 static int resyratio;
+static int mosaic_table[16][1024];
+
+// VDP2 screens are drawn in bands of lines, one per thread, with the calling
+// thread taking the first band
+#define VIDSOFT_MAX_THREADS 4
+
+typedef void (*VIDSoftBandFunc)(int ystart, int yend);
+
+static struct {
+   int numthreads;
+   pthread_t thread[VIDSOFT_MAX_THREADS - 1];
+   pthread_mutex_t mutex;
+   pthread_cond_t workcond;
+   pthread_cond_t donecond;
+   int numbands;
+   VIDSoftBandFunc func;
+   unsigned int generation;
+   int pending;
+   int quit;
+} bands = { 1 };
 
 typedef struct { s16 x; s16 y; } vdp1vertex;
 
@@ -475,6 +499,16 @@ static INLINE void GeneratePlaneAddrTable(vdp2draw_struct *info, u32 *planetbl,
 
 //////////////////////////////////////////////////////////////////////////////
 
+// Identifies the cell a dot falls in, Vdp2MapCalcXY() only reads the pattern
+// name data when this changes
+static INLINE int Vdp2MapCellCheck(vdp2draw_struct *info, int x, int y)
+{
+   const int cellwh=(2 + info->patternwh);
+   return ((y >> cellwh) << 16) | (x >> cellwh);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 static INLINE void FASTCALL Vdp2MapCalcXY(vdp2draw_struct *info, int *x, int *y,
                                  screeninfo_struct *sinfo)
 {
@@ -482,7 +516,7 @@ static INLINE void FASTCALL Vdp2MapCalcXY(vdp2draw_struct *info, int *x, int *y,
    const int pagesize_bits=info->pagewh_bits*2;
    const int cellwh=(2 + info->patternwh);
 
-   const int check = ((y[0] >> cellwh) << 16) | (x[0] >> cellwh);
+   const int check = Vdp2MapCellCheck(info, x[0], y[0]);
    //if ((x[0] >> cellwh) != sinfo->oldcellx || (y[0] >> cellwh) != sinfo->oldcelly)
    if(check != sinfo->oldcellcheck)
    {
@@ -642,10 +676,94 @@ static u8 FASTCALL GetAlpha(vdp2draw_struct * info, u32 color)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
+// Returns whether the lines above ystart have to be stepped through dot by
+// dot, without drawing them, to draw from ystart on. Normally only the per
+// line state has to be brought up to date, but in special priority mode 1
+// each character pattern sets the priority of the dots following it.
+static int Vdp2NeedsReplay(vdp2draw_struct *info, int ystart, int yend)
+{
+   vdp2draw_struct lineinfo;
+   int j;
+
+   if (ystart == 0)
+      return 0;
+   if (info->specialprimode == 1)
+      return 1;
+
+   lineinfo = *info;
+   for (j = 0; j < yend; j++)
+   {
+      lineinfo.LoadLineParams(&lineinfo, j);
+      if (lineinfo.specialprimode == 1)
+         return 1;
+   }
+   return 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static INLINE int Vdp2ScrollX(vdp2draw_struct *info, screeninfo_struct *sinfo, int *mosaic_x, int linescrollx, int i)
+{
+   int x = info->x + mosaic_x[i]*info->coordincx;
+   x &= sinfo->xmask;
+
+   if (linescrollx) {
+      x += linescrollx;
+      x &= 0x3FF;
+   }
+   return x;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Leaves the pattern state as drawing line j of a tile screen would, without
+// going through every dot. Only the pattern of the line's last unclipped dot
+// counts, & it's only read again if some unclipped dot of the line left the
+// cell read before it. That's known from the first & last dots unless both
+// are still in that cell.
+static void Vdp2ReplayScrollLine(vdp2draw_struct *info, screeninfo_struct *sinfo, clipping_struct *clip,
+                                 int *mosaic_x, int linescrollx, int Y, int j)
+{
+   int first, last, i, x, y;
+   int oldcheck = sinfo->oldcellcheck;
+   int changed;
+
+   for (first = 0; first < vdp2width; first++)
+   {
+      if (TestBothWindow(info->wctl, clip, first * resxratio, j))
+         break;
+   }
+   if (first == vdp2width)
+      return;
+   for (last = vdp2width - 1; last > first; last--)
+   {
+      if (TestBothWindow(info->wctl, clip, last * resxratio, j))
+         break;
+   }
+
+   changed = Vdp2MapCellCheck(info, Vdp2ScrollX(info, sinfo, mosaic_x, linescrollx, first), Y) != oldcheck ||
+             Vdp2MapCellCheck(info, Vdp2ScrollX(info, sinfo, mosaic_x, linescrollx, last), Y) != oldcheck;
+   for (i = first + 1; i < last && !changed; i++)
+   {
+      if (TestBothWindow(info->wctl, clip, i * resxratio, j))
+         changed = Vdp2MapCellCheck(info, Vdp2ScrollX(info, sinfo, mosaic_x, linescrollx, i), Y) != oldcheck;
+   }
+   if (!changed)
+      return;
+
+   sinfo->oldcellcheck = -1;
+   x = Vdp2ScrollX(info, sinfo, mosaic_x, linescrollx, last);
+   y = Y;
+   Vdp2MapCalcXY(info, &x, &y, sinfo);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info, int ystart, int yend)
 {
    int i, j;
    int x, y;
+   int replay = Vdp2NeedsReplay(info, ystart, yend);
    clipping_struct clip[2];
    u32 linewnd0addr, linewnd1addr;
    screeninfo_struct sinfo;
@@ -667,24 +785,12 @@ static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
    ReadLineWindowData(&info->islinewindow, info->wctl, &linewnd0addr, &linewnd1addr);
    /* color calculation window: in => no color calc, out => color calc */
    ReadWindowData(Vdp2Regs->WCTLD >> 8, colorcalcwindow);
-   {
-	   static int tables_initialized = 0;
-	   static int mosaic_table[16][1024];
-	   if(!tables_initialized)
-	   {
-		   tables_initialized = 1;
-			for(i=0;i<16;i++)
-			{
-				int m = i+1;
-				for(j=0;j<1024;j++)
-					mosaic_table[i][j] = j/m*m;
-			}
-	   }
-	   mosaic_x = mosaic_table[info->mosaicxmask-1];
-	   mosaic_y = mosaic_table[info->mosaicymask-1];
-   }
+   mosaic_x = mosaic_table[info->mosaicxmask-1];
+   mosaic_y = mosaic_table[info->mosaicymask-1];
 
-   for (j = 0; j < vdp2height; j++)
+   // lines before ystart are stepped through only to advance the line
+   // scroll & line window tables
+   for (j = 0; j < yend; j++)
    {
       int Y;
       int linescrollx = 0;
@@ -735,6 +841,13 @@ static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
 
       info->LoadLineParams(info, j);
 
+      if (j < ystart)
+      {
+         if (replay && !info->isbitmap)
+            Vdp2ReplayScrollLine(info, &sinfo, clip, mosaic_x, linescrollx, Y, j);
+         continue;
+      }
+
       for (i = 0; i < vdp2width; i++)
       {
          u32 color;
@@ -750,13 +863,7 @@ static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
          }
 
          //x = info->x+((int)(info->coordincx*(float)((info->mosaicxmask > 1) ? (i / info->mosaicxmask * info->mosaicxmask) : i)));
-		 x = info->x + mosaic_x[i]*info->coordincx;
-         x &= sinfo.xmask;
-		 
-         if (linescrollx) {
-            x += linescrollx;
-            x &= 0x3FF;
-         }
+         x = Vdp2ScrollX(info, &sinfo, mosaic_x, linescrollx, i);
 
          // Fetch Pixel, if it isn't transparent, continue
          if (!info->isbitmap)
@@ -794,10 +901,12 @@ static void FASTCALL Vdp2DrawScroll(vdp2draw_struct *info)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparameterfp_struct *parameter)
+static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparameterfp_struct *parameter, int ystart, int yend)
 {
    int i, j;
    int x, y;
+   int lineend;
+   int replay = Vdp2NeedsReplay(info, ystart, yend);
    screeninfo_struct sinfo;
    vdp2rotationparameterfp_struct *p=&parameter[info->rotatenum];
    clipping_struct clip[2];
@@ -833,12 +942,13 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
 
          SetupScreenVars(info, &sinfo, info->PlaneAddr);
 
-         for (j = 0; j < vdp2height; j++)
+         for (j = 0; j < yend; j++)
          {
             info->LoadLineParams(info, j);
             ReadLineWindowClip(info->islinewindow, clip, &linewnd0addr, &linewnd1addr);
 
-            for (i = 0; i < vdp2width; i++)
+            lineend = (j < ystart && !replay) ? 0 : vdp2width;
+            for (i = 0; i < lineend; i++)
             {
                u32 color;
 
@@ -854,6 +964,9 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
                   // Tile
                   Vdp2MapCalcXY(info, &x, &y, &sinfo);
                }
+
+               if (j < ystart)
+                  continue;
  
                // Fetch pixel
                if (!Vdp2FetchPixel(info, x, y, &color))
@@ -934,7 +1047,7 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
          lineInc = Vdp2Regs->LCTA.part.U & 0x8000 ? 2 : 0;
       }
 
-      for (j = 0; j < vdp2height; j++)
+      for (j = 0; j < yend; j++)
       {
          if (p->deltaKAx == 0)
          {
@@ -953,10 +1066,13 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
 
          if (info->linescreen > 1)
          {
-            lineColorAddr = (T1ReadWord(Vdp2Ram, lineAddr) & 0x780) | p->linescreen;
-            lineColor = Vdp2ColorRamGetColor(lineColorAddr);
+            if (j >= ystart)
+            {
+               lineColorAddr = (T1ReadWord(Vdp2Ram, lineAddr) & 0x780) | p->linescreen;
+               lineColor = Vdp2ColorRamGetColor(lineColorAddr);
+               TitanPutLineHLine(info->linescreen, j, COLSAT2YAB32(0x3F, lineColor));
+            }
             lineAddr += lineInc;
-            TitanPutLineHLine(info->linescreen, j, COLSAT2YAB32(0x3F, lineColor));
          }
 
          info->LoadLineParams(info, j);
@@ -965,7 +1081,33 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
          if (userpwindow)
             ReadLineWindowClip(isrplinewindow, rpwindow, &rplinewnd0addr, &rplinewnd1addr);
 
-         for (i = 0; i < vdp2width; i++)
+         if (j < ystart && !replay)
+         {
+            // Line belongs to an earlier band. Every coefficient read sets
+            // the same parameter fields, so reading the one for the line's
+            // last dot leaves them as drawing the whole line would.
+            if (p->deltaKAx != 0)
+            {
+               Vdp2ReadCoefficientFP(p,
+                                     p->coeftbladdr +
+                                     (coefy + (vdp2width - 1) * toint(p->deltaKAx) +
+                                     toint((vdp2width - 1) * decipart(p->deltaKAx) + rcoefy)) *
+                                     p->coefdatasize);
+            }
+            if ((p2 != NULL) && p2->coefenab && (p2->deltaKAx != 0))
+            {
+               Vdp2ReadCoefficientFP(p2,
+                                     p2->coeftbladdr +
+                                     (coefy2 + (vdp2width - 1) * toint(p2->deltaKAx) +
+                                     toint((vdp2width - 1) * decipart(p2->deltaKAx) + rcoefy2)) *
+                                     p2->coefdatasize);
+            }
+            lineend = 0;
+         }
+         else
+            lineend = vdp2width;
+
+         for (i = 0; i < lineend; i++)
          {
             u32 color;
 
@@ -1053,6 +1195,9 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
                }
             }
 
+            if (j < ystart)
+               continue;
+
             // Fetch pixel
             if (!Vdp2FetchPixel(info, x, y, &color))
             {
@@ -1084,7 +1229,7 @@ static void FASTCALL Vdp2DrawRotationFP(vdp2draw_struct *info, vdp2rotationparam
       return;
    }
 
-   Vdp2DrawScroll(info);
+   Vdp2DrawScroll(info, ystart, yend);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1187,7 +1332,7 @@ static void LoadLineParamsNBG0(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void Vdp2DrawNBG0(void)
+static void Vdp2DrawNBG0(int priority, int ystart, int yend)
 {
    vdp2draw_struct info;
    vdp2rotationparameterfp_struct parameter[2];
@@ -1287,7 +1432,7 @@ static void Vdp2DrawNBG0(void)
 
    info.coloroffset = (Vdp2Regs->CRAOFA & 0x7) << 8;
    ReadVdp2ColorOffset(Vdp2Regs, &info, 0x1, 0x1);
-   info.priority = nbg0priority;
+   info.priority = priority;
 
    if (!(info.enable & Vdp2External.disptoggle))
       return;
@@ -1312,12 +1457,12 @@ static void Vdp2DrawNBG0(void)
    if (info.enable == 1)
    {
       // NBG0 draw
-      Vdp2DrawScroll(&info);
+      Vdp2DrawScroll(&info, ystart, yend);
    }
    else
    {
       // RBG1 draw
-      Vdp2DrawRotationFP(&info, parameter);
+      Vdp2DrawRotationFP(&info, parameter, ystart, yend);
    }
 }
 
@@ -1335,7 +1480,7 @@ static void LoadLineParamsNBG1(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void Vdp2DrawNBG1(void)
+static void Vdp2DrawNBG1(int priority, int ystart, int yend)
 {
    vdp2draw_struct info;
 
@@ -1390,7 +1535,7 @@ static void Vdp2DrawNBG1(void)
    info.coordincx = (Vdp2Regs->ZMXN1.all & 0x7FF00) / (float) 65536;
    info.coordincy = (Vdp2Regs->ZMYN1.all & 0x7FF00) / (float) 65536;
 
-   info.priority = nbg1priority;
+   info.priority = priority;
    info.PlaneAddr = (void FASTCALL (*)(void *, int))&Vdp2NBG1PlaneAddr;
 
    if (!(info.enable & Vdp2External.disptoggle) ||
@@ -1419,7 +1564,7 @@ static void Vdp2DrawNBG1(void)
 
    info.LoadLineParams = (void (*)(void *, int)) LoadLineParamsNBG1;
 
-   Vdp2DrawScroll(&info);
+   Vdp2DrawScroll(&info, ystart, yend);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1436,7 +1581,7 @@ static void LoadLineParamsNBG2(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void Vdp2DrawNBG2(void)
+static void Vdp2DrawNBG2(int priority, int ystart, int yend)
 {
    vdp2draw_struct info;
 
@@ -1471,7 +1616,7 @@ static void Vdp2DrawNBG2(void)
    ReadVdp2ColorOffset(Vdp2Regs, &info, 0x4, 0x4);
    info.coordincx = info.coordincy = 1;
 
-   info.priority = nbg2priority;
+   info.priority = priority;
    info.PlaneAddr = (void FASTCALL (*)(void *, int))&Vdp2NBG2PlaneAddr;
 
    if (!(info.enable & Vdp2External.disptoggle) ||
@@ -1486,7 +1631,7 @@ static void Vdp2DrawNBG2(void)
 
    info.LoadLineParams = (void (*)(void *, int)) LoadLineParamsNBG2;
 
-   Vdp2DrawScroll(&info);
+   Vdp2DrawScroll(&info, ystart, yend);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1503,7 +1648,7 @@ static void LoadLineParamsNBG3(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void Vdp2DrawNBG3(void)
+static void Vdp2DrawNBG3(int priority, int ystart, int yend)
 {
    vdp2draw_struct info;
 
@@ -1539,7 +1684,7 @@ static void Vdp2DrawNBG3(void)
    ReadVdp2ColorOffset(Vdp2Regs, &info, 0x8, 0x8);
    info.coordincx = info.coordincy = 1;
 
-   info.priority = nbg3priority;
+   info.priority = priority;
    info.PlaneAddr = (void FASTCALL (*)(void *, int))&Vdp2NBG3PlaneAddr;
 
    if (!(info.enable & Vdp2External.disptoggle) ||
@@ -1555,7 +1700,7 @@ static void Vdp2DrawNBG3(void)
 
    info.LoadLineParams = (void (*)(void *, int)) LoadLineParamsNBG3;
 
-   Vdp2DrawScroll(&info);
+   Vdp2DrawScroll(&info, ystart, yend);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1572,7 +1717,7 @@ static void LoadLineParamsRBG0(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
-static void Vdp2DrawRBG0(void)
+static void Vdp2DrawRBG0(int priority, int ystart, int yend)
 {
    vdp2draw_struct info;
    vdp2rotationparameterfp_struct parameter[2];
@@ -1581,7 +1726,7 @@ static void Vdp2DrawRBG0(void)
    parameter[1].PlaneAddr = (void FASTCALL (*)(void *, int))&Vdp2ParameterBPlaneAddr;
 
    info.enable = Vdp2Regs->BGON & 0x10;
-   info.priority = rbg0priority;
+   info.priority = priority;
    if (!(info.enable & Vdp2External.disptoggle))
       return;
    info.transparencyenable = !(Vdp2Regs->BGON & 0x1000);
@@ -1676,7 +1821,7 @@ static void Vdp2DrawRBG0(void)
 
    info.LoadLineParams = (void (*)(void *, int)) LoadLineParamsRBG0;
 
-   Vdp2DrawRotationFP(&info, parameter);
+   Vdp2DrawRotationFP(&info, parameter, ystart, yend);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -1692,8 +1837,134 @@ static void LoadLineParamsSprite(vdp2draw_struct * info, int line)
 
 //////////////////////////////////////////////////////////////////////////////
 
+static INLINE int BandStart(int band)
+{
+   return vdp2height * band / bands.numbands;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void *VIDSoftBandThread(void *arg)
+{
+   int band = (int)(intptr_t)arg;
+   unsigned int generation = 0;
+
+   pthread_mutex_lock(&bands.mutex);
+   for (;;)
+   {
+      VIDSoftBandFunc func;
+
+      while (!bands.quit && bands.generation == generation)
+         pthread_cond_wait(&bands.workcond, &bands.mutex);
+      if (bands.quit)
+         break;
+      generation = bands.generation;
+      func = bands.func;
+      pthread_mutex_unlock(&bands.mutex);
+
+      func(BandStart(band), BandStart(band + 1));
+
+      pthread_mutex_lock(&bands.mutex);
+      if (--bands.pending == 0)
+         pthread_cond_signal(&bands.donecond);
+   }
+   pthread_mutex_unlock(&bands.mutex);
+   return NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void VIDSoftStartBandThreads(void)
+{
+   int i;
+
+   bands.numbands = 1;
+   if (bands.numthreads < 2)
+      return;
+
+   pthread_mutex_init(&bands.mutex, NULL);
+   pthread_cond_init(&bands.workcond, NULL);
+   pthread_cond_init(&bands.donecond, NULL);
+   bands.generation = 0;
+   bands.quit = 0;
+
+   for (i = 1; i < bands.numthreads; i++)
+   {
+      if (pthread_create(&bands.thread[i - 1], NULL, VIDSoftBandThread, (void *)(intptr_t)i) != 0)
+         break;
+   }
+   bands.numbands = i;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void VIDSoftStopBandThreads(void)
+{
+   int i;
+
+   if (bands.numbands < 2)
+      return;
+
+   pthread_mutex_lock(&bands.mutex);
+   bands.quit = 1;
+   pthread_cond_broadcast(&bands.workcond);
+   pthread_mutex_unlock(&bands.mutex);
+
+   for (i = 1; i < bands.numbands; i++)
+      pthread_join(bands.thread[i - 1], NULL);
+
+   pthread_cond_destroy(&bands.donecond);
+   pthread_cond_destroy(&bands.workcond);
+   pthread_mutex_destroy(&bands.mutex);
+   bands.numbands = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Calls func for each band of lines and returns once all bands are drawn.
+// Each call draws the same pixels in the same order as a single call
+// covering the whole screen would, so the output doesn't depend on the
+// number of threads.
+static void VIDSoftRunBands(VIDSoftBandFunc func)
+{
+   if (bands.numbands < 2)
+   {
+      func(0, vdp2height);
+      return;
+   }
+
+   pthread_mutex_lock(&bands.mutex);
+   bands.func = func;
+   bands.pending = bands.numbands - 1;
+   bands.generation++;
+   pthread_cond_broadcast(&bands.workcond);
+   pthread_mutex_unlock(&bands.mutex);
+
+   func(0, BandStart(1));
+
+   pthread_mutex_lock(&bands.mutex);
+   while (bands.pending)
+      pthread_cond_wait(&bands.donecond, &bands.mutex);
+   pthread_mutex_unlock(&bands.mutex);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftSetNumThreads(int num)
+{
+   if (num < 1)
+      num = 1;
+   else if (num > VIDSOFT_MAX_THREADS)
+      num = VIDSOFT_MAX_THREADS;
+   bands.numthreads = num;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 int VIDSoftInit(void)
 {
+   int i, j;
+
    if (TitanInit() == -1)
       return -1;
 
@@ -1713,6 +1984,15 @@ int VIDSoftInit(void)
    vdp2width = 320;
    vdp2height = 224;
 
+   for (i = 0; i < 16; i++)
+   {
+      int m = i + 1;
+      for (j = 0; j < 1024; j++)
+         mosaic_table[i][j] = j / m * m;
+   }
+
+   VIDSoftStartBandThreads();
+
 #ifdef USE_OPENGL
    glClear(GL_COLOR_BUFFER_BIT);
 
@@ -1734,6 +2014,8 @@ int VIDSoftInit(void)
 
 void VIDSoftDeInit(void)
 {
+   VIDSoftStopBandThreads();
+
    if (dispbuffer)
    {
       free(dispbuffer);
@@ -2832,7 +3114,7 @@ void VIDSoftVdp2DrawStart(void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp2DrawEnd(void)
+static void Vdp2DrawSpriteLines(int ystart, int yend)
 {
    int i, i2;
    u16 pixel;
@@ -2874,7 +3156,6 @@ void VIDSoftVdp2DrawEnd(void)
       colorcalctable[7] = ((~Vdp2Regs->CCRSD >> 7) & 0x3E) + 1;
 
       vdp1coloroffset = (Vdp2Regs->CRAOFB & 0x70) << 4;
-      vdp1spritetype = Vdp2Regs->SPCTL & 0xF;
 
       ReadVdp2ColorOffset(Vdp2Regs, &info, 0x40, 0x40);
 
@@ -2891,12 +3172,15 @@ void VIDSoftVdp2DrawEnd(void)
       if (Vdp1Regs->TVMR & 2)
          Vdp2ReadRotationTableFP(0, &p);
 
-      for (i2 = 0; i2 < vdp2height; i2++)
+      for (i2 = 0; i2 < yend; i2++)
       {
          ReadLineWindowClip(islinewindow, clip, &linewnd0addr, &linewnd1addr);
 
          LoadLineParamsSprite(&info, i2);
 
+         if (i2 < ystart)
+            continue;
+
          for (i = 0; i < vdp2width; i++)
          {
             // See if screen position is clipped, if it isn't, continue
@@ -3075,7 +3359,26 @@ void VIDSoftVdp2DrawEnd(void)
          }
       }
    }
-   TitanRender(dispbuffer);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void Vdp2DrawEndLines(int ystart, int yend)
+{
+   Vdp2DrawSpriteLines(ystart, yend);
+   TitanRenderLines(dispbuffer, ystart, yend);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp2DrawEnd(void)
+{
+#ifdef USE_OPENGL
+   int i;
+#endif
+
+   vdp1spritetype = Vdp2Regs->SPCTL & 0xF;
+   VIDSoftRunBands(Vdp2DrawEndLines);
 
    VIDSoftVdp1SwapFrameBuffer();
 
@@ -3101,10 +3404,30 @@ void VIDSoftVdp2DrawEnd(void)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void VIDSoftVdp2DrawScreens(void)
+static void Vdp2DrawScreensLines(int ystart, int yend)
 {
+   screenpriority_struct priority = screenpriority;
    int i;
 
+   for (i = 7; i > 0; i--)
+   {   
+      if (priority.nbg[3] == i)
+         Vdp2DrawNBG3(i, ystart, yend);
+      if (priority.nbg[2] == i)
+         Vdp2DrawNBG2(i, ystart, yend);
+      if (priority.nbg[1] == i)
+         Vdp2DrawNBG1(i, ystart, yend);
+      if (priority.nbg[0] == i)
+         Vdp2DrawNBG0(i, ystart, yend);
+      if (priority.rbg0 == i)
+         Vdp2DrawRBG0(i, ystart, yend);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void VIDSoftVdp2DrawScreens(void)
+{
    VIDSoftVdp2SetResolution(Vdp2Regs->TVMD);
    VIDSoftVdp2SetPriorityNBG0(Vdp2Regs->PRINA & 0x7);
    VIDSoftVdp2SetPriorityNBG1((Vdp2Regs->PRINA >> 8) & 0x7);
@@ -3112,19 +3435,7 @@ void VIDSoftVdp2DrawScreens(void)
    VIDSoftVdp2SetPriorityNBG3((Vdp2Regs->PRINB >> 8) & 0x7);
    VIDSoftVdp2SetPriorityRBG0(Vdp2Regs->PRIR & 0x7);
 
-   for (i = 7; i > 0; i--)
-   {   
-      if (nbg3priority == i)
-         Vdp2DrawNBG3();
-      if (nbg2priority == i)
-         Vdp2DrawNBG2();
-      if (nbg1priority == i)
-         Vdp2DrawNBG1();
-      if (nbg0priority == i)
-         Vdp2DrawNBG0();
-      if (rbg0priority == i)
-         Vdp2DrawRBG0();
-   }
+   VIDSoftRunBands(Vdp2DrawScreensLines);
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -3140,19 +3451,19 @@ void VIDSoftVdp2DrawScreen(int screen)
    switch(screen)
    {
       case 0:
-         Vdp2DrawNBG0();
+         Vdp2DrawNBG0(screenpriority.nbg[0], 0, vdp2height);
          break;
       case 1:
-         Vdp2DrawNBG1();
+         Vdp2DrawNBG1(screenpriority.nbg[1], 0, vdp2height);
          break;
       case 2:
-         Vdp2DrawNBG2();
+         Vdp2DrawNBG2(screenpriority.nbg[2], 0, vdp2height);
          break;
       case 3:
-         Vdp2DrawNBG3();
+         Vdp2DrawNBG3(screenpriority.nbg[3], 0, vdp2height);
          break;
       case 4:
-         Vdp2DrawRBG0();
+         Vdp2DrawRBG0(screenpriority.rbg0, 0, vdp2height);
          break;
    }
 }
@@ -3235,35 +3546,35 @@ void VIDSoftVdp2SetResolution(u16 TVMD)
 
 void FASTCALL VIDSoftVdp2SetPriorityNBG0(int priority)
 {
-   nbg0priority = priority;
+   screenpriority.nbg[0] = priority;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void FASTCALL VIDSoftVdp2SetPriorityNBG1(int priority)
 {
-   nbg1priority = priority;
+   screenpriority.nbg[1] = priority;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void FASTCALL VIDSoftVdp2SetPriorityNBG2(int priority)
 {
-   nbg2priority = priority;
+   screenpriority.nbg[2] = priority;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void FASTCALL VIDSoftVdp2SetPriorityNBG3(int priority)
 {
-   nbg3priority = priority;
+   screenpriority.nbg[3] = priority;
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
 void FASTCALL VIDSoftVdp2SetPriorityRBG0(int priority)
 {
-   rbg0priority = priority;
+   screenpriority.rbg0 = priority;
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -30,4 +30,8 @@ extern VideoInterface_struct VIDSoft;
 
 void VIDSoftVdp2DrawScreen(int screen);
 
+// Number of threads, including the emulation thread, drawing VDP2 screens
+// in bands of lines. Takes effect on the next VIDSoftInit().
+void VIDSoftSetNumThreads(int num);
+
 #endif
@@ -0,0 +1,101 @@
+/*  Runs prog.s through the M68KQ68 interface in slices of varying cycle
+	counts, with periodic level 2 interrupts & an external write to the
+	program's code halfway through, like the SH2 writing to sound RAM.
+	Prints the final state, or the state after every slice with "trace".
+	usage: q68test <slices> [trace] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "core.h"
+#include "m68kcore.h"
+#include "prog.h"
+
+extern M68K_struct M68KQ68;
+
+static uint8_t ram[0x80000];
+static int misaligned;
+static unsigned irqAcks;
+
+// translated code calls back into C, so also check it keeps the stack aligned
+__attribute__((noinline)) static void checkAlign(void)
+{
+	void *p = __builtin_frame_address(0);
+	if((uintptr_t)p & 15)
+		misaligned++;
+}
+
+static u32 FASTCALL readB(u32 a) { checkAlign(); return a < 0x100000 ? ram[a & 0x7FFFF] : 0; }
+static u32 FASTCALL readW(u32 a) { checkAlign(); a &= 0x7FFFE; return ram[a] << 8 | ram[a+1]; }
+static void FASTCALL writeB(u32 a, u32 d) { checkAlign(); if(a < 0x100000) ram[a & 0x7FFFF] = d; }
+
+static void FASTCALL writeW(u32 a, u32 d)
+{
+	checkAlign();
+	if(a >= 0x100000)
+	{
+		if(a == 0x100002)
+		{
+			irqAcks++;
+			M68KQ68.SetIRQ(0);
+		}
+		return;
+	}
+	a &= 0x7FFFE;
+	ram[a] = d >> 8;
+	ram[a+1] = d;
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 2)
+	{
+		fprintf(stderr, "usage: %s <slices> [trace]\n", argv[0]);
+		return 1;
+	}
+	memcpy(ram, prog, sizeof(prog));
+	int slices = atoi(argv[1]);
+	int trace = argc > 2;
+	M68KQ68.Init();
+	M68KQ68.SetReadB(readB);
+	M68KQ68.SetReadW(readW);
+	M68KQ68.SetWriteB(writeB);
+	M68KQ68.SetWriteW(writeW);
+	M68KQ68.Reset();
+	uint64_t total = 0, requested = 0;
+	int64_t debt = 0;
+	for(int i = 0; i < slices; i++)
+	{
+		int cycles = 50 + (i * 37) % 200;
+		if(i % 97 == 40)
+			M68KQ68.SetIRQ(2);
+		if(i == slices / 2)
+		{
+			// patch the immediate of the "move.l #1, %d5" in smc
+			uint32_t a = 0x4ac + 2;
+			ram[a+2] = 0x12;
+			ram[a+3] = 0x34;
+			M68KQ68.WriteNotify(a, 4);
+		}
+		requested += cycles;
+		// like scsp.c, carry any overrun into the next slice
+		int run = cycles - debt;
+		int ran = run > 0 ? M68KQ68.Exec(run) : 0;
+		debt = ran - run > 0 ? ran - run : 0;
+		total += ran;
+		if(trace)
+			printf("%d ran %d pc %06x d1 %08x d2 %08x d3 %08x d4 %08x d6 %08x d7 %08x\n", i, ran, M68KQ68.GetPC(),
+				M68KQ68.GetDReg(1), M68KQ68.GetDReg(2), M68KQ68.GetDReg(3), M68KQ68.GetDReg(4), M68KQ68.GetDReg(6), M68KQ68.GetDReg(7));
+	}
+	uint64_t h = 0xcbf29ce484222325;
+	for(size_t i = 0; i < sizeof(ram); i++)
+		h = (h ^ ram[i]) * 0x100000001b3;
+	printf("requested %llu ran %llu pc %06x sr %04x acks %u misaligned %d\n", (unsigned long long)requested,
+		(unsigned long long)total, M68KQ68.GetPC(), M68KQ68.GetSR(), irqAcks, misaligned);
+	for(int i = 0; i < 8; i++)
+		printf("d%d %08x a%d %08x\n", i, M68KQ68.GetDReg(i), i, M68KQ68.GetAReg(i));
+	printf("ram %016llx\n", (unsigned long long)h);
+	M68KQ68.DeInit();
+	return 0;
+}
@@ -0,0 +1,16 @@
+# converts the assembled test program to a C array, applying the absolute
+# relocations llvm-objcopy leaves as zeroes
+# usage: llvm-readelf -r prog.o | mkprog.py prog.bin prog.h
+import struct, sys
+prog = bytearray(open(sys.argv[1], 'rb').read())
+for line in sys.stdin:
+    f = line.split()
+    if len(f) > 2 and f[2] == 'R_68K_32':
+        offset = int(f[0], 16); addend = int(f[-1], 16)
+        prog[offset:offset + 4] = struct.pack('>I', addend)
+with open(sys.argv[2], 'w') as out:
+    out.write('// generated from prog.s by "make prog.h"\n\n')
+    out.write('static const uint8_t prog[] =\n{\n')
+    for i in range(0, len(prog), 16):
+        out.write('\t' + ', '.join('0x%02x' % b for b in prog[i:i + 16]) + ',\n')
+    out.write('};\n')
@@ -0,0 +1,70 @@
+# Q68 JIT test program: loops, shifts, MULU/DIVS, EXG, subroutines,
+# self-modifying code & a level 2 interrupt handler that acks by writing
+# 0x100000, the main loop never ends so results depend on the cycle count
+	.text
+vectors:
+	.long 0x8000, start
+	.fill 22, 4, 0
+	.long 0, 0, irq2, 0, 0, 0, 0, 0
+	.fill 0x400 - (. - vectors), 1, 0
+start:
+	.short 0x46fc, 0x2000
+	move.l #0x2000, %a0
+	move.l #0x12345678, %d1
+	move.l #255, %d2
+fill:
+	move.l %d1, (%a0)+
+	rol.l #5, %d1
+	add.l #0x9e3779b9, %d1
+	.short 0x51ca, fill - .
+	move.l #0x2000, %a0
+	move.l #255, %d2
+	.short 0x4283
+sum:
+	move.l (%a0)+, %d1
+	add.l %d1, %d3
+	move.l %d1, %d4
+	and.l #15, %d4
+	lsr.l %d4, %d1
+	eor.l %d1, %d3
+	mulu %d1, %d4
+	add.l %d4, %d3
+	.short 0x51ca, sum - .
+	move.l #1000, %d0
+	lea smc, %a1
+	.short 0x6100, sub - .
+	move.l #0x55aa, %d1
+	        .short 0x2341, 0x0002
+	.short 0x6100, sub - .
+	move.l #7, %d1
+	divs %d1, %d3
+main:
+	.short 0x5287
+	move.w %d7, %d1
+	and.l #0x3fc, %d1
+	move.l #0x2000, %a0
+	        .short 0xd1c1
+	add.l (%a0), %d3
+	.short 0xc744
+	add.l %d1, %d4
+	.short 0xc744
+	lea smc, %a1
+	.short 0x6100, sub - .
+	bra main
+sub:
+	.short 0x48e7, 0xf000
+	move.l #20, %d2
+1:
+	jsr smc
+	add.l %d5, %d6
+	.short 0x51ca, 1b - .
+	.short 0x4cdf, 0x000f
+	rts
+smc:
+	move.l #1, %d5
+	rts
+irq2:
+	        .short 0x23c6, 0x0010, 0x0000
+	.short 0x5286
+	add.l #0x10000, %d7
+	.short 0x4e73
@@ -0,0 +1,84 @@
+/*  Runs a test BIOS image for a number of frames with the chosen SH2 core &
+	prints the master SH2's registers & a hash of high work RAM so the
+	interpreter & dynarec results can be compared.
+	usage: sh2test <core id> <bios.bin> [frames] */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "yabause.h"
+#include "sh2core.h"
+#include "sh2int.h"
+#include "memory.h"
+#include "peripheral.h"
+#include "cdbase.h"
+#include "scsp.h"
+#include "vdp1.h"
+#include "m68kcore.h"
+#include "cs0.h"
+#include "sh2_dynarec/sh2_dynarec.h"
+
+SH2Interface_struct *SH2CoreList[] = { &SH2Interpreter, &SH2Dynarec, NULL };
+PerInterface_struct *PERCoreList[] = { &PERDummy, NULL };
+CDInterface *CDCoreList[] = { &DummyCD, NULL };
+SoundInterface_struct *SNDCoreList[] = { &SNDDummy, NULL };
+VideoInterface_struct *VIDCoreList[] = { &VIDDummy, NULL };
+M68K_struct *M68KCoreList[] = { &M68KQ68, NULL };
+
+void YuiSwapBuffers(void) {}
+void YuiSetVideoAttribute(int type, int val) {}
+int YuiSetVideoMode(int w, int h, int bpp, int fs) { return 0; }
+void YuiErrorMsg(const char *s) { fprintf(stderr, "yui: %s\n", s); }
+int OSDUseBuffer(void) { return 0; }
+int OSDChangeCore(int id) { return 0; }
+void OSDDisplayMessages(void *buf, int w, int h) {}
+void OSDPushMessage(int id, int timeleft, const char *fmt, ...) {}
+void DisplayMessage(const char *str) {}
+
+int main(int argc, char **argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "usage: %s <core id> <bios.bin> [frames]\n", argv[0]);
+		return 1;
+	}
+	yabauseinit_struct yinit;
+	memset(&yinit, 0, sizeof(yinit));
+	yinit.percoretype = PERCORE_DUMMY;
+	yinit.sh2coretype = atoi(argv[1]);
+	yinit.vidcoretype = VIDCORE_DUMMY;
+	yinit.sndcoretype = SNDCORE_DUMMY;
+	yinit.m68kcoretype = M68KCORE_Q68;
+	yinit.cdcoretype = CDCORE_DUMMY;
+	yinit.carttype = CART_NONE;
+	yinit.regionid = REGION_AUTODETECT;
+	yinit.biospath = argv[2];
+	yinit.cdpath = "";
+	yinit.buppath = "";
+	yinit.mpegpath = "";
+	yinit.cartpath = "";
+	yinit.videoformattype = VIDEOFORMATTYPE_NTSC;
+	yinit.clocksync = 1;
+	if(YabauseInit(&yinit) != 0)
+	{
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+	int frames = argc > 3 ? atoi(argv[3]) : 10;
+	for(int i = 0; i < frames; i++)
+		YabauseEmulate();
+	sh2regs_struct r;
+	SH2GetRegisters(MSH2, &r);
+	for(int i = 0; i < 16; i++)
+		printf("R%d=%08X ", i, r.R[i]);
+	printf("\nSR=%08X GBR=%08X MACH=%08X MACL=%08X PR=%08X PC=%08X\n",
+		r.SR.all & 0x3F3, r.GBR, r.MACH, r.MACL, r.PR, r.PC);
+	unsigned h = 2166136261u;
+	for(int i = 0; i < 0x100000; i++)
+		h = (h ^ HighWram[i]) * 16777619u;
+	printf("HighWram hash %08X first words:", h);
+	for(int i = 0; i < 8; i++)
+		printf(" %08X", MappedMemoryReadLong(0x06000000 + i * 4));
+	printf("\n");
+	return 0;
+}
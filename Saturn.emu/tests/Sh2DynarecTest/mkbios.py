@@ -0,0 +1,66 @@
+# tiny SH-2 assembler that builds a test program into a fake BIOS image
+# usage: mkbios.py <program.py> <bios.bin>
+import struct, sys
+code = {}  # addr -> u16
+labels = {}
+lits = []
+prog = []
+def L(name): prog.append(('label', name))
+def op(fmt, *a): prog.append(('op', fmt, a))
+R = lambda n: n
+# instructions are lambdas resolving with (pc, labels)
+def emit(f): prog.append(('fn', f))
+def movi(imm, n): emit(lambda pc: 0xE000 | n << 8 | (imm & 0xFF))
+def movl_lit(label, n): emit(lambda pc: 0xD000 | n << 8 | ((labels[label] - ((pc & ~3) + 4)) // 4))
+def r2(base, m, n): emit(lambda pc: base | n << 8 | m << 4)
+def r1(base, n): emit(lambda pc: base | n << 8)
+def bf(label): emit(lambda pc: 0x8B00 | (((labels[label] - (pc + 4)) // 2) & 0xFF))
+def bt(label): emit(lambda pc: 0x8900 | (((labels[label] - (pc + 4)) // 2) & 0xFF))
+def bra(label): emit(lambda pc: 0xA000 | (((labels[label] - (pc + 4)) // 2) & 0xFFF))
+def bsr(label): emit(lambda pc: 0xB000 | (((labels[label] - (pc + 4)) // 2) & 0xFFF))
+def raw(v): emit(lambda pc: v)
+def align4():
+    prog.append(('align4',))
+def lit(name, val): prog.append(('lit', name, val))
+add=lambda m,n: r2(0x300C,m,n); sub=lambda m,n: r2(0x3008,m,n)
+addc=lambda m,n: r2(0x300E,m,n); subc=lambda m,n: r2(0x300A,m,n)
+xor=lambda m,n: r2(0x200A,m,n); and_=lambda m,n: r2(0x2009,m,n); or_=lambda m,n: r2(0x200B,m,n)
+mull=lambda m,n: r2(0x0007,m,n); dmuls=lambda m,n: r2(0x300D,m,n); dmulu=lambda m,n: r2(0x3005,m,n)
+movl_st=lambda m,n: r2(0x2002,m,n); movw_st=lambda m,n: r2(0x2001,m,n); movb_st=lambda m,n: r2(0x2000,m,n)
+movl_ld=lambda m,n: r2(0x6002,m,n); movw_ld=lambda m,n: r2(0x6001,m,n); movb_ld=lambda m,n: r2(0x6000,m,n)
+movl_ldinc=lambda m,n: r2(0x6006,m,n); movl_stdec=lambda m,n: r2(0x2006,m,n)
+mov=lambda m,n: r2(0x6003,m,n); extub=lambda m,n: r2(0x600C,m,n); extsw=lambda m,n: r2(0x600F,m,n)
+swapw=lambda m,n: r2(0x6009,m,n); cmpgt=lambda m,n: r2(0x3007,m,n); cmphi=lambda m,n: r2(0x3006,m,n)
+div1=lambda m,n: r2(0x3004,m,n); neg=lambda m,n: r2(0x600B,m,n); not_=lambda m,n: r2(0x6007,m,n)
+rotl=lambda n: r1(0x4004,n); rotcr=lambda n: r1(0x4025,n); shll2=lambda n: r1(0x4008,n); shlr=lambda n: r1(0x4001,n)
+shar=lambda n: r1(0x4021,n); dt=lambda n: r1(0x4010,n); movt=lambda n: r1(0x0029,n)
+stsmacl=lambda n: r1(0x001A,n); stsmach=lambda n: r1(0x000A,n); stspr=lambda n: r1(0x002A,n)
+jsr=lambda m: r1(0x400B,m); jmp=lambda m: r1(0x402B,m); ldspr=lambda m: r1(0x402A,m)
+stsl_pr_dec=lambda n: r1(0x4022,n); ldsl_pr_inc=lambda m: r1(0x4026,m)
+addi=lambda imm,n: emit(lambda pc: 0x7000 | n<<8 | (imm & 0xFF))
+macl=lambda m,n: r2(0x000F,m,n); macw=lambda m,n: r2(0x400F,m,n); div0s=lambda m,n: r2(0x2007,m,n)
+rotcl=lambda n: r1(0x4024,n); clrmac=lambda: raw(0x0028)
+nop=lambda: raw(0x0009); rts=lambda: raw(0x000B); div0u=lambda: raw(0x0019); clrt=lambda: raw(0x0008); sett=lambda: raw(0x0018)
+
+exec(open(sys.argv[1]).read())
+
+def layout():
+    pc = 0x400; out = []
+    for p in prog:
+        if p[0] == 'label': labels[p[1]] = pc
+        elif p[0] == 'fn': out.append((pc, p[1])); pc += 2
+        elif p[0] == 'align4':
+            if pc & 3: out.append((pc, lambda pc: 0x0009)); pc += 2
+        elif p[0] == 'lit':
+            labels[p[1]] = pc; v = p[2]
+            rv = lambda v: labels[v] if isinstance(v, str) else v
+            out.append((pc, lambda pc, v=v: rv(v) >> 16)); out.append((pc+2, lambda pc, v=v: rv(v) & 0xFFFF)); pc += 4
+    return out
+out = layout()
+rom = bytearray(0x80000)
+struct.pack_into('>II', rom, 0, 0x400, 0x06010000)
+for pc, f in out:
+    v = f(pc) if callable(f) else f
+    v = v(pc) if callable(v) else v
+    struct.pack_into('>H', rom, pc, v & 0xFFFF)
+open(sys.argv[2], 'wb').write(rom)
@@ -0,0 +1,91 @@
+# ALU, MAC, branches, delay slots & self-modifying code in high work RAM
+movl_lit('ram', 5)        # r5 = 0x06000000 results
+movi(0, 0)
+movl_lit('seed', 1)
+movi(100, 2)
+movi(0, 4)
+movl_lit('subaddr', 6)
+movi(-3, 7)
+movi(0, 8)
+L('loop')
+add(2, 0)
+xor(0, 1)
+rotl(1)
+mull(1, 0)
+stsmacl(3)
+add(3, 4)
+dmuls(1, 7)
+stsmach(9)
+addc(9, 8)
+mov(5, 10)
+addi(0x40, 10)
+movb_st(0, 10)
+movb_ld(10, 11)
+add(11, 8)
+movw_st(1, 10)
+movw_ld(10, 12)
+extub(12, 13)
+sub(13, 4)
+swapw(4, 13)
+cmpgt(13, 8)
+movt(14)
+add(14, 0)
+jsr(6)
+nop()
+dt(2)
+bf('loop')
+nop()
+# self-modifying code: copy 'smc' routine into high work ram, run, patch, run
+movl_lit('smcdst', 10)
+movl_lit('smcsrc', 11)
+movi(4, 12)
+L('copy')
+movl_ldinc(11, 13)
+movl_st(13, 10)
+addi(4, 10)
+dt(12)
+bf('copy')
+nop()
+movl_lit('smcdst', 10)
+jsr(10)
+nop()
+mov(0, 3)
+movl_lit('patch', 13)     # replace mov #1,r0 with mov #0x55,r0
+movl_lit('smcdst', 10)
+movw_st(13, 10)
+jsr(10)
+nop()
+add(3, 0)
+# store registers
+movl_st(0, 5); addi(4, 5)
+movl_st(1, 5); addi(4, 5)
+movl_st(4, 5); addi(4, 5)
+movl_st(8, 5); addi(4, 5)
+movl_st(9, 5); addi(4, 5)
+movl_st(14, 5); addi(4, 5)
+L('halt')
+bra('halt')
+nop()
+# subroutine: mixes r1 into r7 and a shifted value
+L('sub')
+shlr(7)
+rotcr(1)
+shar(7)
+xor(1, 7)
+neg(7, 9)
+not_(9, 9)
+rts()
+add(9, 8)                  # delay slot
+align4()
+L('smc')
+movi(1, 0)
+addi(7, 0)
+rts()
+shll2(0)
+align4()
+lit('ram', 0x06000000)
+lit('seed', 0x12345)
+lit('subaddr', 'sub')
+lit('smcdst', 0x06004000)
+lit('smcsrc', 'smc')
+lit('patch', 0xE055)
@@ -0,0 +1,103 @@
+# MAC.L/W & DIV1 in a routine copied to 0x06002000 that writes data to its
+# own 4K page, run many times
+movl_lit('dst', 10)
+movl_lit('src', 11)
+movl_lit('len', 12)
+L('copy')
+movl_ldinc(11, 13)
+movl_st(13, 10)
+addi(4, 10)
+dt(12)
+bf('copy')
+nop()
+# fill a table of 8 longs at 0x06002800 (same 4K page as the routine)
+movl_lit('table', 10)
+movl_lit('seed', 1)
+movi(8, 12)
+L('fill')
+movl_st(1, 10)
+addi(4, 10)
+rotl(1)
+addi(0x35, 1)
+dt(12)
+bf('fill')
+nop()
+movl_lit('iters', 2)
+movi(0, 8)
+movi(0, 9)
+movl_lit('dst', 6)
+L('outer')
+jsr(6)
+nop()
+dt(2)
+bf('outer')
+nop()
+movl_lit('ram', 5)
+movl_st(0, 5); addi(4, 5)
+movl_st(1, 5); addi(4, 5)
+movl_st(3, 5); addi(4, 5)
+movl_st(4, 5); addi(4, 5)
+movl_st(7, 5); addi(4, 5)
+movl_st(8, 5); addi(4, 5)
+movl_st(9, 5); addi(4, 5)
+stsmacl(13); movl_st(13, 5); addi(4, 5)
+stsmach(13); movl_st(13, 5); addi(4, 5)
+L('halt')
+bra('halt')
+nop()
+align4()
+L('routine')
+# MAC.L over 4 pairs of the table
+movl_lit('table', 3)
+mov(3, 4)
+addi(16, 4)
+clrmac()
+macl(3, 4)
+macl(3, 4)
+macl(3, 4)
+macl(3, 4)
+# MAC.W over 4 pairs
+movl_lit('table', 3)
+mov(3, 4)
+addi(8, 4)
+macw(3, 4)
+macw(3, 4)
+stsmacl(7)
+add(7, 8)
+# unsigned divide r1:r2' (hi:lo) by r0 using div1
+mov(8, 1)
+movi(0x0F, 13)
+and_(13, 1)              # small high part so the quotient fits
+mov(9, 7)
+movl_lit('divisor', 0)
+div0u()
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1); rotcl(7); div1(0, 1)
+rotcl(7)
+add(7, 9)
+xor(1, 9)
+# write back into the table, on the same page as this code
+movl_lit('table', 3)
+movl_st(9, 3)
+movl_lit('table', 4)
+addi(20, 4)
+movl_st(8, 4)
+rts()
+nop()
+align4()
+lit('table', 0x06002800)
+lit('divisor', 0x0001F3A7)
+L('routine_end')
+align4()
+lit('dst', 0x06002000)
+lit('src', 'routine')
+lit('len', 64)
+lit('seed', 0x9E3779B9)
+lit('iters', 60000)
+lit('ram', 0x06000000)
@@ -0,0 +1,189 @@
+/*  Draws synthetic VDP2 frames with the software renderer using the given
+	number of band threads & prints a hash of every frame, so drawing in
+	bands can be compared against drawing on one thread. Each scene starts
+	from random VRAM, color RAM, VDP1 framebuffers & registers, then changes
+	some of them every frame & between lines. Many frames use special
+	priority mode 1, which makes the bands step through earlier lines dot by
+	dot.
+	usage: vdp2test <threads> <frames> */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include "yabause.h"
+#include "vdp1.h"
+#include "vdp2.h"
+#include "vidsoft.h"
+#include "sh2core.h"
+#include "sh2int.h"
+#include "peripheral.h"
+#include "cdbase.h"
+#include "scsp.h"
+#include "m68kcore.h"
+
+SH2Interface_struct *SH2CoreList[] = { &SH2Interpreter, NULL };
+PerInterface_struct *PERCoreList[] = { &PERDummy, NULL };
+CDInterface *CDCoreList[] = { &DummyCD, NULL };
+SoundInterface_struct *SNDCoreList[] = { &SNDDummy, NULL };
+VideoInterface_struct *VIDCoreList[] = { &VIDSoft, NULL };
+M68K_struct *M68KCoreList[] = { &M68KQ68, NULL };
+
+void YuiSwapBuffers(void) {}
+void YuiSetVideoAttribute(int type, int val) {}
+int YuiSetVideoMode(int w, int h, int bpp, int fs) { return 0; }
+void YuiErrorMsg(const char *s) { fprintf(stderr, "yui: %s\n", s); }
+int OSDUseBuffer(void) { return 0; }
+int OSDChangeCore(int id) { return 0; }
+int OSDDisplayMessages(pixel_t *buf, int w, int h) { return 0; }
+void OSDPushMessage(int id, int timeleft, const char *fmt, ...) {}
+void DisplayMessage(const char *str) {}
+
+extern u8 *vdp1framebuffer[2];
+extern int vdp2width, vdp2height;
+void VIDSoftVdp2SetResolution(u16 TVMD);
+void VIDSoftVdp2DrawStart(void);
+void VIDSoftVdp2DrawScreens(void);
+void VIDSoftVdp2DrawEnd(void);
+
+// The renderer reads VRAM without masking the address, so table & plane
+// addresses built from random registers can point past the 512KB. Give it a
+// buffer covering the largest of them, with VRAM mirrored like on hardware.
+#define VRAM_SIZE 0x80000
+#define VRAM_MAPPED_SIZE 0x400000
+
+static unsigned rngState;
+
+static unsigned rng(void)
+{
+	// xorshift32
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static void writeVram(u32 addr, u8 val)
+{
+	u32 a;
+	for(a = addr % VRAM_SIZE; a < VRAM_MAPPED_SIZE; a += VRAM_SIZE)
+		Vdp2Ram[a] = val;
+}
+
+// Keeps the coefficient table reads of both rotation parameters inside the
+// mapped VRAM: a start address within the first 64K entries & increments
+// that can't go negative.
+static void limitRotationTables(void)
+{
+	u32 base = (Vdp2Regs->RPTA.all << 1) & 0x000FFF7C;
+	int which;
+	for(which = 0; which < 2; which++)
+	{
+		u32 table = base + which * 0x80;
+		T1WriteLong(Vdp2Ram, table + 0x54, (rng() & 0xFFFF) << 16);
+		T1WriteLong(Vdp2Ram, table + 0x58, rng() & 0xFFC0);
+		T1WriteLong(Vdp2Ram, table + 0x5C, rng() % 4 ? rng() & 0xFFC0 : 0);
+	}
+}
+
+static void writeRegister(u32 addr, u16 val)
+{
+	switch(addr)
+	{
+		case 0x00: // TVMD, display on & any resolution
+			val = 0x8000 | (val & 0xF7);
+			Vdp2WriteWord(addr, val);
+			VIDSoftVdp2SetResolution(val);
+			return;
+		case 0x02: case 0x04: case 0x06: // EXTEN, TVSTAT, VCNT
+			return;
+	}
+	Vdp2WriteWord(addr, val);
+}
+
+static void randomScene(void)
+{
+	u32 i;
+	for(i = 0; i < VRAM_SIZE; i++)
+		writeVram(i, rng());
+	for(i = 0; i < 0x1000; i++)
+		Vdp2ColorRam[i] = rng();
+	for(i = 0; i < 0x40000; i++)
+	{
+		vdp1framebuffer[0][i] = rng();
+		vdp1framebuffer[1][i] = rng();
+	}
+	for(i = 0; i < 0x120; i += 2)
+		writeRegister(i, rng());
+}
+
+static void changeScene(void)
+{
+	unsigned changes = rng() % 16, i;
+	int line, specialPriority = rng() % 3;
+	for(i = 0; i < changes; i++)
+	{
+		switch(rng() % 4)
+		{
+			case 0: writeVram(rng(), rng()); break;
+			case 1: Vdp2ColorRam[rng() % 0x1000] = rng(); break;
+			case 2: case 3: writeRegister((rng() % 0x120) & ~1, rng()); break;
+		}
+	}
+	limitRotationTables();
+	// save the registers of each line like during emulation, using special
+	// priority mode 1 for all screens in a third of the frames & switching
+	// it on & off between lines in another
+	if(specialPriority == 1)
+		writeRegister(0xEA, 0x0155);
+	for(line = 0; line < 270; line++)
+	{
+		if(specialPriority == 2 && rng() % 8 == 0)
+			writeRegister(0xEA, rng() % 2 ? 0x0155 : 0);
+		if(rng() % 32 == 0)
+			writeRegister(0x110 + (rng() % 8) * 2, rng()); // color offset
+		yabsys.LineCount = line;
+		Vdp2HBlankOUT();
+	}
+}
+
+int main(int argc, char **argv)
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "usage: %s <threads> <frames>\n", argv[0]);
+		return 1;
+	}
+	int frames = atoi(argv[2]);
+	if(Vdp1Init() != 0 || Vdp2Init() != 0)
+	{
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+	T1MemoryDeInit(Vdp2Ram);
+	Vdp2Ram = calloc(VRAM_MAPPED_SIZE, 1);
+	VIDSoftSetNumThreads(atoi(argv[1]));
+	if(VIDSoft.Init() != 0)
+	{
+		fprintf(stderr, "init failed\n");
+		return 1;
+	}
+	for(unsigned seed = 1; seed <= 4; seed++)
+	{
+		rngState = seed * 2654435761u;
+		randomScene();
+		for(int f = 0; f < frames; f++)
+		{
+			changeScene();
+			VIDSoftVdp2DrawStart();
+			VIDSoftVdp2DrawScreens();
+			VIDSoftVdp2DrawEnd();
+			unsigned h = 2166136261u;
+			const u8 *p = (const u8 *)dispbuffer;
+			for(size_t i = 0; i < sizeof(pixel_t) * vdp2width * vdp2height; i++)
+				h = (h ^ p[i]) * 16777619u;
+			printf("seed %u frame %d (%dx%d): %08X\n", seed, f, vdp2width, vdp2height, h);
+		}
+	}
+	VIDSoft.DeInit();
+	return 0;
+}
@@ -26,7 +26,10 @@ bool EmuSystem::hasCheats = true;
 bool EmuSystem::hasPALVideoSystem = true;
 bool EmuSystem::hasResetModes = true;
 #ifdef SNES9X_VERSION_1_4
+bool EmuSystem::hasMemoryStates = false;
 static uint audioFramesPerUpdate = 0;
+#else
+bool EmuSystem::hasMemoryStates = true;
 #endif
 
 EmuSystem::NameFilterFunc EmuSystem::defaultFsFilter =
@@ -144,6 +147,28 @@ EmuSystem::Error EmuSystem::loadState(const char *path)
 		return EmuSystem::makeFileReadError();
 }
 
+#ifndef SNES9X_VERSION_1_4
+EmuSystem::Error EmuSystem::saveState(IG::ByteBuffer &buff)
+{
+	if(!buff.resize(S9xFreezeSize()))
+		return makeError("Out of memory");
+	if(!S9xFreezeGameMem(buff.data(), buff.size()))
+		return makeFileWriteError();
+	return {};
+}
+
+EmuSystem::Error EmuSystem::loadState(const IG::ByteBuffer &buff)
+{
+	if(S9xUnfreezeGameMem(buff.data(), buff.size()) == SUCCESS)
+	{
+		IPPU.RenderThisFrame = TRUE;
+		return {};
+	}
+	else
+		return makeFileReadError();
+}
+#endif
+
 void EmuSystem::saveBackupMem() // for manually saving when not closing game
 {
 	if(gameIsRunning())
@@ -60,6 +60,11 @@ bool8 S9xContinueUpdate(int width, int height)
 
 void S9xHandlePortCommand(s9xcommand_t cmd, int16 data1, int16 data2) {}
 
+void S9xPollInput()
+{
+	EmuSystem::pollInput();
+}
+
 bool8 S9xOpenSoundDevice()
 {
 	return TRUE;
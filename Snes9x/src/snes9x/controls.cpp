@@ -2871,6 +2871,9 @@ void S9xSetJoypadLatch (bool latch)
 	{
 		int	i;
 
+		if (!S9xMovieActive())
+			S9xPollInput();
+
 		for (int n = 0; n < 2; n++)
 		{
 			for (int j = 0; j < 2; j++)
@@ -411,6 +411,10 @@ bool S9xPollAxis (uint32 id, int16 *value);
 
 void S9xHandlePortCommand (s9xcommand_t cmd, int16 data1, int16 data2);
 
+// Called when the joypads are latched, outside of movie playback or recording, so your port can update the joypad bits with input received since the frame started.
+
+void S9xPollInput (void);
+
 // Called before already-read SNES joypad data is being used by the game if your port defines SNES_JOY_READ_CALLBACKS.
 
 #ifdef SNES_JOY_READ_CALLBACKS
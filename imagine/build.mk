@@ -20,6 +20,9 @@ endif
 
 include $(imagineSrcDir)/thread/system.mk
 include $(imagineSrcDir)/time/system.mk
+ifeq ($(imagine_profiler), 1)
+ include $(imagineSrcDir)/time/Profiler.mk
+endif
 include $(imagineSrcDir)/audio/system.mk
 include $(imagineSrcDir)/input/system.mk
 include $(imagineSrcDir)/gfx/system.mk
@@ -33,6 +36,7 @@ include $(imagineSrcDir)/font/system.mk
 include $(imagineSrcDir)/data-type/image/system.mk
 include $(imagineSrcDir)/mem/malloc.mk
 include $(imagineSrcDir)/util/system/pagesize.mk
+include $(imagineSrcDir)/util/audio/PolyphaseResampler.mk
 include $(imagineSrcDir)/logger/system.mk
 include $(buildSysPath)/package/stdc++.mk
 SRC += util/string/generic.cc
@@ -135,6 +135,11 @@ void setOnSystemOrientationChanged(SystemOrientationChangedDelegate del);
 // Called on app startup
 [[gnu::cold]] void onInit(int argc, char** argv);
 
+// Called on app startup before the window system is initialized, on platforms
+// that support it. Returning true exits with exitCode without calling onInit(),
+// allowing command line tools that don't need a display.
+[[gnu::cold]] bool onHeadlessInit(int argc, char** argv, int &exitCode);
+
 } // Base
 
 namespace Config
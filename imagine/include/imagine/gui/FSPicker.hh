@@ -16,6 +16,8 @@
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <vector>
+#include <string>
+#include <memory>
 #include <system_error>
 #include <imagine/config/defs.hh>
 #include <imagine/gfx/GfxText.hh>
@@ -24,6 +26,7 @@
 #include <imagine/gfx/Texture.hh>
 #include <imagine/input/Input.hh>
 #include <imagine/fs/FS.hh>
+#include <imagine/base/Pipe.hh>
 #include <imagine/gui/TableView.hh>
 #include <imagine/gui/MenuItem.hh>
 #include <imagine/util/DelegateFunc.hh>
@@ -42,6 +45,7 @@ public:
 
 	FSPicker(ViewAttachParams attach, Gfx::PixmapTexture *backRes, Gfx::PixmapTexture *closeRes,
 			FilterFunc filter = {}, bool singleDir = false, Gfx::GlyphTextureSet *face = &View::defaultFace);
+	~FSPicker();
 	void place() override;
 	bool inputEvent(Input::Event e) override;
 	void draw() override;
@@ -71,6 +75,20 @@ public:
 	FS::PathString makePathString(const char *base) const;
 
 protected:
+	struct FileEntry
+	{
+		std::string name;
+		bool isDir;
+	};
+	// heap allocated so the item's text & select delegate can point
+	// to the entry while new ones are merged into the list
+	struct FileItem
+	{
+		FileEntry entry;
+		TextMenuItem text{};
+	};
+	struct DirScan;
+
 	FilterFunc filter{};
 	TableView tbl;
 	OnChangePathDelegate onChangePath_{};
@@ -83,8 +101,10 @@ protected:
 		}
 	};
 	OnPathReadError onPathReadError_{};
-	std::vector<TextMenuItem> text{};
-	std::vector<FS::FileString> dir{};
+	std::vector<std::unique_ptr<FileItem>> dir{};
+	// directory contents are read on a separate thread & added as they arrive
+	std::shared_ptr<DirScan> dirScan{};
+	Base::Pipe scanPipe{};
 	FS::PathString currPath{};
 	IG::WindowRect viewFrame{};
 	Gfx::GlyphTextureSet *faceRes{};
@@ -92,6 +112,11 @@ protected:
 	std::array<char, 48> msgStr{};
 	Gfx::Text msgText{};
 	bool singleDir = false;
+	bool highlightFirstEntry = false;
 
 	void changeDirByInput(const char *path, bool forcePathChange, Input::Event e);
+	void startDirScan(FS::directory_iterator dirIt);
+	void cancelDirScan();
+	void addScannedEntries();
+	std::unique_ptr<FileItem> makeFileItem(FileEntry entry);
 };
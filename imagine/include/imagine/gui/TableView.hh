@@ -20,6 +20,7 @@
 #include <imagine/input/Input.hh>
 #include <imagine/gfx/Gfx.hh>
 #include <imagine/gui/ScrollView.hh>
+#include <vector>
 
 class MenuItem;
 
@@ -56,7 +57,17 @@ public:
 	uint cells() { return items(*this); }
 	IG::WP cellSize() const { return {viewFrame.x, yCellSize}; }
 	void highlightCell(int idx);
+	int highlightedCell() const { return selected; }
+	// the highlighted cell if it's visible, otherwise the first visible one,
+	// or -1 before the table is placed
+	int anchorCell() const;
+	// call after inserting cells with how many went before the anchor &
+	// highlighted cells so the rows on screen stay in place
+	void cellsInserted(uint beforeAnchor, uint beforeHighlighted);
 	void setAlign(_2DOrigin align);
+	// only compile items as they scroll into view instead of all of them in place(),
+	// for tables with many items that all have the same height
+	void setCompileVisibleItemsOnly(bool on);
 	static void setDefaultXIndent(const Gfx::ProjectionPlane &projP);
 	static MenuItem& derefMenuItem(MenuItem *item)
 	{
@@ -70,15 +81,18 @@ public:
 protected:
 	bool onlyScrollIfNeeded = false;
 	bool selectedIsActivated = false;
+	bool compileVisibleItemsOnly = false;
 	int yCellSize = 0;
 	int selected = -1;
 	int visibleCells = 0;
 	IG::WindowRect viewFrame{};
 	_2DOrigin align{LC2DO};
+	std::vector<bool> isCompiled{};
 	ItemsDelegate items{};
 	ItemDelegate item{};
 
 	void setYCellSize(int s);
+	void compileItem(uint idx);
 	IG::WindowRect focusRect();
 	virtual void onSelectElement(Input::Event e, uint i, MenuItem &item);
 	bool elementIsSelectable(MenuItem &item);
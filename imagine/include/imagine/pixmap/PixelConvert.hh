@@ -0,0 +1,42 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/pixmap/PixelFormat.hh>
+#include <cstddef>
+
+// Bulk pixel conversion over runs of pixels, using SSE2/AVX2 or NEON where
+// available with the AVX2 versions selected at runtime. 32-bit formats are
+// in memory byte order, matching how textures are uploaded, so RGBA8888
+// stores red in the lowest byte.
+
+namespace IG
+{
+
+// look up each index in a palette, palettes with 16-bit entries
+// must have an even number of entries
+void paletteLookup(uint16 *dest, const uint8 *src, const uint16 *palette, size_t pixels);
+void paletteLookup(uint32 *dest, const uint8 *src, const uint32 *palette, size_t pixels);
+void paletteLookup(uint16 *dest, const uint16 *src, const uint16 *palette, size_t pixels);
+void paletteLookup(uint32 *dest, const uint16 *src, const uint32 *palette, size_t pixels);
+
+// convert between RGB565 & RGBA8888/BGRA8888 or copy when both formats match,
+// returns false if the conversion isn't supported
+bool canConvertPixels(PixelFormatID destFormat, PixelFormatID srcFormat);
+bool convertPixels(PixelFormatID destFormat, void *dest, PixelFormatID srcFormat, const void *src, size_t pixels);
+
+}
@@ -19,6 +19,7 @@
 #include <imagine/pixmap/PixelFormat.hh>
 #include <imagine/util/rectangle2.h>
 #include <imagine/util/DelegateFunc.hh>
+#include <imagine/time/Profiler.hh>
 
 namespace IG
 {
@@ -71,8 +72,16 @@ public:
 		{}
 
 	char *pixel(IG::WP pos) const;
+	// copy a pixmap, converting it with writeConverted() if the formats differ
 	void write(const IG::Pixmap &pixmap);
 	void write(const IG::Pixmap &pixmap, IG::WP destPos);
+	// write an 8 or 16-bit indexed pixmap, looking up each pixel in a
+	// palette with entries the same size as this pixmap's pixels
+	void writePaletted(const IG::Pixmap &pixmap, const uint16 *palette);
+	void writePaletted(const IG::Pixmap &pixmap, const uint32 *palette);
+	// write a pixmap converting it to this pixmap's format,
+	// returns false if the formats aren't supported by convertPixels()
+	bool writeConverted(const IG::Pixmap &pixmap);
 
 	template <class FUNC>
 	static constexpr bool checkTransformFunc()
@@ -90,6 +99,7 @@ public:
 		{
 			return;
 		}
+		IG_PROFILE_SCOPE("Pixmap::writeTransformed");
 		auto srcBytesPerPixel = pixmap.format().bytesPerPixel();
 		switch(format().bytesPerPixel())
 		{
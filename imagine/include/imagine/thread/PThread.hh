@@ -18,6 +18,7 @@
 #include <imagine/config/defs.hh>
 #include <imagine/util/utility.h>
 #include <pthread.h>
+#include <type_traits>
 
 namespace IG
 {
@@ -27,7 +28,7 @@ static pthread_t makePThread(F func)
 {
 	int res;
 	pthread_t id;
-	if(sizeof(F) <= sizeof(void*))
+	if constexpr(sizeof(F) <= sizeof(void*) && std::is_trivially_copyable<F>::value)
 	{
 		// inline function object data into the void* parameter
 		union FuncData
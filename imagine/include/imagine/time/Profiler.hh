@@ -0,0 +1,79 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <imagine/util/preprocessor/concat.h>
+#include <cstdint>
+
+// Scoped timers for hot paths, compiled in only when building with
+// imagine_profiler := 1 which defines CONFIG_PROFILER. Each thread records
+// into its own fixed-size ring so recording never takes a lock, older events
+// are overwritten once a ring fills. Rings of exited threads are reused by new
+// ones, so maxThreads limits threads alive at once.
+
+namespace IG
+{
+
+namespace Profiler
+{
+
+#ifdef CONFIG_PROFILER
+
+static constexpr uint eventsPerThread = 32768;
+static constexpr uint maxThreads = 16;
+static constexpr uint maxFrames = 256;
+
+uint64_t nowNSecs();
+// name must point to a string with static storage duration
+void addEvent(const char *name, uint64_t startNSecs, uint64_t endNSecs);
+// name shown for the calling thread in exported traces
+void setThreadName(const char *name);
+// record the end of a displayed frame, also added to traces as a "Frame" event
+void markFrame();
+// copy up to max of the most recent frame durations, oldest first
+uint recentFrameTimes(uint64_t *nSecs, uint max);
+// write all recorded events in Chrome's trace event JSON format,
+// viewable in chrome://tracing or Perfetto
+bool writeChromeTrace(const char *path);
+
+class Scope
+{
+public:
+	Scope(const char *name): name{name}, startNSecs{nowNSecs()} {}
+	~Scope() { addEvent(name, startNSecs, nowNSecs()); }
+	Scope(const Scope &) = delete;
+	Scope &operator=(const Scope &) = delete;
+
+private:
+	const char *name;
+	uint64_t startNSecs;
+};
+
+#define IG_PROFILE_SCOPE(name) IG::Profiler::Scope PP_concat(profilerScope_, __LINE__){name}
+
+#else
+
+inline void setThreadName(const char *) {}
+inline void markFrame() {}
+
+#define IG_PROFILE_SCOPE(name)
+
+#endif
+
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/util/ansiTypes.h>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace IG
+{
+
+// Growable byte buffer that keeps its allocation when shrunk or cleared,
+// so repeated fills of similar size don't touch the heap
+
+class ByteBuffer
+{
+public:
+	constexpr ByteBuffer() {}
+
+	ByteBuffer(ByteBuffer &&o)
+	{
+		*this = std::move(o);
+	}
+
+	ByteBuffer &operator=(ByteBuffer &&o)
+	{
+		std::free(data_);
+		data_ = std::exchange(o.data_, nullptr);
+		size_ = std::exchange(o.size_, 0);
+		capacity_ = std::exchange(o.capacity_, 0);
+		return *this;
+	}
+
+	ByteBuffer(const ByteBuffer &) = delete;
+	ByteBuffer &operator=(const ByteBuffer &) = delete;
+
+	~ByteBuffer()
+	{
+		std::free(data_);
+	}
+
+	uint8 *data() { return data_; }
+	const uint8 *data() const { return data_; }
+	size_t size() const { return size_; }
+	size_t capacity() const { return capacity_; }
+	bool empty() const { return !size_; }
+	explicit operator bool() const { return size_; }
+
+	bool reserve(size_t capacity)
+	{
+		if(capacity <= capacity_)
+			return true;
+		auto newData = (uint8*)std::realloc(data_, capacity);
+		if(!newData)
+			return false;
+		data_ = newData;
+		capacity_ = capacity;
+		return true;
+	}
+
+	bool resize(size_t size)
+	{
+		if(!reserve(size))
+			return false;
+		size_ = size;
+		return true;
+	}
+
+	bool assign(const void *data, size_t size)
+	{
+		if(!resize(size))
+			return false;
+		if(size)
+			std::memcpy(data_, data, size);
+		return true;
+	}
+
+	bool append(const void *data, size_t size)
+	{
+		auto oldSize = size_;
+		if(!reserve(oldSize + size))
+			return false;
+		if(size)
+			std::memcpy(data_ + oldSize, data, size);
+		size_ = oldSize + size;
+		return true;
+	}
+
+	void clear()
+	{
+		size_ = 0;
+	}
+
+	void deinit()
+	{
+		std::free(data_);
+		data_ = nullptr;
+		size_ = capacity_ = 0;
+	}
+
+protected:
+	uint8 *data_{};
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+};
+
+}
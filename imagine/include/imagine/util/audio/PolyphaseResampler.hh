@@ -0,0 +1,86 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/config/defs.hh>
+#include <cstddef>
+#include <vector>
+
+// Converts interleaved 16-bit audio between arbitrary sample rates with a
+// Kaiser windowed sinc FIR. The filter is stored as a table of phases with
+// Q15 coefficients and each output sample interpolates between the two
+// nearest phases, so the rate ratio doesn't need to be rational and can be
+// adjusted while streaming without rebuilding the table. The dot products
+// use SSE2/AVX2 or NEON where available with AVX2 selected at runtime.
+//
+// The filter length scales with the downsampling ratio, so large ratios
+// (like the ~44:1 of the Game Boy APU) should be brought closer to the
+// output rate by a cheap decimator first.
+
+namespace Audio
+{
+
+class PolyphaseResampler
+{
+public:
+	static constexpr uint maxChannels = 2;
+	static constexpr uint defaultTaps = 48;
+
+	PolyphaseResampler() {}
+	// taps is the filter length at a 1:1 ratio and is rounded up to a
+	// multiple of 16, gain is applied to the output
+	bool init(uint32 inRate, uint32 outRate, uint channels, uint taps = defaultTaps, float gain = 1.f);
+	// change the ratio without touching the filter or buffered input,
+	// intended for small adjustments like matching the host's audio clock
+	void setRate(uint32 inRate, uint32 outRate);
+	// discard all buffered input
+	void reset();
+	// append frames to the input buffer
+	void push(const int16 *in, size_t frames);
+	// write up to frames of output, returning the number written
+	size_t pull(int16 *out, size_t frames);
+	// number of output frames that can be pulled with the current input
+	size_t framesAvailable() const;
+	// push all input & pull all output, out must hold maxOut(frames)
+	size_t resample(int16 *out, const int16 *in, size_t frames);
+	// upper bound on the output of resample() for the given input frames
+	size_t maxOut(size_t inFrames) const;
+	uint32 inRate() const { return inRate_; }
+	uint32 outRate() const { return outRate_; }
+	uint taps() const { return taps_; }
+	double ratio() const { return (double)outRate_ / inRate_; }
+	explicit operator bool() const { return channels; }
+
+	using DotProductFunc = void(*)(const int16 *in, const int16 *coeff0, const int16 *coeff1, uint taps, int32 &sum0, int32 &sum1);
+
+private:
+	static constexpr uint phaseBits = 7;
+	static constexpr uint phases = 1 << phaseBits;
+
+	std::vector<int16> coeff{};
+	std::vector<int16> history[maxChannels]{};
+	uint64_t pos = 0; // 32.32 fixed point position in history
+	uint64_t step = 0;
+	size_t historyFrames = 0;
+	DotProductFunc dotProduct{};
+	uint32 inRate_ = 0, outRate_ = 0;
+	uint taps_ = 0;
+	uint channels = 0;
+
+	void compact();
+};
+
+}
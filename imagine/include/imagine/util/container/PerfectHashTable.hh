@@ -0,0 +1,201 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/util/ansiTypes.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace IG
+{
+
+// Read-only lookup table for a fixed set of entries, like a game database,
+// built at compile time with a perfect hash so a lookup reads one bucket
+// seed, one slot & compares one key. Keys are hashed into buckets, then
+// each bucket, largest first, gets the first seed that maps its keys to
+// free slots (the "hash & displace" method). Slots hold 16-bit indices into
+// a copy of the entries, so nothing in the table needs relocating. Declare
+// tables constexpr & static_assert isValid() so construction can't fall
+// back to running at startup.
+//
+// KEY_TRAITS provides:
+//   using Key = ...;
+//   static constexpr Key key(const T &entry);
+//   static constexpr uint64_t hash(Key key); // mixed internally, so CRCs & digest words can be used as-is
+//   static constexpr bool equal(Key a, Key b);
+// Entries with duplicate keys keep the first one, like a linear search.
+
+template <class T, size_t N, class KEY_TRAITS>
+class PerfectHashTable
+{
+public:
+	using Key = typename KEY_TRAITS::Key;
+	static constexpr size_t buckets = N / 4 + 1;
+	// power of 2 with at least 1.5x as many slots as entries
+	static constexpr size_t slots = []()
+		{
+			size_t slots = 1;
+			while(slots < N + N / 2)
+				slots <<= 1;
+			return slots;
+		}();
+	static_assert(N < 0xFFFF, "too many entries for 16-bit slot indices");
+
+	constexpr PerfectHashTable(const T (&entries)[N])
+	{
+		uint64_t hash[N]{};
+		uint16 bucketStart[buckets + 1]{};
+		uint16 member[N]{};
+		bool duplicate[N]{};
+		for(size_t i = 0; i < N; i++)
+		{
+			entry[i] = entries[i];
+			hash[i] = mix(KEY_TRAITS::hash(KEY_TRAITS::key(entries[i])));
+			bucketStart[bucketIndex(hash[i]) + 1]++;
+		}
+		for(size_t b = 0; b < buckets; b++)
+		{
+			bucketStart[b + 1] += bucketStart[b];
+		}
+		// fill members in entry order so the first of any duplicates is kept
+		{
+			uint16 fill[buckets]{};
+			for(size_t i = 0; i < N; i++)
+			{
+				auto b = bucketIndex(hash[i]);
+				member[bucketStart[b] + fill[b]++] = i;
+			}
+		}
+		uint16 bucketSize[buckets]{};
+		uint16 maxBucketSize = 0;
+		for(size_t b = 0; b < buckets; b++)
+		{
+			for(size_t m = bucketStart[b]; m < bucketStart[b + 1]; m++)
+			{
+				for(size_t prev = bucketStart[b]; prev < m; prev++)
+				{
+					if(!duplicate[prev] && hash[member[prev]] == hash[member[m]]
+						&& KEY_TRAITS::equal(KEY_TRAITS::key(entries[member[prev]]), KEY_TRAITS::key(entries[member[m]])))
+					{
+						duplicate[m] = true;
+						break;
+					}
+				}
+				if(!duplicate[m])
+					bucketSize[b]++;
+			}
+			if(bucketSize[b] > maxBucketSize)
+				maxBucketSize = bucketSize[b];
+		}
+		for(auto &s : slot)
+		{
+			s = emptySlot;
+		}
+		// placing the largest buckets first, while most slots are free,
+		// keeps the seed search short
+		for(auto size = maxBucketSize; size; size--)
+		{
+			for(size_t b = 0; b < buckets; b++)
+			{
+				if(bucketSize[b] != size)
+					continue;
+				if(!placeBucket(b, hash, member + bucketStart[b], duplicate + bucketStart[b],
+					bucketStart[b + 1] - bucketStart[b]))
+				{
+					return;
+				}
+			}
+		}
+		valid = true;
+	}
+
+	constexpr bool isValid() const { return valid; }
+	constexpr size_t size() const { return N; }
+
+	const T *find(Key key) const
+	{
+		auto h = mix(KEY_TRAITS::hash(key));
+		auto idx = slot[slotIndex(h, seed[bucketIndex(h)])];
+		if(idx == emptySlot || !KEY_TRAITS::equal(KEY_TRAITS::key(entry[idx]), key))
+			return nullptr;
+		return &entry[idx];
+	}
+
+private:
+	static constexpr uint16 emptySlot = 0xFFFF;
+	T entry[N]{};
+	uint16 slot[slots]{};
+	uint16 seed[buckets]{};
+	bool valid = false;
+
+	static constexpr uint64_t mix(uint64_t x)
+	{
+		// MurmurHash3 64-bit finalizer
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return x;
+	}
+
+	static constexpr size_t bucketIndex(uint64_t hash)
+	{
+		return (hash >> 32) % buckets;
+	}
+
+	static constexpr size_t slotIndex(uint64_t hash, uint16 seed)
+	{
+		return mix(hash + seed * 0x9e3779b97f4a7c15ULL) & (slots - 1);
+	}
+
+	constexpr bool placeBucket(size_t b, const uint64_t *hash, const uint16 *member, const bool *duplicate, size_t members)
+	{
+		for(uint32 s = 0; s < emptySlot; s++)
+		{
+			size_t placed = 0;
+			for(; placed < members; placed++)
+			{
+				if(duplicate[placed])
+					continue;
+				auto idx = slotIndex(hash[member[placed]], s);
+				if(slot[idx] != emptySlot)
+					break;
+				slot[idx] = member[placed];
+			}
+			if(placed == members)
+			{
+				seed[b] = s;
+				return true;
+			}
+			// undo this seed's placements, including collisions within the bucket
+			while(placed--)
+			{
+				if(!duplicate[placed])
+					slot[slotIndex(hash[member[placed]], s)] = emptySlot;
+			}
+		}
+		return false;
+	}
+};
+
+template <class KEY_TRAITS, class T, size_t N>
+constexpr PerfectHashTable<T, N, KEY_TRAITS> makePerfectHashTable(const T (&entries)[N])
+{
+	return {entries};
+}
+
+}
@@ -16,6 +16,8 @@
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <cstddef>
+#include <cstring>
+#include <cassert>
 #include <atomic>
 #include <sys/mman.h>
 #include <unistd.h>
@@ -24,7 +26,7 @@
 #include <sys/syscall.h>
 #endif
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
+template <class SIZE = unsigned int>
 class StaticLinuxRingBuffer
 {
 public:
@@ -74,13 +76,13 @@ public:
 
 	void reset()
 	{
-		start = end = buff;
-		written = 0;
+		readIdx.store(0, std::memory_order_relaxed);
+		writeIdx.store(0, std::memory_order_relaxed);
 	}
 
 	SIZE freeSpace() const
 	{
-		return buffSize - written;
+		return buffSize - writtenSize();
 	}
 
 	SIZE freeContiguousSpace() const
@@ -90,53 +92,56 @@ public:
 
 	SIZE writtenSize() const
 	{
-		return written;
+		return usedSize(readIdx.load(std::memory_order_acquire), writeIdx.load(std::memory_order_acquire));
 	}
 
+	// the buffer's mirrored mapping means transfers never need to wrap
 	SIZE write(const void *buff, SIZE size)
 	{
-		if(size > freeSpace())
-			size = freeSpace();
-		memcpy(end, buff, size);
-		end = advanceAddr(end, size);
-		written += size;
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		auto freeSize = buffSize - usedSize(readIdx.load(std::memory_order_acquire), w);
+		if(size > freeSize)
+			size = freeSize;
+		memcpy(this->buff + bufferPos(w), buff, size);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 		//logMsg("wrote %d bytes", (int)size);
 		return size;
 	}
 
 	char *writeAddr() const
 	{
-		return end;
+		return buff + bufferPos(writeIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitWrite(SIZE size)
 	{
 		assert(size <= freeSpace());
-		end = advanceAddr(end, size);
-		written += size;
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 	}
 
 	SIZE read(void *buff, SIZE size)
 	{
-		if(size > (SIZE)written)
+		auto r = readIdx.load(std::memory_order_relaxed);
+		auto written = usedSize(r, writeIdx.load(std::memory_order_acquire));
+		if(size > written)
 			size = written;
-		memcpy(buff, start, size);
-		start = advanceAddr(start, size);
-		written -= size;
+		memcpy(buff, this->buff + bufferPos(r), size);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 		//logMsg("read %d bytes", (int)size);
 		return size;
 	}
 
 	char *readAddr() const
 	{
-		return start;
+		return buff + bufferPos(readIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitRead(SIZE size)
 	{
-		assert(size <= (SIZE)written);
-		start = advanceAddr(start, size);
-		written -= size;
+		assert(size <= writtenSize());
+		auto r = readIdx.load(std::memory_order_relaxed);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 	}
 
 	char *advanceAddr(char *ptr, SIZE size) const
@@ -146,8 +151,8 @@ public:
 
 private:
 	char *buff{};
-	char *start{}, *end{};
-	COUNT written{};
+	std::atomic<SIZE> readIdx{};
+	std::atomic<SIZE> writeIdx{};
 	SIZE buffSize{};
 	SIZE allocBuffSize{};
 
@@ -165,16 +170,35 @@ private:
 			ptr -= allocBuffSize;
 		return ptr;
 	}
+
+	// indices run over twice the mirror size so full & empty states differ
+	SIZE bufferPos(SIZE idx) const
+	{
+		return idx >= allocBuffSize ? idx - allocBuffSize : idx;
+	}
+
+	SIZE advanceIdx(SIZE idx, SIZE size) const
+	{
+		idx += size;
+		if(idx >= allocBuffSize*2)
+			idx -= allocBuffSize*2;
+		return idx;
+	}
+
+	SIZE usedSize(SIZE r, SIZE w) const
+	{
+		return w >= r ? w - r : w + allocBuffSize*2 - r;
+	}
 };
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
-class LinuxRingBuffer : public StaticLinuxRingBuffer<COUNT, SIZE>
+template <class SIZE = unsigned int>
+class LinuxRingBuffer : public StaticLinuxRingBuffer<SIZE>
 {
 public:
-	using StaticLinuxRingBuffer<COUNT, SIZE>::StaticLinuxRingBuffer;
+	using StaticLinuxRingBuffer<SIZE>::StaticLinuxRingBuffer;
 
 	~LinuxRingBuffer()
 	{
-		StaticLinuxRingBuffer<COUNT, SIZE>::deinit();
+		StaticLinuxRingBuffer<SIZE>::deinit();
 	}
 };
@@ -16,10 +16,12 @@
 	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
 
 #include <atomic>
+#include <cstring>
+#include <cassert>
 #include <mach/mach.h>
 #include <mach/vm_map.h>
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
+template <class SIZE = unsigned int>
 class StaticMachRingBuffer
 {
 public:
@@ -81,13 +83,13 @@ public:
 
 	void reset()
 	{
-		start = end = buff;
-		written = 0;
+		readIdx.store(0, std::memory_order_relaxed);
+		writeIdx.store(0, std::memory_order_relaxed);
 	}
 
 	SIZE freeSpace() const
 	{
-		return buffSize - written;
+		return buffSize - writtenSize();
 	}
 
 	SIZE freeContiguousSpace() const
@@ -97,53 +99,56 @@ public:
 
 	SIZE writtenSize() const
 	{
-		return written;
+		return usedSize(readIdx.load(std::memory_order_acquire), writeIdx.load(std::memory_order_acquire));
 	}
 
+	// the buffer's mirrored mapping means transfers never need to wrap
 	SIZE write(const void *buff, SIZE size)
 	{
-		if(size > freeSpace())
-			size = freeSpace();
-		memcpy(end, buff, size);
-		end = advanceAddr(end, size);
-		written += size;
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		auto freeSize = buffSize - usedSize(readIdx.load(std::memory_order_acquire), w);
+		if(size > freeSize)
+			size = freeSize;
+		memcpy(this->buff + bufferPos(w), buff, size);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 		//logMsg("wrote %d bytes", (int)size);
 		return size;
 	}
 
 	char *writeAddr() const
 	{
-		return end;
+		return buff + bufferPos(writeIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitWrite(SIZE size)
 	{
 		assert(size <= freeSpace());
-		end = advanceAddr(end, size);
-		written += size;
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 	}
 
 	SIZE read(void *buff, SIZE size)
 	{
-		if(size > (SIZE)written)
+		auto r = readIdx.load(std::memory_order_relaxed);
+		auto written = usedSize(r, writeIdx.load(std::memory_order_acquire));
+		if(size > written)
 			size = written;
-		memcpy(buff, start, size);
-		start = advanceAddr(start, size);
-		written -= size;
+		memcpy(buff, this->buff + bufferPos(r), size);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 		//logMsg("read %d bytes", (int)size);
 		return size;
 	}
 
 	char *readAddr() const
 	{
-		return start;
+		return buff + bufferPos(readIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitRead(SIZE size)
 	{
-		assert(size <= (SIZE)written);
-		start = wrapPtr(start + size);
-		written -= size;
+		assert(size <= writtenSize());
+		auto r = readIdx.load(std::memory_order_relaxed);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 	}
 
 	char *advanceAddr(char *ptr, SIZE size) const
@@ -153,8 +158,8 @@ public:
 
 private:
 	char *buff{};
-	char *start{}, *end{};
-	COUNT written{};
+	std::atomic<SIZE> readIdx{};
+	std::atomic<SIZE> writeIdx{};
 	SIZE buffSize{};
 	SIZE allocBuffSize{};
 
@@ -164,16 +169,35 @@ private:
 			ptr -= allocBuffSize;
 		return ptr;
 	}
+
+	// indices run over twice the mirror size so full & empty states differ
+	SIZE bufferPos(SIZE idx) const
+	{
+		return idx >= allocBuffSize ? idx - allocBuffSize : idx;
+	}
+
+	SIZE advanceIdx(SIZE idx, SIZE size) const
+	{
+		idx += size;
+		if(idx >= allocBuffSize*2)
+			idx -= allocBuffSize*2;
+		return idx;
+	}
+
+	SIZE usedSize(SIZE r, SIZE w) const
+	{
+		return w >= r ? w - r : w + allocBuffSize*2 - r;
+	}
 };
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
-class MachRingBuffer : public StaticMachRingBuffer<COUNT, SIZE>
+template <class SIZE = unsigned int>
+class MachRingBuffer : public StaticMachRingBuffer<SIZE>
 {
 public:
-	using StaticMachRingBuffer<COUNT, SIZE>::StaticMachRingBuffer;
+	using StaticMachRingBuffer<SIZE>::StaticMachRingBuffer;
 
 	~MachRingBuffer()
 	{
-		StaticMachRingBuffer<COUNT, SIZE>::deinit();
+		StaticMachRingBuffer<SIZE>::deinit();
 	}
 };
@@ -18,8 +18,15 @@
 #include <imagine/util/algorithm.h>
 #include <atomic>
 #include <cstdlib>
+#include <cstring>
+#include <cassert>
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
+// Single-producer/single-consumer byte ring buffer. The read & write
+// indices run over twice the buffer size so a full buffer can be told
+// apart from an empty one, the writer publishes with release ordering and
+// the reader consumes with acquire ordering (and vice-versa for freeing space).
+
+template <class SIZE = unsigned int>
 class StaticRingBuffer
 {
 public:
@@ -49,87 +56,79 @@ public:
 
 	void reset()
 	{
-		start = end = buff;
-		written = 0;
+		readIdx.store(0, std::memory_order_relaxed);
+		writeIdx.store(0, std::memory_order_relaxed);
 	}
 
 	SIZE freeSpace() const
 	{
-		return buffSize - written;
+		return buffSize - writtenSize();
 	}
 
 	SIZE freeContiguousSpace() const
 	{
-		return ((uintptr_t)buff + buffSize) - (uintptr_t)end;
+		return std::min(freeSpace(), buffSize - bufferPos(writeIdx.load(std::memory_order_relaxed)));
 	}
 
 	SIZE writtenSize() const
 	{
-		return written;
+		return usedSize(readIdx.load(std::memory_order_acquire), writeIdx.load(std::memory_order_acquire));
 	}
 
 	SIZE write(const void *buff, SIZE size)
 	{
-		if(size > freeSpace())
-			size = freeSpace();
-
-		char *writePos = end;
-		iterateTimes(size, i)
-		{
-			//logMsg("addr %p", writePos);
-			*writePos = ((char*)buff)[i];
-			writePos = advanceAddr(writePos, 1);
-		}
-		end = writePos;
-		written += size;
-
-		assert((SIZE)written <= buffSize);
-
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		auto freeSize = buffSize - usedSize(readIdx.load(std::memory_order_acquire), w);
+		if(size > freeSize)
+			size = freeSize;
+		auto pos = bufferPos(w);
+		auto firstSize = std::min(size, buffSize - pos);
+		memcpy(this->buff + pos, buff, firstSize);
+		if(size > firstSize)
+			memcpy(this->buff, (const char*)buff + firstSize, size - firstSize);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 		//logMsg("wrote %d bytes", (int)size);
 		return size;
 	}
 
 	char *writeAddr() const
 	{
-		return end;
+		return buff + bufferPos(writeIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitWrite(SIZE size)
 	{
 		assert(size <= freeSpace());
-		end = advanceAddr(end, size);
-		written += size;
+		auto w = writeIdx.load(std::memory_order_relaxed);
+		writeIdx.store(advanceIdx(w, size), std::memory_order_release);
 	}
 
 	SIZE read(void *buff, SIZE size)
 	{
-		if(size > (SIZE)written)
+		auto r = readIdx.load(std::memory_order_relaxed);
+		auto written = usedSize(r, writeIdx.load(std::memory_order_acquire));
+		if(size > written)
 			size = written;
-
-		char *readPos = start;
-		iterateTimes(size, i)
-		{
-			//logMsg("addr %p", readPos);
-			((char*)buff)[i] = *readPos;
-			readPos = advanceAddr(readPos, 1);
-		}
-		start = readPos;
-		written -= size;
-
+		auto pos = bufferPos(r);
+		auto firstSize = std::min(size, buffSize - pos);
+		memcpy(buff, this->buff + pos, firstSize);
+		if(size > firstSize)
+			memcpy((char*)buff + firstSize, this->buff, size - firstSize);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 		//logMsg("read %d bytes", (int)size);
 		return size;
 	}
 
 	char *readAddr() const
 	{
-		return start;
+		return buff + bufferPos(readIdx.load(std::memory_order_relaxed));
 	}
 
 	void commitRead(SIZE size)
 	{
-		assert(size <= (SIZE)written);
-		start = advanceAddr(start, size);
-		written -= size;
+		assert(size <= writtenSize());
+		auto r = readIdx.load(std::memory_order_relaxed);
+		readIdx.store(advanceIdx(r, size), std::memory_order_release);
 	}
 
 	// given an address inside the ring buffer, return the address
@@ -145,19 +144,37 @@ public:
 
 private:
 	char *buff{};
-	char *start{}, *end{};
-	COUNT written{};
+	std::atomic<SIZE> readIdx{};
+	std::atomic<SIZE> writeIdx{};
 	SIZE buffSize{};
+
+	SIZE bufferPos(SIZE idx) const
+	{
+		return idx >= buffSize ? idx - buffSize : idx;
+	}
+
+	SIZE advanceIdx(SIZE idx, SIZE size) const
+	{
+		idx += size;
+		if(idx >= buffSize*2)
+			idx -= buffSize*2;
+		return idx;
+	}
+
+	SIZE usedSize(SIZE r, SIZE w) const
+	{
+		return w >= r ? w - r : w + buffSize*2 - r;
+	}
 };
 
-template <class COUNT = std::atomic_uint, class SIZE = unsigned int>
-class RingBuffer : public StaticRingBuffer<COUNT, SIZE>
+template <class SIZE = unsigned int>
+class RingBuffer : public StaticRingBuffer<SIZE>
 {
 public:
-	using StaticRingBuffer<COUNT, SIZE>::StaticRingBuffer;
+	using StaticRingBuffer<SIZE>::StaticRingBuffer;
 
 	~RingBuffer()
 	{
-		StaticRingBuffer<COUNT, SIZE>::deinit();
+		StaticRingBuffer<SIZE>::deinit();
 	}
 };
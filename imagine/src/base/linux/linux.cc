@@ -148,6 +148,8 @@ void exitWithErrorMessageVPrintf(int exitVal, const char *format, va_list args)
 	exit(exitVal);
 }
 
+[[gnu::weak]] bool onHeadlessInit(int argc, char** argv, int &exitCode) { return false; }
+
 }
 
 int main(int argc, char** argv)
@@ -156,6 +158,12 @@ int main(int argc, char** argv)
 	logger_init();
 	engineInit();
 	appPath = FS::makeAppPathFromLaunchCommand(argv[0]);
+	if(int exitCode = 0;
+		onHeadlessInit(argc, argv, exitCode))
+	{
+		dispatchOnExit(false);
+		return exitCode;
+	}
 	auto eventLoop = EventLoop::makeForThread();
 	#ifdef CONFIG_BASE_X11
 	FDEventSource x11Src;
@@ -18,6 +18,7 @@
 #include <imagine/gfx/Texture.hh>
 #include <imagine/util/ScopeGuard.hh>
 #include <imagine/util/utility.h>
+#include <imagine/time/Profiler.hh>
 #include <imagine/mem/mem.h>
 #include "private.hh"
 #ifdef __ANDROID__
@@ -742,6 +743,7 @@ void Texture::bind()
 
 void Texture::write(uint level, const IG::Pixmap &pixmap, IG::WP destPos, uint assumeAlign)
 {
+	IG_PROFILE_SCOPE("Texture::write");
 	//logDMsg("writing pixmap %dx%d to pos %dx%d", pixmap.x, pixmap.y, destPos.x, destPos.y);
 	if(unlikely(!texName_))
 	{
@@ -913,6 +915,7 @@ LockedTextureBuffer Texture::lock(uint level, IG::WindowRect rect)
 
 void Texture::unlock(LockedTextureBuffer lockBuff)
 {
+	IG_PROFILE_SCOPE("Texture::unlock");
 	assumeExpr(r);
 	if(directTex)
 		directTex->unlock(*r, texName_);
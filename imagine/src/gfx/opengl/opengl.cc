@@ -21,6 +21,7 @@
 #include <imagine/base/Window.hh>
 #include <imagine/base/GLContext.hh>
 #include <imagine/util/Interpolator.hh>
+#include <imagine/time/Profiler.hh>
 #include "private.hh"
 #include "utils.h"
 
@@ -500,6 +501,7 @@ void Renderer::deinitDrawable(Drawable &drawable)
 
 void Renderer::presentDrawable(Drawable win)
 {
+	IG_PROFILE_SCOPE("Renderer::presentDrawable");
 	verifyCurrentContext();
 	discardTemporaryData();
 	gfxContext.present(glDpy, win, gfxContext);
@@ -18,17 +18,62 @@
 #include <imagine/gui/FSPicker.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/util/math/int.hh>
-#include <string>
+#include <imagine/thread/Thread.hh>
+#include <imagine/time/Time.hh>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <cstring>
+#include <strings.h>
+
+// state shared with the thread reading a directory, the thread only touches
+// the picker's pipe while holding the mutex & the scan isn't canceled
+struct FSPicker::DirScan
+{
+	std::mutex mutex{};
+	// sorted entries waiting to be added to the picker
+	std::vector<FileEntry> entries{};
+	std::atomic_bool canceled{};
+	bool done = false;
+	bool notified = false;
+};
+
+// the first entries are shown as soon as possible, after that
+// new ones are sent at most this often to limit re-sorting & layout
+static constexpr uint firstBatchEntries = 64;
+static constexpr uint batchIntervalMSecs = 100;
+
+static bool fileEntryLess(const std::string &name1, const std::string &name2)
+{
+	return strcasecmp(name1.c_str(), name2.c_str()) < 0;
+}
 
 FSPicker::FSPicker(ViewAttachParams attach, Gfx::PixmapTexture *backRes, Gfx::PixmapTexture *closeRes,
 	FilterFunc filter,  bool singleDir, Gfx::GlyphTextureSet *face):
 	View{attach},
 	filter{filter},
-	tbl{attach, text},
+	tbl
+	{
+		attach,
+		[this](const TableView &) { return (int)dir.size(); },
+		[this](const TableView &, uint idx) -> MenuItem& { return dir[idx]->text; }
+	},
 	faceRes{face},
 	navV{attach.renderer, face, singleDir ? nullptr : backRes, closeRes},
 	singleDir{singleDir}
 {
+	tbl.setCompileVisibleItemsOnly(true);
+	scanPipe.init({},
+		[this](Base::Pipe &pipe)
+		{
+			while(pipe.hasData())
+			{
+				uint8 msg;
+				pipe.read(&msg, sizeof(msg));
+			}
+			addScannedEntries();
+			return 1;
+		});
 	msgText = {msgStr.data(), face};
 	const Gfx::LGradientStopDesc fsNavViewGrad[]
 	{
@@ -60,6 +105,12 @@ FSPicker::FSPicker(ViewAttachParams attach, Gfx::PixmapTexture *backRes, Gfx::Pi
 		});
 }
 
+FSPicker::~FSPicker()
+{
+	cancelDirScan();
+	scanPipe.deinit();
+}
+
 void FSPicker::place()
 {
 	navV.viewRect().setPosRel({viewFrame.x, viewFrame.y}, {viewFrame.xSize(), int(faceRes->nominalHeight() * 1.75)}, LT2DO);
@@ -170,74 +221,182 @@ std::error_code FSPicker::setPath(const char *path, bool forcePathChange, Input:
 	assert(path);
 	auto prevPath = currPath;
 	std::error_code ec{};
+	auto dirIt = FS::directory_iterator{path, ec};
+	if(ec)
 	{
-		auto dirIt = FS::directory_iterator{path, ec};
-		if(ec)
-		{
-			logErr("can't open %s", path);
-			if(!forcePathChange)
-			{
-				onPathReadError_.callSafe(*this, ec);
-				return ec;
-			}
-		}
-		string_copy(currPath, path);
-		dir.clear();
-		for(auto &entry : dirIt)
+		logErr("can't open %s", path);
+		if(!forcePathChange)
 		{
-			if(filter && !filter(entry))
-			{
-				continue;
-			}
-			dir.emplace_back(FS::makeFileString(entry.name()));
+			onPathReadError_.callSafe(*this, ec);
+			return ec;
 		}
 	}
-	std::sort(dir.begin(), dir.end(), FS::fileStringNoCaseLexCompare());
-	text.clear();
-	if(dir.size())
+	cancelDirScan();
+	string_copy(currPath, path);
+	dir.clear();
+	if(ec)
+	{
+		string_printf(msgStr, "Can't open directory:\n%s", ec.message().c_str());
+	}
+	else
 	{
 		msgStr = {};
-		text.reserve(dir.size());
-		iterateTimes(dir.size(), i)
+		startDirScan(dirIt);
+	}
+	highlightFirstEntry = !e.isPointer();
+	tbl.resetScroll();
+	navV.setTitle(currPath.data());
+	onChangePath_.callSafe(*this, prevPath, e);
+	return {};
+}
+
+void FSPicker::startDirScan(FS::directory_iterator dirIt)
+{
+	dirScan = std::make_shared<DirScan>();
+	IG::makeDetachedThread(
+		[dirIt, filter = filter, scan = dirScan, &pipe = scanPipe]() mutable
 		{
-			auto filePath = makePathString(dir[i].data());
-			bool isDir = FS::status(filePath.data()).type() == FS::file_type::directory;
-			if(isDir)
-			{
-				text.emplace_back(dir[i].data(),
-					[this, i](TextMenuItem &, View &, Input::Event e)
+			std::vector<FileEntry> batch{};
+			bool sentFirstBatch = false;
+			auto lastSendTime = IG::Time::now();
+			auto sendBatch =
+				[&](bool done)
+				{
+					std::sort(batch.begin(), batch.end(),
+						[](const FileEntry &e1, const FileEntry &e2){ return fileEntryLess(e1.name, e2.name); });
+					std::lock_guard<std::mutex> lock{scan->mutex};
+					if(scan->canceled)
+						return false;
+					auto &entries = scan->entries;
+					auto mid = entries.size();
+					entries.insert(entries.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+					std::inplace_merge(entries.begin(), entries.begin() + mid, entries.end(),
+						[](const FileEntry &e1, const FileEntry &e2){ return fileEntryLess(e1.name, e2.name); });
+					batch.clear();
+					scan->done = done;
+					if(!scan->notified)
 					{
-						assert(!singleDir);
-						auto filePath = makePathString(dir[i].data());
-						logMsg("going to dir %s", filePath.data());
-						changeDirByInput(filePath.data(), false, e);
-					});
-			}
-			else
+						scan->notified = true;
+						uint8 msg = 0;
+						pipe.write(&msg, sizeof(msg));
+					}
+					sentFirstBatch = true;
+					lastSendTime = IG::Time::now();
+					return true;
+				};
+			for(auto &entry : dirIt)
 			{
-				text.emplace_back(dir[i].data(),
-					[this, i](TextMenuItem &, View &, Input::Event e)
-					{
-						onSelectFile_.callCopy(*this, dir[i].data(), e);
-					});
+				if(scan->canceled)
+					return;
+				if(filter && !filter(entry))
+				{
+					continue;
+				}
+				// the entry's type comes from readdir() when the file system
+				// provides it so no stat() is needed for most entries
+				batch.push_back({entry.name(), entry.type() == FS::file_type::directory});
+				bool sendNow = sentFirstBatch ?
+					(IG::Time::now() - lastSendTime).mSecs() >= batchIntervalMSecs :
+					batch.size() >= firstBatchEntries;
+				if(sendNow && !sendBatch(false))
+					return;
 			}
+			sendBatch(true);
+		});
+}
+
+void FSPicker::cancelDirScan()
+{
+	if(!dirScan)
+		return;
+	{
+		std::lock_guard<std::mutex> lock{dirScan->mutex};
+		dirScan->canceled = true;
+	}
+	dirScan.reset();
+}
+
+void FSPicker::addScannedEntries()
+{
+	if(!dirScan)
+		return;
+	std::vector<FileEntry> entries{};
+	bool done;
+	{
+		std::lock_guard<std::mutex> lock{dirScan->mutex};
+		entries.swap(dirScan->entries);
+		done = dirScan->done;
+		dirScan->notified = false;
+	}
+	if(entries.size())
+	{
+		// count the new entries sorting before the rows the user sees so
+		// they stay in place, the merge keeps existing entries first on ties
+		auto insertedBefore =
+			[&](int idx) -> uint
+			{
+				if(idx < 0)
+					return 0;
+				return std::lower_bound(entries.begin(), entries.end(), dir[idx]->entry.name,
+					[](const FileEntry &e, const std::string &name){ return fileEntryLess(e.name, name); }) - entries.begin();
+			};
+		auto beforeAnchor = insertedBefore(tbl.anchorCell());
+		auto beforeHighlighted = insertedBefore(tbl.highlightedCell());
+		auto mid = dir.size();
+		dir.reserve(mid + entries.size());
+		for(auto &e : entries)
+		{
+			dir.emplace_back(makeFileItem(std::move(e)));
+		}
+		std::inplace_merge(dir.begin(), dir.begin() + mid, dir.end(),
+			[](const std::unique_ptr<FileItem> &i1, const std::unique_ptr<FileItem> &i2)
+			{
+				return fileEntryLess(i1->entry.name, i2->entry.name);
+			});
+		logMsg("added %zu entries, %zu total", entries.size(), dir.size());
+		tbl.cellsInserted(beforeAnchor, beforeHighlighted);
+		if(highlightFirstEntry)
+		{
+			tbl.highlightCell(0);
+			highlightFirstEntry = false;
 		}
 	}
-	else
+	if(done)
 	{
-		// no entires, show a message instead
-		if(ec)
-			string_printf(msgStr, "Can't open directory:\n%s", ec.message().c_str());
-		else
+		logMsg("finished reading %s", currPath.data());
+		dirScan.reset();
+		if(dir.empty())
 			string_copy(msgStr, "Empty Directory");
 	}
-	if(!e.isPointer())
-		tbl.highlightCell(0);
+	place();
+	postDraw();
+}
+
+std::unique_ptr<FSPicker::FileItem> FSPicker::makeFileItem(FileEntry entry)
+{
+	auto item = std::make_unique<FileItem>();
+	item->entry = std::move(entry);
+	auto &e = item->entry;
+	if(e.isDir)
+	{
+		item->text = {e.name.c_str(),
+			[this, &e](TextMenuItem &, View &, Input::Event ev)
+			{
+				assert(!singleDir);
+				auto filePath = makePathString(e.name.c_str());
+				logMsg("going to dir %s", filePath.data());
+				changeDirByInput(filePath.data(), false, ev);
+			}};
+	}
 	else
-		tbl.resetScroll();
-	navV.setTitle(currPath.data());
-	onChangePath_.callSafe(*this, prevPath, e);
-	return {};
+	{
+		item->text = {e.name.c_str(),
+			[this, &e](TextMenuItem &, View &, Input::Event ev)
+			{
+				onSelectFile_.callCopy(*this, e.name.c_str(), ev);
+			}};
+	}
+	return item;
 }
 
 std::error_code FSPicker::setPath(const char *path, bool forcePathChange)
@@ -46,11 +46,44 @@ void TableView::highlightCell(int idx)
 	postDraw();
 }
 
+int TableView::anchorCell() const
+{
+	auto cells_ = items(*this);
+	if(!cells_ || !yCellSize)
+		return -1;
+	int topCell = std::min(scrollOffset() / yCellSize, cells_ - 1);
+	if(selected >= topCell && selected < topCell + visibleCells)
+		return selected;
+	return topCell;
+}
+
+void TableView::cellsInserted(uint beforeAnchor, uint beforeHighlighted)
+{
+	if(selected >= 0)
+		selected += beforeHighlighted;
+	if(!yCellSize)
+		return;
+	setYCellSize(yCellSize);
+	if(!beforeAnchor)
+		return;
+	// shift without stopping a scroll animation or drag in progress
+	int shift = beforeAnchor * yCellSize;
+	offset = IG::clamp(offset + shift, 0, offsetMax);
+	offsetAsDec += shift;
+	onDragOffset += shift;
+}
+
 void TableView::setAlign(_2DOrigin align)
 {
 	this->align = align;
 }
 
+void TableView::setCompileVisibleItemsOnly(bool on)
+{
+	compileVisibleItemsOnly = on;
+	isCompiled.clear();
+}
+
 void TableView::draw()
 {
 	auto cells_ = items(*this);
@@ -68,6 +101,13 @@ void TableView::draw()
 		y += -startYCell * yCellSize;
 		startYCell = 0;
 	}
+	if(compileVisibleItemsOnly)
+	{
+		for(int i = startYCell; i < endYCell; i++)
+		{
+			compileItem(i);
+		}
+	}
 	//logMsg("draw cells [%d,%d)", startYCell, endYCell);
 	y -= scrollOffset() % yCellSize;
 
@@ -138,10 +178,21 @@ void TableView::draw()
 void TableView::place()
 {
 	auto cells_ = items(*this);
-	iterateTimes(cells_, i)
+	if(compileVisibleItemsOnly)
 	{
-		//logMsg("compile item %d", i);
-		item(*this, i).compile(renderer(), projP);
+		// items are compiled on demand in draw(), the first one
+		// is needed now to get the cell size
+		isCompiled.assign(cells_, false);
+		if(cells_)
+			compileItem(0);
+	}
+	else
+	{
+		iterateTimes(cells_, i)
+		{
+			//logMsg("compile item %d", i);
+			item(*this, i).compile(renderer(), projP);
+		}
 	}
 	if(cells_)
 	{
@@ -221,6 +272,16 @@ void TableView::setYCellSize(int s)
 	ScrollView::setContentSize({viewRect().xSize(), items(*this) * s});
 }
 
+void TableView::compileItem(uint idx)
+{
+	if(idx >= isCompiled.size())
+		isCompiled.resize(idx + 1);
+	if(isCompiled[idx])
+		return;
+	item(*this, idx).compile(renderer(), projP);
+	isCompiled[idx] = true;
+}
+
 IG::WindowRect TableView::focusRect()
 {
 	if(selected >= 0)
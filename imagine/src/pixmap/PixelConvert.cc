@@ -0,0 +1,412 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "PixelConvert"
+#include <imagine/pixmap/PixelConvert.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/utility.h>
+#include <imagine/util/algorithm.h>
+#include <cstring>
+#include <utility>
+#if defined __x86_64__ || defined __i386__
+#define CONFIG_PIXEL_CONVERT_X86
+#include <immintrin.h>
+#endif
+#if defined __ARM_NEON || defined __ARM_NEON__
+#define CONFIG_PIXEL_CONVERT_NEON
+#include <arm_neon.h>
+#endif
+
+namespace IG
+{
+
+template <class DEST_T, class SRC_T>
+static void paletteLookupScalar(DEST_T *dest, const SRC_T *src, const DEST_T *palette, size_t pixels)
+{
+	// unrolled so the compiler can interleave the dependent loads
+	size_t i = 0;
+	for(; i + 4 <= pixels; i += 4)
+	{
+		auto p0 = palette[src[i]], p1 = palette[src[i + 1]],
+			p2 = palette[src[i + 2]], p3 = palette[src[i + 3]];
+		dest[i] = p0; dest[i + 1] = p1; dest[i + 2] = p2; dest[i + 3] = p3;
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = palette[src[i]];
+	}
+}
+
+static uint32 rgb565ToRGBA8888(uint16 p, bool bgr)
+{
+	uint r = p >> 11, g = (p >> 5) & 0x3F, b = p & 0x1F;
+	r = (r << 3) | (r >> 2);
+	g = (g << 2) | (g >> 4);
+	b = (b << 3) | (b >> 2);
+	if(bgr)
+		std::swap(r, b);
+	return r | (g << 8) | (b << 16) | 0xFF000000;
+}
+
+static uint16 rgba8888ToRGB565(uint32 p, bool bgr)
+{
+	uint r = p & 0xFF, g = (p >> 8) & 0xFF, b = (p >> 16) & 0xFF;
+	if(bgr)
+		std::swap(r, b);
+	return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+}
+
+static uint32 swapRB(uint32 p)
+{
+	return (p & 0xFF00FF00) | ((p & 0xFF) << 16) | ((p >> 16) & 0xFF);
+}
+
+#ifdef CONFIG_PIXEL_CONVERT_X86
+
+static bool hasAVX2()
+{
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	return hasAVX2;
+}
+
+// 16-bit palettes are read as pairs of entries with 32-bit gathers
+// from an even index, selecting the wanted half afterwards, so reads
+// never go past the end of the palette
+
+[[gnu::target("avx2")]]
+static __m256i gatherPalette16(__m256i idx, const uint16 *palette)
+{
+	auto pairs = _mm256_i32gather_epi32((const int*)palette, _mm256_srli_epi32(idx, 1), 4);
+	auto shift = _mm256_slli_epi32(_mm256_and_si256(idx, _mm256_set1_epi32(1)), 4);
+	return _mm256_and_si256(_mm256_srlv_epi32(pairs, shift), _mm256_set1_epi32(0xFFFF));
+}
+
+[[gnu::target("avx2")]]
+static void storePacked16(uint16 *dest, __m256i lo, __m256i hi)
+{
+	// packus works within 128-bit lanes, restore the element order afterwards
+	auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+	_mm256_storeu_si256((__m256i*)dest, packed);
+}
+
+[[gnu::target("avx2")]]
+static void paletteLookupAVX2(uint16 *dest, const uint8 *src, const uint16 *palette, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto idx = _mm_loadu_si128((const __m128i*)(src + i));
+		auto lo = gatherPalette16(_mm256_cvtepu8_epi32(idx), palette);
+		auto hi = gatherPalette16(_mm256_cvtepu8_epi32(_mm_srli_si128(idx, 8)), palette);
+		storePacked16(dest + i, lo, hi);
+	}
+	paletteLookupScalar(dest + i, src + i, palette, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static void paletteLookupAVX2(uint16 *dest, const uint16 *src, const uint16 *palette, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto lo = gatherPalette16(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i))), palette);
+		auto hi = gatherPalette16(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i + 8))), palette);
+		storePacked16(dest + i, lo, hi);
+	}
+	paletteLookupScalar(dest + i, src + i, palette, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static void paletteLookupAVX2(uint32 *dest, const uint8 *src, const uint32 *palette, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+	}
+	paletteLookupScalar(dest + i, src + i, palette, pixels - i);
+}
+
+[[gnu::target("avx2")]]
+static void paletteLookupAVX2(uint32 *dest, const uint16 *src, const uint32 *palette, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto idx = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+		_mm256_storeu_si256((__m256i*)(dest + i), _mm256_i32gather_epi32((const int*)palette, idx, 4));
+	}
+	paletteLookupScalar(dest + i, src + i, palette, pixels - i);
+}
+
+#endif
+
+#ifdef __SSE2__
+
+static void rgb565ToRGBA8888SSE2(uint32 *dest, const uint16 *src, size_t pixels, bool bgr)
+{
+	const auto mask6 = _mm_set1_epi16(0x3F), mask5 = _mm_set1_epi16(0x1F), alpha = _mm_set1_epi16((short)0xFF00);
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)(src + i));
+		auto r = _mm_srli_epi16(p, 11);
+		auto g = _mm_and_si128(_mm_srli_epi16(p, 5), mask6);
+		auto b = _mm_and_si128(p, mask5);
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+		if(bgr)
+			std::swap(r, b);
+		// low 16 bits hold the 1st & 2nd bytes, high 16 bits the 3rd & alpha
+		auto lo = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+		auto hi = _mm_or_si128(b, alpha);
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i*)(dest + i + 4), _mm_unpackhi_epi16(lo, hi));
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = rgb565ToRGBA8888(src[i], bgr);
+	}
+}
+
+static __m128i rgba8888ToRGB565x4SSE2(__m128i p, bool bgr)
+{
+	auto firstByte = _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 3);
+	auto g = _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x7E0));
+	auto thirdByte = _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1F));
+	auto r = bgr ? thirdByte : firstByte;
+	auto b = bgr ? firstByte : thirdByte;
+	auto val = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 11), g), b);
+	// sign extend the low 16 bits so the saturating pack keeps them intact
+	return _mm_srai_epi32(_mm_slli_epi32(val, 16), 16);
+}
+
+static void rgba8888ToRGB565SSE2(uint16 *dest, const uint32 *src, size_t pixels, bool bgr)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto lo = rgba8888ToRGB565x4SSE2(_mm_loadu_si128((const __m128i*)(src + i)), bgr);
+		auto hi = rgba8888ToRGB565x4SSE2(_mm_loadu_si128((const __m128i*)(src + i + 4)), bgr);
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_packs_epi32(lo, hi));
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = rgba8888ToRGB565(src[i], bgr);
+	}
+}
+
+static void swapRBSSE2(uint32 *dest, const uint32 *src, size_t pixels)
+{
+	// R & B are the low bytes of each pixel's 16-bit halves, so swapping
+	// the halves with shuffles moves them while G & A are masked off
+	const auto gaMask = _mm_set1_epi32(0xFF00FF00);
+	size_t i = 0;
+	for(; i + 4 <= pixels; i += 4)
+	{
+		auto p = _mm_loadu_si128((const __m128i*)(src + i));
+		auto rb = _mm_andnot_si128(gaMask, p);
+		rb = _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i*)(dest + i), _mm_or_si128(_mm_and_si128(p, gaMask), rb));
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = swapRB(src[i]);
+	}
+}
+
+#endif
+
+#ifdef CONFIG_PIXEL_CONVERT_NEON
+
+static void rgb565ToRGBA8888NEON(uint32 *dest, const uint16 *src, size_t pixels, bool bgr)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = vld1q_u16(src + i);
+		auto r = vand_u8(vshrn_n_u16(p, 8), vdup_n_u8(0xF8));
+		auto g = vand_u8(vshrn_n_u16(p, 3), vdup_n_u8(0xFC));
+		auto b = vmovn_u16(vshlq_n_u16(p, 3));
+		uint8x8x4_t out;
+		out.val[bgr ? 2 : 0] = vorr_u8(r, vshr_n_u8(r, 5));
+		out.val[1] = vorr_u8(g, vshr_n_u8(g, 6));
+		out.val[bgr ? 0 : 2] = vorr_u8(b, vshr_n_u8(b, 5));
+		out.val[3] = vdup_n_u8(0xFF);
+		vst4_u8((uint8*)(dest + i), out);
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = rgb565ToRGBA8888(src[i], bgr);
+	}
+}
+
+static void rgba8888ToRGB565NEON(uint16 *dest, const uint32 *src, size_t pixels, bool bgr)
+{
+	size_t i = 0;
+	for(; i + 8 <= pixels; i += 8)
+	{
+		auto p = vld4_u8((const uint8*)(src + i));
+		auto val = vshll_n_u8(p.val[bgr ? 2 : 0], 8);
+		val = vsriq_n_u16(val, vshll_n_u8(p.val[1], 8), 5);
+		val = vsriq_n_u16(val, vshll_n_u8(p.val[bgr ? 0 : 2], 8), 11);
+		vst1q_u16(dest + i, val);
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = rgba8888ToRGB565(src[i], bgr);
+	}
+}
+
+static void swapRBNEON(uint32 *dest, const uint32 *src, size_t pixels)
+{
+	size_t i = 0;
+	for(; i + 16 <= pixels; i += 16)
+	{
+		auto p = vld4q_u8((const uint8*)(src + i));
+		std::swap(p.val[0], p.val[2]);
+		vst4q_u8((uint8*)(dest + i), p);
+	}
+	for(; i < pixels; i++)
+	{
+		dest[i] = swapRB(src[i]);
+	}
+}
+
+#endif
+
+static void rgb565ToRGBA8888(uint32 *dest, const uint16 *src, size_t pixels, bool bgr)
+{
+	#if defined __SSE2__
+	rgb565ToRGBA8888SSE2(dest, src, pixels, bgr);
+	#elif defined CONFIG_PIXEL_CONVERT_NEON
+	rgb565ToRGBA8888NEON(dest, src, pixels, bgr);
+	#else
+	iterateTimes(pixels, i)
+	{
+		dest[i] = rgb565ToRGBA8888(src[i], bgr);
+	}
+	#endif
+}
+
+static void rgba8888ToRGB565(uint16 *dest, const uint32 *src, size_t pixels, bool bgr)
+{
+	#if defined __SSE2__
+	rgba8888ToRGB565SSE2(dest, src, pixels, bgr);
+	#elif defined CONFIG_PIXEL_CONVERT_NEON
+	rgba8888ToRGB565NEON(dest, src, pixels, bgr);
+	#else
+	iterateTimes(pixels, i)
+	{
+		dest[i] = rgba8888ToRGB565(src[i], bgr);
+	}
+	#endif
+}
+
+static void swapRB(uint32 *dest, const uint32 *src, size_t pixels)
+{
+	#if defined __SSE2__
+	swapRBSSE2(dest, src, pixels);
+	#elif defined CONFIG_PIXEL_CONVERT_NEON
+	swapRBNEON(dest, src, pixels);
+	#else
+	iterateTimes(pixels, i)
+	{
+		dest[i] = swapRB(src[i]);
+	}
+	#endif
+}
+
+void paletteLookup(uint16 *dest, const uint8 *src, const uint16 *palette, size_t pixels)
+{
+	#ifdef CONFIG_PIXEL_CONVERT_X86
+	if(hasAVX2())
+		return paletteLookupAVX2(dest, src, palette, pixels);
+	#endif
+	paletteLookupScalar(dest, src, palette, pixels);
+}
+
+void paletteLookup(uint32 *dest, const uint8 *src, const uint32 *palette, size_t pixels)
+{
+	#ifdef CONFIG_PIXEL_CONVERT_X86
+	if(hasAVX2())
+		return paletteLookupAVX2(dest, src, palette, pixels);
+	#endif
+	paletteLookupScalar(dest, src, palette, pixels);
+}
+
+void paletteLookup(uint16 *dest, const uint16 *src, const uint16 *palette, size_t pixels)
+{
+	#ifdef CONFIG_PIXEL_CONVERT_X86
+	if(hasAVX2())
+		return paletteLookupAVX2(dest, src, palette, pixels);
+	#endif
+	paletteLookupScalar(dest, src, palette, pixels);
+}
+
+void paletteLookup(uint32 *dest, const uint16 *src, const uint32 *palette, size_t pixels)
+{
+	#ifdef CONFIG_PIXEL_CONVERT_X86
+	if(hasAVX2())
+		return paletteLookupAVX2(dest, src, palette, pixels);
+	#endif
+	paletteLookupScalar(dest, src, palette, pixels);
+}
+
+static bool isRGBA8888Variant(PixelFormatID format)
+{
+	return format == PIXEL_RGBA8888 || format == PIXEL_BGRA8888;
+}
+
+bool canConvertPixels(PixelFormatID destFormat, PixelFormatID srcFormat)
+{
+	return destFormat == srcFormat
+		|| (destFormat == PIXEL_RGB565 && isRGBA8888Variant(srcFormat))
+		|| (isRGBA8888Variant(destFormat) && (srcFormat == PIXEL_RGB565 || isRGBA8888Variant(srcFormat)));
+}
+
+bool convertPixels(PixelFormatID destFormat, void *dest, PixelFormatID srcFormat, const void *src, size_t pixels)
+{
+	if(destFormat == srcFormat)
+	{
+		memcpy(dest, src, PixelFormat{destFormat}.pixelBytes(pixels));
+		return true;
+	}
+	if(isRGBA8888Variant(destFormat))
+	{
+		if(srcFormat == PIXEL_RGB565)
+		{
+			rgb565ToRGBA8888((uint32*)dest, (const uint16*)src, pixels, destFormat == PIXEL_BGRA8888);
+			return true;
+		}
+		else if(isRGBA8888Variant(srcFormat))
+		{
+			swapRB((uint32*)dest, (const uint32*)src, pixels);
+			return true;
+		}
+	}
+	else if(destFormat == PIXEL_RGB565 && isRGBA8888Variant(srcFormat))
+	{
+		rgba8888ToRGB565((uint16*)dest, (const uint32*)src, pixels, srcFormat == PIXEL_BGRA8888);
+		return true;
+	}
+	logErr("conversion from %s to %s not supported",
+		PixelFormat{srcFormat}.name(), PixelFormat{destFormat}.name());
+	return false;
+}
+
+}
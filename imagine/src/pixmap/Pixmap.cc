@@ -15,6 +15,7 @@
 
 #define LOGTAG "Pixmap"
 #include <imagine/pixmap/Pixmap.hh>
+#include <imagine/pixmap/PixelConvert.hh>
 #include <imagine/logger/logger.h>
 #include <imagine/util/utility.h>
 #include <imagine/util/algorithm.h>
@@ -30,7 +31,11 @@ char *Pixmap::pixel(IG::WP pos) const
 
 void Pixmap::write(const IG::Pixmap &pixmap)
 {
-	assumeExpr(format() == pixmap.format());
+	if(format() != pixmap.format())
+	{
+		writeConverted(pixmap);
+		return;
+	}
 	if(w() == pixmap.w() && !isPadded() && !pixmap.isPadded())
 	{
 		// whole block
@@ -57,6 +62,76 @@ void Pixmap::write(const IG::Pixmap &pixmap, IG::WP destPos)
 	subPixmap(destPos, size() - destPos).write(pixmap);
 }
 
+template <class FUNC>
+static void forEachLine(const Pixmap &dest, const Pixmap &src, FUNC func)
+{
+	auto destData = dest.pixel({});
+	auto srcData = src.pixel({});
+	if(dest.w() == src.w() && !dest.isPadded() && !src.isPadded())
+	{
+		func(destData, srcData, src.w() * src.h());
+	}
+	else
+	{
+		iterateTimes(src.h(), i)
+		{
+			func(destData, srcData, src.w());
+			srcData += src.pitchBytes();
+			destData += dest.pitchBytes();
+		}
+	}
+}
+
+template <class T>
+static void writePalettedPixmap(const Pixmap &dest, const Pixmap &src, const T *palette)
+{
+	IG_PROFILE_SCOPE("Pixmap::writePaletted");
+	assumeExpr(dest.format().bytesPerPixel() == sizeof(T));
+	switch(src.format().bytesPerPixel())
+	{
+		bcase 1:
+			forEachLine(dest, src,
+				[palette](char *dest, const char *src, uint pixels)
+				{
+					paletteLookup((T*)dest, (const uint8*)src, palette, pixels);
+				});
+		bcase 2:
+			forEachLine(dest, src,
+				[palette](char *dest, const char *src, uint pixels)
+				{
+					paletteLookup((T*)dest, (const uint16*)src, palette, pixels);
+				});
+		bdefault:
+			logErr("can't use %s as palette indices", src.format().name());
+	}
+}
+
+void Pixmap::writePaletted(const IG::Pixmap &pixmap, const uint16 *palette)
+{
+	writePalettedPixmap(*this, pixmap, palette);
+}
+
+void Pixmap::writePaletted(const IG::Pixmap &pixmap, const uint32 *palette)
+{
+	writePalettedPixmap(*this, pixmap, palette);
+}
+
+bool Pixmap::writeConverted(const IG::Pixmap &pixmap)
+{
+	IG_PROFILE_SCOPE("Pixmap::writeConverted");
+	if(!canConvertPixels(format(), pixmap.format()))
+	{
+		logErr("can't convert %s to %s", pixmap.format().name(), format().name());
+		return false;
+	}
+	forEachLine(*this, pixmap,
+		[this, &pixmap](char *dest, const char *src, uint pixels)
+		{
+			convertPixels(format(), dest, pixmap.format(), src, pixels);
+		});
+	return true;
+}
+
 Pixmap Pixmap::subPixmap(IG::WP pos, IG::WP size) const
 {
 	//logDMsg("sub-pixmap with pos:%dx%d size:%dx%d", pos.x, pos.y, size.x, size.y);
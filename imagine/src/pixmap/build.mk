@@ -1,6 +1,7 @@
 ifndef inc_pixmap
 inc_pixmap := 1
 
-SRC += pixmap/Pixmap.cc
+SRC += pixmap/Pixmap.cc \
+pixmap/PixelConvert.cc
 
 endif
@@ -0,0 +1,258 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Profiler"
+#include <imagine/time/Profiler.hh>
+#include <imagine/time/Time.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/utility.h>
+#include <imagine/util/string.h>
+#include <imagine/util/ScopeGuard.hh>
+#include <array>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+
+namespace IG
+{
+
+namespace Profiler
+{
+
+struct Event
+{
+	const char *name;
+	uint64_t startNSecs;
+	uint64_t endNSecs;
+};
+
+struct ThreadBuffer
+{
+	std::array<Event, eventsPerThread> event{};
+	// total events written, the ring index is this modulo eventsPerThread
+	std::atomic<uint64_t> writeCount{};
+	std::array<char, 32> name{};
+	uint tid = 0;
+	// cleared when the owning thread exits so a new thread can reuse it
+	std::atomic_bool inUse{};
+};
+
+// releases the calling thread's buffer at thread exit, buffers are never
+// freed so writeChromeTrace() can read them without locking
+struct ThreadBufferOwner
+{
+	ThreadBuffer *buff{};
+
+	~ThreadBufferOwner()
+	{
+		if(buff)
+			buff->inUse.store(false, std::memory_order_release);
+	}
+};
+
+static std::array<std::atomic<ThreadBuffer*>, maxThreads> threadBuffer{};
+static std::atomic_uint threadBuffers{};
+static thread_local ThreadBuffer *currThreadBuffer{};
+static thread_local bool currThreadHasNoBuffer{};
+static thread_local ThreadBufferOwner currThreadBufferOwner{};
+
+static ThreadBuffer *reuseThreadBuffer()
+{
+	uint buffers = std::min(threadBuffers.load(std::memory_order_relaxed), maxThreads);
+	for(uint i = 0; i < buffers; i++)
+	{
+		auto buff = threadBuffer[i].load(std::memory_order_acquire);
+		bool inUse = false;
+		if(buff && buff->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+		{
+			// keeps the events of the exited thread, later ones are shown under the new name
+			string_printf(buff->name, "Thread %u", buff->tid);
+			return buff;
+		}
+	}
+	return nullptr;
+}
+// only accessed from the thread calling markFrame()
+static std::array<uint64_t, maxFrames> frameNSecs{};
+static uint frames = 0;
+static uint64_t lastFrameNSecs = 0;
+
+static ThreadBuffer *threadBufferForCurrentThread()
+{
+	if(likely(currThreadBuffer))
+		return currThreadBuffer;
+	if(currThreadHasNoBuffer)
+		return nullptr;
+	auto buff = reuseThreadBuffer();
+	if(!buff)
+	{
+		auto idx = threadBuffers.fetch_add(1, std::memory_order_relaxed);
+		if(idx >= maxThreads)
+		{
+			logWarn("too many threads, not recording events from this one");
+			currThreadHasNoBuffer = true;
+			return nullptr;
+		}
+		buff = new ThreadBuffer;
+		buff->tid = idx + 1;
+		buff->inUse.store(true, std::memory_order_relaxed);
+		string_printf(buff->name, "Thread %u", buff->tid);
+		threadBuffer[idx].store(buff, std::memory_order_release);
+	}
+	currThreadBufferOwner.buff = buff;
+	currThreadBuffer = buff;
+	return buff;
+}
+
+uint64_t nowNSecs()
+{
+	return IG::Time::now().nSecs();
+}
+
+void addEvent(const char *name, uint64_t startNSecs, uint64_t endNSecs)
+{
+	auto buff = threadBufferForCurrentThread();
+	if(unlikely(!buff))
+		return;
+	auto count = buff->writeCount.load(std::memory_order_relaxed);
+	buff->event[count % eventsPerThread] = {name, startNSecs, endNSecs};
+	buff->writeCount.store(count + 1, std::memory_order_release);
+}
+
+void setThreadName(const char *name)
+{
+	auto buff = threadBufferForCurrentThread();
+	if(!buff)
+		return;
+	string_copy(buff->name, name);
+}
+
+void markFrame()
+{
+	auto now = nowNSecs();
+	if(lastFrameNSecs)
+	{
+		addEvent("Frame", lastFrameNSecs, now);
+		frameNSecs[frames % maxFrames] = now - lastFrameNSecs;
+		frames++;
+	}
+	lastFrameNSecs = now;
+}
+
+uint recentFrameTimes(uint64_t *nSecs, uint max)
+{
+	uint count = std::min({frames, max, maxFrames});
+	for(uint i = 0; i < count; i++)
+	{
+		nSecs[i] = frameNSecs[(frames - count + i) % maxFrames];
+	}
+	return count;
+}
+
+static std::vector<Event> copyEvents(const ThreadBuffer &buff)
+{
+	auto count = buff.writeCount.load(std::memory_order_acquire);
+	auto first = count > eventsPerThread ? count - eventsPerThread : 0;
+	std::vector<Event> events{};
+	events.reserve(count - first);
+	for(auto i = first; i < count; i++)
+	{
+		events.push_back(buff.event[i % eventsPerThread]);
+	}
+	// drop anything the writing thread may have overwritten during the copy
+	auto newCount = buff.writeCount.load(std::memory_order_acquire);
+	if(newCount - first > eventsPerThread)
+	{
+		auto overwritten = std::min<uint64_t>(newCount - first - eventsPerThread, events.size());
+		events.erase(events.begin(), events.begin() + overwritten);
+	}
+	return events;
+}
+
+static void writeJSONString(FILE *file, const char *str)
+{
+	fputc('"', file);
+	for(; *str; str++)
+	{
+		auto c = (unsigned char)*str;
+		if(c == '"' || c == '\\')
+			fprintf(file, "\\%c", c);
+		else if(c < 0x20)
+			fprintf(file, "\\u%04x", c);
+		else
+			fputc(c, file);
+	}
+	fputc('"', file);
+}
+
+bool writeChromeTrace(const char *path)
+{
+	auto file = fopen(path, "wb");
+	if(!file)
+	{
+		logErr("error opening %s", path);
+		return false;
+	}
+	auto closeFile = IG::scopeGuard([&](){ fclose(file); });
+	uint buffers = std::min(threadBuffers.load(std::memory_order_relaxed), maxThreads);
+	std::array<std::vector<Event>, maxThreads> threadEvents{};
+	uint64_t baseNSecs = UINT64_MAX;
+	for(uint i = 0; i < buffers; i++)
+	{
+		auto buff = threadBuffer[i].load(std::memory_order_acquire);
+		if(!buff)
+			continue;
+		threadEvents[i] = copyEvents(*buff);
+		for(auto &e : threadEvents[i])
+		{
+			baseNSecs = std::min(baseNSecs, e.startNSecs);
+		}
+	}
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", file);
+	bool firstEvent = true;
+	uint eventCount = 0;
+	for(uint i = 0; i < buffers; i++)
+	{
+		auto buff = threadBuffer[i].load(std::memory_order_acquire);
+		if(!buff)
+			continue;
+		fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+			firstEvent ? "" : ",", buff->tid);
+		writeJSONString(file, buff->name.data());
+		fputs("}}", file);
+		firstEvent = false;
+		for(auto &e : threadEvents[i])
+		{
+			fputs(",\n{\"name\":", file);
+			writeJSONString(file, e.name);
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+				buff->tid, (e.startNSecs - baseNSecs) / 1000., (e.endNSecs - e.startNSecs) / 1000.);
+		}
+		eventCount += threadEvents[i].size();
+	}
+	fputs("\n]}\n", file);
+	if(ferror(file))
+	{
+		logErr("error writing %s", path);
+		return false;
+	}
+	logMsg("wrote %u events from %u threads to %s", eventCount, buffers, path);
+	return true;
+}
+
+}
+
+}
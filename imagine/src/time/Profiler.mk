@@ -0,0 +1,8 @@
+ifndef inc_time_profiler
+inc_time_profiler := 1
+
+configDefs += CONFIG_PROFILER
+
+SRC += time/Profiler.cc
+
+endif
@@ -0,0 +1,310 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "Resampler"
+#include <imagine/util/audio/PolyphaseResampler.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/algorithm.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#if defined __x86_64__ || defined __i386__
+#define CONFIG_RESAMPLER_X86
+#include <immintrin.h>
+#endif
+#if defined __ARM_NEON || defined __ARM_NEON__
+#define CONFIG_RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Audio
+{
+
+// Kaiser window beta, ~70dB stop-band attenuation
+static constexpr double kaiserBeta = 7.;
+// fraction of the output Nyquist frequency to pass
+static constexpr double cutoffScale = 0.91;
+
+static double besselI0(double x)
+{
+	double sum = 1., term = 1., halfX = x / 2.;
+	for(uint k = 1; k < 64; k++)
+	{
+		term *= (halfX / k) * (halfX / k);
+		sum += term;
+		if(term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+[[maybe_unused]] static void dotProductScalar(const int16 *in, const int16 *coeff0, const int16 *coeff1, uint taps, int32 &sum0, int32 &sum1)
+{
+	int32 s0 = 0, s1 = 0;
+	for(uint i = 0; i < taps; i++)
+	{
+		s0 += in[i] * coeff0[i];
+		s1 += in[i] * coeff1[i];
+	}
+	sum0 = s0;
+	sum1 = s1;
+}
+
+#ifdef CONFIG_RESAMPLER_X86
+
+static bool hasAVX2()
+{
+	static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+	return hasAVX2;
+}
+
+[[gnu::target("avx2")]]
+static void dotProductAVX2(const int16 *in, const int16 *coeff0, const int16 *coeff1, uint taps, int32 &sum0, int32 &sum1)
+{
+	auto s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+	for(uint i = 0; i < taps; i += 16)
+	{
+		auto x = _mm256_loadu_si256((const __m256i*)(in + i));
+		s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(x, _mm256_loadu_si256((const __m256i*)(coeff0 + i))));
+		s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(x, _mm256_loadu_si256((const __m256i*)(coeff1 + i))));
+	}
+	// reduce both sums together, ending with sum0 in lane 0 & sum1 in lane 1
+	auto s = _mm256_hadd_epi32(s0, s1);
+	auto s128 = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+	s128 = _mm_hadd_epi32(s128, s128);
+	sum0 = _mm_cvtsi128_si32(s128);
+	sum1 = _mm_cvtsi128_si32(_mm_srli_si128(s128, 4));
+}
+
+#endif
+
+#ifdef __SSE2__
+
+static int32 horizontalSumSSE2(__m128i s)
+{
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+	s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(s);
+}
+
+static void dotProductSSE2(const int16 *in, const int16 *coeff0, const int16 *coeff1, uint taps, int32 &sum0, int32 &sum1)
+{
+	auto s0 = _mm_setzero_si128(), s1 = _mm_setzero_si128();
+	for(uint i = 0; i < taps; i += 8)
+	{
+		auto x = _mm_loadu_si128((const __m128i*)(in + i));
+		s0 = _mm_add_epi32(s0, _mm_madd_epi16(x, _mm_loadu_si128((const __m128i*)(coeff0 + i))));
+		s1 = _mm_add_epi32(s1, _mm_madd_epi16(x, _mm_loadu_si128((const __m128i*)(coeff1 + i))));
+	}
+	sum0 = horizontalSumSSE2(s0);
+	sum1 = horizontalSumSSE2(s1);
+}
+
+#endif
+
+#ifdef CONFIG_RESAMPLER_NEON
+
+static int32 horizontalSumNEON(int32x4_t s)
+{
+	#ifdef __aarch64__
+	return vaddvq_s32(s);
+	#else
+	auto s2 = vadd_s32(vget_low_s32(s), vget_high_s32(s));
+	return vget_lane_s32(vpadd_s32(s2, s2), 0);
+	#endif
+}
+
+static void dotProductNEON(const int16 *in, const int16 *coeff0, const int16 *coeff1, uint taps, int32 &sum0, int32 &sum1)
+{
+	auto s0 = vdupq_n_s32(0), s1 = vdupq_n_s32(0);
+	for(uint i = 0; i < taps; i += 8)
+	{
+		auto x = vld1q_s16(in + i);
+		auto c0 = vld1q_s16(coeff0 + i);
+		auto c1 = vld1q_s16(coeff1 + i);
+		s0 = vmlal_s16(s0, vget_low_s16(x), vget_low_s16(c0));
+		s0 = vmlal_s16(s0, vget_high_s16(x), vget_high_s16(c0));
+		s1 = vmlal_s16(s1, vget_low_s16(x), vget_low_s16(c1));
+		s1 = vmlal_s16(s1, vget_high_s16(x), vget_high_s16(c1));
+	}
+	sum0 = horizontalSumNEON(s0);
+	sum1 = horizontalSumNEON(s1);
+}
+
+#endif
+
+static PolyphaseResampler::DotProductFunc bestDotProduct()
+{
+	#if defined CONFIG_RESAMPLER_X86
+	if(hasAVX2())
+		return dotProductAVX2;
+	#endif
+	#if defined __SSE2__
+	return dotProductSSE2;
+	#elif defined CONFIG_RESAMPLER_NEON
+	return dotProductNEON;
+	#else
+	return dotProductScalar;
+	#endif
+}
+
+bool PolyphaseResampler::init(uint32 inRate, uint32 outRate, uint channels, uint taps, float gain)
+{
+	if(!inRate || !outRate || !channels || channels > maxChannels || !taps)
+	{
+		logErr("invalid parameters in:%u out:%u channels:%u taps:%u", inRate, outRate, channels, taps);
+		return false;
+	}
+	double downRatio = std::max((double)inRate / outRate, 1.);
+	taps_ = (uint)std::ceil(taps * downRatio / 16.) * 16;
+	this->channels = channels;
+	dotProduct = bestDotProduct();
+	// Build phases + 1 rows so interpolation from the last phase can read the
+	// next row, which is the first phase advanced by a whole input sample.
+	// Row p's coefficients are centered between taps/2 - 1 & taps/2.
+	coeff.resize((phases + 1) * taps_);
+	double cutoff = cutoffScale / downRatio;
+	double halfLen = taps_ / 2.;
+	double i0Beta = besselI0(kaiserBeta);
+	std::vector<double> rowVals(taps_);
+	for(uint p = 0; p <= phases; p++)
+	{
+		auto row = &coeff[p * taps_];
+		double sum = 0;
+		for(uint k = 0; k < taps_; k++)
+		{
+			double t = (double)k - (halfLen - 1.) - (double)p / phases;
+			double x = t / halfLen;
+			double window = std::abs(x) < 1. ? besselI0(kaiserBeta * std::sqrt(1. - x * x)) / i0Beta : 0.;
+			double sinc = t == 0. ? 1. : std::sin(M_PI * cutoff * t) / (M_PI * cutoff * t);
+			rowVals[k] = cutoff * sinc * window;
+			sum += rowVals[k];
+		}
+		// normalize each row for an exact DC gain, putting the rounding
+		// error in the largest coefficient
+		int32 intSum = 0;
+		uint maxIdx = 0;
+		for(uint k = 0; k < taps_; k++)
+		{
+			row[k] = std::lround(rowVals[k] / sum * gain * 32768.);
+			intSum += row[k];
+			if(std::abs(rowVals[k]) > std::abs(rowVals[maxIdx]))
+				maxIdx = k;
+		}
+		row[maxIdx] += std::lround(gain * 32768.) - intSum;
+	}
+	setRate(inRate, outRate);
+	reset();
+	logMsg("%u -> %uHz, %u channels, %u taps", inRate, outRate, channels, taps_);
+	return true;
+}
+
+void PolyphaseResampler::setRate(uint32 inRate, uint32 outRate)
+{
+	inRate_ = inRate;
+	outRate_ = outRate;
+	step = (((uint64_t)inRate << 32) + outRate / 2) / outRate;
+}
+
+void PolyphaseResampler::reset()
+{
+	pos = 0;
+	// pre-fill silence so the first output lines up with the first input frame
+	historyFrames = taps_ / 2 - 1;
+	iterateTimes(channels, ch)
+	{
+		auto &h = history[ch];
+		if(h.size() < historyFrames)
+			h.resize(historyFrames);
+		std::fill_n(h.begin(), historyFrames, 0);
+	}
+}
+
+void PolyphaseResampler::push(const int16 *in, size_t frames)
+{
+	iterateTimes(channels, ch)
+	{
+		auto &h = history[ch];
+		if(h.size() < historyFrames + frames)
+			h.resize(historyFrames + frames);
+		auto dest = &h[historyFrames];
+		auto src = in + ch;
+		for(size_t i = 0; i < frames; i++)
+		{
+			dest[i] = src[i * channels];
+		}
+	}
+	historyFrames += frames;
+}
+
+size_t PolyphaseResampler::framesAvailable() const
+{
+	if(historyFrames < taps_)
+		return 0;
+	uint64_t lastPos = (uint64_t)(historyFrames - taps_) << 32 | 0xFFFFFFFF;
+	if(pos > lastPos)
+		return 0;
+	return (lastPos - pos) / step + 1;
+}
+
+size_t PolyphaseResampler::pull(int16 *out, size_t frames)
+{
+	frames = std::min(frames, framesAvailable());
+	for(size_t i = 0; i < frames; i++)
+	{
+		size_t idx = pos >> 32;
+		uint32 frac = pos;
+		auto coeff0 = &coeff[(frac >> (32 - phaseBits)) * taps_];
+		auto coeff1 = coeff0 + taps_;
+		int32 phaseFrac = (frac >> (16 - phaseBits)) & 0xFFFF;
+		iterateTimes(channels, ch)
+		{
+			int32 sum0, sum1;
+			dotProduct(&history[ch][idx], coeff0, coeff1, taps_, sum0, sum1);
+			int64_t sum = sum0 + (((int64_t)sum1 - sum0) * phaseFrac >> 16);
+			out[i * channels + ch] = std::clamp<int64_t>((sum + 0x4000) >> 15, INT16_MIN, INT16_MAX);
+		}
+		pos += step;
+	}
+	compact();
+	return frames;
+}
+
+size_t PolyphaseResampler::resample(int16 *out, const int16 *in, size_t frames)
+{
+	push(in, frames);
+	return pull(out, maxOut(frames));
+}
+
+size_t PolyphaseResampler::maxOut(size_t inFrames) const
+{
+	return ((uint64_t)inFrames << 32) / step + 2;
+}
+
+void PolyphaseResampler::compact()
+{
+	size_t consumed = std::min((size_t)(pos >> 32), historyFrames);
+	if(!consumed)
+		return;
+	iterateTimes(channels, ch)
+	{
+		auto &h = history[ch];
+		std::memmove(h.data(), h.data() + consumed, (historyFrames - consumed) * sizeof(int16));
+	}
+	historyFrames -= consumed;
+	pos -= (uint64_t)consumed << 32;
+}
+
+}
@@ -0,0 +1,6 @@
+ifndef inc_util_audio_resampler
+inc_util_audio_resampler := 1
+
+SRC += util/audio/PolyphaseResampler.cc
+
+endif
@@ -0,0 +1,28 @@
+ifndef inc_main
+inc_main := 1
+
+include $(IMAGINE_PATH)/make/imagineAppBase.mk
+
+SRC += main/main.cc main/ringBufferBench.cc main/resamplerBench.cc
+
+# GBC.emu's resamplers, benchmarked as the emulator creates them
+gambatteCommonPath := $(IMAGINE_PATH)/../GBC.emu/src/common
+VPATH += $(gambatteCommonPath)
+CPPFLAGS += -I$(gambatteCommonPath)
+SRC += resample/src/resamplerinfo.cpp \
+resample/src/makesinckernel.cpp \
+resample/src/chainresampler.cpp \
+resample/src/u48div.cpp \
+resample/src/i0.cpp \
+resample/src/kaiser50sinc.cpp \
+resample/src/kaiser70sinc.cpp
+
+include $(IMAGINE_PATH)/make/package/imagine.mk
+
+ifndef target
+target := microbench
+endif
+
+include $(IMAGINE_PATH)/make/imagineAppTarget.mk
+
+endif
@@ -0,0 +1,29 @@
+#pragma once
+
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#include <imagine/time/Time.hh>
+
+// Each bench prints one JSON object per line to stdout & returns false
+// if any of its results don't match the reference implementation
+
+bool runRingBufferBench();
+bool runResamplerBench();
+
+inline double bytesPerSecToGB(uint64_t bytes, IG::Time time)
+{
+	return bytes / (time.nSecs() / 1e9) / 1e9;
+}
@@ -0,0 +1,90 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "main"
+#include <imagine/base/Base.hh>
+#include <imagine/logger/logger.h>
+#include <imagine/util/string.h>
+#include <cstdio>
+#include "benches.hh"
+
+// Runs microbenchmarks without a window, invoked as: microbench [bench name ...]
+// With no names all benches run, exits with 1 if any results are wrong
+
+struct Bench
+{
+	const char *name;
+	bool (*run)();
+};
+
+static constexpr Bench bench[]
+{
+	{"ringbuffer", runRingBufferBench},
+	{"resampler", runResamplerBench},
+};
+
+static bool isBenchName(const char *name)
+{
+	for(auto &b : bench)
+	{
+		if(string_equal(name, b.name))
+			return true;
+	}
+	return false;
+}
+
+namespace Base
+{
+
+bool onHeadlessInit(int argc, char** argv, int &exitCode)
+{
+	for(int i = 1; i < argc; i++)
+	{
+		if(!isBenchName(argv[i]))
+		{
+			fprintf(stderr, "usage: %s [bench name ...], unknown bench: %s\n", argv[0], argv[i]);
+			exitCode = 1;
+			return true;
+		}
+	}
+	bool passed = true;
+	for(auto &b : bench)
+	{
+		bool selected = argc < 2;
+		for(int i = 1; i < argc; i++)
+		{
+			if(string_equal(argv[i], b.name))
+				selected = true;
+		}
+		if(!selected)
+			continue;
+		logMsg("running %s", b.name);
+		if(!b.run())
+		{
+			fprintf(stderr, "%s: results don't match reference\n", b.name);
+			passed = false;
+		}
+	}
+	exitCode = passed ? 0 : 1;
+	return true;
+}
+
+void onInit(int argc, char** argv)
+{
+	// only reached on platforms without headless support
+	Base::exitWithErrorMessagePrintf(1, "benchmarks need a headless-capable platform");
+}
+
+}
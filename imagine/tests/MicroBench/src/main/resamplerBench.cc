@@ -0,0 +1,153 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "ResamplerBench"
+#include <imagine/logger/logger.h>
+#include <imagine/util/audio/PolyphaseResampler.hh>
+#include <resample/resampler.h>
+#include <resample/resamplerinfo.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include "benches.hh"
+
+// Compares the CPU cost per second of output audio of GBC.emu's resamplers,
+// created through gambatte's ResamplerInfo list from the Game Boy's sample
+// rate like the emulator does, & of Audio::PolyphaseResampler alone at the
+// rate GBC.emu's polyphase FIR stage runs after its CIC decimator. Also checks
+// the output quality of each along with the streaming & one-call APIs agreeing
+
+static constexpr uint32 gbInRate = 2097152, inRate = 233017, outRate = 48000;
+static constexpr unsigned seconds = 10;
+static constexpr unsigned chunkFrames = 4096;
+// one emulated frame of samples, as GBC.emu passes to Resampler::resample()
+static constexpr unsigned gbChunkFrames = 35112;
+static constexpr double toneAmp = 16000;
+// enough to catch broken filters or SIMD paths, the expected SNR is ~53dB
+// for the rectangular windowed sinc & 65-90dB for the others
+static constexpr double minSNR = 45;
+
+static std::vector<int16> makeTone(uint32 rate, double freq)
+{
+	std::vector<int16> tone((size_t)rate * seconds * 2);
+	for(size_t i = 0; i < tone.size() / 2; i++)
+	{
+		int16 v = std::lround(toneAmp * std::sin(2. * M_PI * freq * i / rate));
+		tone[i * 2] = v;
+		tone[i * 2 + 1] = v;
+	}
+	return tone;
+}
+
+// SNR in dB of the left channel against a least squares fit of the tone,
+// skipping the filter's start up
+static double toneSNR(const int16 *out, size_t frames, double freq, double rate)
+{
+	const size_t skip = outRate / 10;
+	double sinDot = 0, cosDot = 0, sinSq = 0, cosSq = 0;
+	for(size_t i = skip; i < frames; i++)
+	{
+		double s = std::sin(2. * M_PI * freq * i / rate), c = std::cos(2. * M_PI * freq * i / rate);
+		sinDot += out[i * 2] * s;
+		cosDot += out[i * 2] * c;
+		sinSq += s * s;
+		cosSq += c * c;
+	}
+	double a = sinDot / sinSq, b = cosDot / cosSq;
+	double signal = 0, noise = 0;
+	for(size_t i = skip; i < frames; i++)
+	{
+		double fit = a * std::sin(2. * M_PI * freq * i / rate) + b * std::cos(2. * M_PI * freq * i / rate);
+		signal += fit * fit;
+		noise += (out[i * 2] - fit) * (out[i * 2] - fit);
+	}
+	return 10. * std::log10(signal / std::max(noise, 1.));
+}
+
+static bool printResult(const char *impl, uint32 inRate, IG::Time time, const std::vector<int16> &out,
+	size_t frames, double rate)
+{
+	static constexpr double freq = 1000;
+	auto snr = toneSNR(out.data(), frames, freq, rate);
+	bool passed = snr >= minSNR;
+	printf("{\"bench\":\"resampler\",\"impl\":\"%s\",\"inRate\":%u,\"outRate\":%u,"
+		"\"msPerSec\":%.3f,\"snrDB\":%.1f,\"passed\":%s}\n",
+		impl, inRate, outRate, time.nSecs() / 1e6 / ((double)frames / outRate), snr,
+		passed ? "true" : "false");
+	return passed;
+}
+
+static bool runGambatteResampler(const ResamplerInfo &info, const std::vector<int16> &in)
+{
+	std::unique_ptr<Resampler> resampler{info.create(gbInRate, outRate, gbChunkFrames)};
+	unsigned long mul, div;
+	resampler->exactRatio(mul, div);
+	std::vector<int16> out(resampler->maxOut(gbChunkFrames) * (in.size() / 2 / gbChunkFrames + 1) * 2);
+	size_t outFrames = 0;
+	auto startTime = IG::Time::now();
+	for(size_t frame = 0; frame + gbChunkFrames <= in.size() / 2; frame += gbChunkFrames)
+	{
+		outFrames += resampler->resample(&out[outFrames * 2], &in[frame * 2], gbChunkFrames);
+	}
+	return printResult(info.desc, gbInRate, IG::Time::now() - startTime, out, outFrames,
+		(double)gbInRate * mul / div);
+}
+
+static bool runPolyphaseResampler(const std::vector<int16> &in)
+{
+	Audio::PolyphaseResampler resampler{};
+	if(!resampler.init(inRate, outRate, 2))
+	{
+		logErr("error initializing resampler");
+		return false;
+	}
+	std::vector<int16> out(resampler.maxOut(in.size() / 2) * 2);
+	size_t outFrames = 0;
+	auto startTime = IG::Time::now();
+	for(size_t frame = 0; frame + chunkFrames <= in.size() / 2; frame += chunkFrames)
+	{
+		outFrames += resampler.resample(&out[outFrames * 2], &in[frame * 2], chunkFrames);
+	}
+	bool passed = printResult("polyphaseResampler", inRate, IG::Time::now() - startTime, out, outFrames, outRate);
+	// streaming in uneven pieces must produce the same samples
+	resampler.reset();
+	std::vector<int16> streamOut(out.size());
+	size_t streamFrames = 0, inPos = 0;
+	for(size_t i = 0; inPos + chunkFrames <= in.size() / 2 && streamFrames < outFrames; i++)
+	{
+		resampler.push(&in[inPos * 2], chunkFrames);
+		inPos += chunkFrames;
+		auto pullFrames = std::min(1 + (i * 997) % std::max(resampler.framesAvailable(), (size_t)1), outFrames - streamFrames);
+		streamFrames += resampler.pull(&streamOut[streamFrames * 2], pullFrames);
+	}
+	streamFrames += resampler.pull(&streamOut[streamFrames * 2], std::min(resampler.framesAvailable(), outFrames - streamFrames));
+	bool streamMatches = streamFrames == outFrames && std::equal(out.begin(), out.begin() + outFrames * 2, streamOut.begin());
+	printf("{\"bench\":\"resampler\",\"impl\":\"polyphaseResampler\",\"check\":\"streaming\",\"passed\":%s}\n",
+		streamMatches ? "true" : "false");
+	return passed && streamMatches;
+}
+
+bool runResamplerBench()
+{
+	bool passed = runPolyphaseResampler(makeTone(inRate, 1000));
+	auto gbIn = makeTone(gbInRate, 1000);
+	for(size_t i = 0; i < ResamplerInfo::num(); i++)
+	{
+		passed &= runGambatteResampler(ResamplerInfo::get(i), gbIn);
+	}
+	return passed;
+}
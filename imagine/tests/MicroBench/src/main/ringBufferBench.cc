@@ -0,0 +1,178 @@
+/*  This file is part of Imagine.
+
+	Imagine is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	Imagine is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with Imagine.  If not, see <http://www.gnu.org/licenses/> */
+
+#define LOGTAG "RingBufferBench"
+#include <imagine/logger/logger.h>
+#include <imagine/util/ringbuffer/RingBuffer.hh>
+#ifdef __linux__
+#include <imagine/util/ringbuffer/LinuxRingBuffer.hh>
+#endif
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include "benches.hh"
+
+// Compares the memcpy-based ring buffers against the previous
+// byte-at-a-time implementation with audio-sized transfers, after
+// checking each one passes data intact between two threads
+
+// previous ring buffer implementation, kept as the throughput baseline
+class LegacyRingBuffer
+{
+public:
+	~LegacyRingBuffer() { free(buff); }
+
+	bool init(unsigned size)
+	{
+		buff = (char*)malloc(size);
+		if(!buff)
+			return false;
+		buffSize = size;
+		start = end = buff;
+		return true;
+	}
+
+	unsigned write(const void *data, unsigned size)
+	{
+		size = std::min(size, buffSize - written);
+		auto writePos = end;
+		for(unsigned i = 0; i < size; i++)
+		{
+			*writePos = ((const char*)data)[i];
+			writePos = advanceAddr(writePos, 1);
+		}
+		end = writePos;
+		written += size;
+		return size;
+	}
+
+	unsigned read(void *data, unsigned size)
+	{
+		size = std::min(size, (unsigned)written);
+		auto readPos = start;
+		for(unsigned i = 0; i < size; i++)
+		{
+			((char*)data)[i] = *readPos;
+			readPos = advanceAddr(readPos, 1);
+		}
+		start = readPos;
+		written -= size;
+		return size;
+	}
+
+private:
+	char *buff{};
+	char *start{}, *end{};
+	std::atomic_uint written{};
+	unsigned buffSize = 0;
+
+	char *advanceAddr(char *ptr, unsigned size) const
+	{
+		ptr += size;
+		if(ptr >= buff + buffSize)
+			ptr -= buffSize;
+		return ptr;
+	}
+};
+
+static constexpr unsigned bytesPerFrame = 4; // stereo 16-bit audio
+// odd size so transfers wrap at different offsets
+static constexpr unsigned ringSize = 1600 * bytesPerFrame * 3 + 100;
+
+template <class RING>
+static bool threadedTransferIsIntact(RING &ring)
+{
+	static constexpr size_t totalBytes = 16 * 1024 * 1024;
+	std::thread producer
+	{
+		[&]()
+		{
+			std::vector<uint8_t> buff(6999);
+			size_t pos = 0;
+			while(pos < totalBytes)
+			{
+				auto size = std::min(1 + (pos * 7) % buff.size(), totalBytes - pos);
+				for(size_t i = 0; i < size; i++)
+					buff[i] = pos + i;
+				pos += ring.write(buff.data(), size);
+			}
+		}
+	};
+	std::vector<uint8_t> buff(4999);
+	size_t pos = 0;
+	bool intact = true;
+	while(pos < totalBytes)
+	{
+		auto size = ring.read(buff.data(), 1 + (pos * 13) % buff.size());
+		for(size_t i = 0; i < size; i++)
+		{
+			if(buff[i] != uint8_t(pos + i))
+				intact = false;
+		}
+		pos += size;
+	}
+	producer.join();
+	return intact;
+}
+
+template <class RING>
+static double transferGBPerSec(RING &ring, unsigned frames)
+{
+	static constexpr unsigned iterations = 20000;
+	std::vector<char> buff(frames * bytesPerFrame, 1);
+	uint64_t bytes = 0;
+	auto startTime = IG::Time::now();
+	for(unsigned i = 0; i < iterations; i++)
+	{
+		ring.write(buff.data(), buff.size());
+		bytes += ring.read(buff.data(), buff.size());
+	}
+	return bytesPerSecToGB(bytes, IG::Time::now() - startTime);
+}
+
+template <class RING>
+static bool runRing(const char *impl, bool checkThreaded)
+{
+	RING ring{};
+	if(!ring.init(ringSize))
+	{
+		logErr("error allocating %s ring buffer", impl);
+		return false;
+	}
+	bool intact = true;
+	if(checkThreaded)
+	{
+		intact = threadedTransferIsIntact(ring);
+		printf("{\"bench\":\"ringbuffer\",\"impl\":\"%s\",\"check\":\"threaded\",\"passed\":%s}\n",
+			impl, intact ? "true" : "false");
+	}
+	for(unsigned frames : {735, 1600})
+	{
+		printf("{\"bench\":\"ringbuffer\",\"impl\":\"%s\",\"bytes\":%u,\"gbPerSec\":%.3f}\n",
+			impl, frames * bytesPerFrame, transferGBPerSec(ring, frames));
+	}
+	return intact;
+}
+
+bool runRingBufferBench()
+{
+	bool passed = runRing<LegacyRingBuffer>("legacy", false);
+	passed &= runRing<RingBuffer<>>("heap", true);
+	#ifdef __linux__
+	passed &= runRing<LinuxRingBuffer<>>("mirrored", true);
+	#endif
+	return passed;
+}